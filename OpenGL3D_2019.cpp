@@ -5,15 +5,91 @@
 #include <iostream>
 #include "Src/GLFWEW.h"
 #include "Src/TitleScene.h"
+#include "Src/MainGameScene.h"
 #include "Src/SkeletalMesh.h"
+#include "Src/Residency.h"
+#include "Src/GLState.h"
+#include "Src/StreamingBuffer.h"
+#include "Src/Shader.h"
+#include "Src/Profiler.h"
+#include "Src/RenderStats.h"
+#include "Src/Particle.h"
 #include "Src/Audio/Audio.h"
 #include <Windows.h>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
 
 
-int main()
+int main(int argc, char* argv[])
 {
+	//コマンドライン引数を解析する
+	//  --record ファイル名: 毎フレームの経過時間とゲームパッドの状態を記録する
+	//  --replay ファイル名: 記録した経過時間と入力を再生する(最後まで再生したら終了)
+	//  --headless: ウィンドウを表示せず、描画を省略して更新だけを行う
+	//  --fixed-dt 秒数: 実際の時間の代わりに、毎フレームこの経過時間で更新する
+	//  --frames フレーム数: 指定したフレーム数を実行したら終了する
+	//  --scene title|main: 最初のシーン(省略時はヘッドレスならmain、それ以外はtitle)
+	//    タイトル画面はSTARTボタンを押すまで進まないので、ヘッドレスでは入力なしで
+	//    メインゲーム画面を更新できるようにmainから始める
+	//    通常の実行で記録した入力を再生する場合は、記録時と同じtitleを指定すること
+	const char* recordPath = nullptr;
+	const char* replayPath = nullptr;
+	bool headless = false;
+	double fixedDeltaTime = 0;
+	long long maxFrameCount = 0;
+	const char* firstScene = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--headless") == 0)
+		{
+			headless = true;
+		}
+		else if (i + 1 < argc)
+		{
+			if (std::strcmp(argv[i], "--record") == 0)
+			{
+				recordPath = argv[++i];
+			}
+			else if (std::strcmp(argv[i], "--replay") == 0)
+			{
+				replayPath = argv[++i];
+			}
+			else if (std::strcmp(argv[i], "--fixed-dt") == 0)
+			{
+				fixedDeltaTime = std::strtod(argv[++i], nullptr);
+			}
+			else if (std::strcmp(argv[i], "--frames") == 0)
+			{
+				maxFrameCount = std::strtoll(argv[++i], nullptr, 10);
+			}
+			else if (std::strcmp(argv[i], "--scene") == 0)
+			{
+				firstScene = argv[++i];
+			}
+		}
+	}
+
 	GLFWEW::Window& window = GLFWEW::Window::Instance();
-	window.Init(1280, 720, u8"アクションゲーム");
+	window.Init(1280, 720, u8"アクションゲーム", headless);
+	window.SetFixedDeltaTime(fixedDeltaTime);
+
+	//入力の記録・再生を設定する
+	//どちらの場合も、同じ動きになるように乱数の種を固定する
+	if (recordPath)
+	{
+		window.StartRecording(recordPath, std::mt19937::default_seed);
+	}
+	else if (replayPath)
+	{
+		window.StartReplay(replayPath);
+	}
+	if (window.IsInputLogActive())
+	{
+		ParticleSystem::SetRandomSeed(window.GetInputLogSeed());
+	}
 
 	//音声再生プログラムを初期化する
 	Audio::Engine& audioEngine = Audio::Engine::Instance();
@@ -26,44 +102,138 @@ int main()
 	Mesh::SkeletalAnimation::Initialize();
 
 	SceneStack& sceneStack = SceneStack::Instance();
-	sceneStack.Push(std::make_shared<TitleScene>());
+	if (firstScene ? std::strcmp(firstScene, "main") == 0 : headless)
+	{
+		sceneStack.Push(std::make_shared<MainGameScene>());
+	}
+	else
+	{
+		sceneStack.Push(std::make_shared<TitleScene>());
+	}
+
+	//ヘッドレスモードでは、フレームごとの処理時間をファイルに記録する
+	std::ofstream timingFile;
+	if (headless)
+	{
+		timingFile.open("HeadlessTiming.csv");
+		timingFile << "frame,deltaTime,frameTime(ms)\n";
+	}
+	long long frameCount = 0;
+	double totalFrameTime = 0;
+	double maxFrameTime = 0;
 
 	while (!window.ShouldClose())
 	{
 		//ESCキーが押されたら終了ウィンドウを表示
-		if (window.IsKeyPressed(GLFW_KEY_ESCAPE))
+		if (!headless && window.IsKeyPressed(GLFW_KEY_ESCAPE))
 		{
 			if (MessageBox(nullptr, "ゲームを終了しますか?", "終了", MB_OKCANCEL) == IDOK)
 			{
 				break;
 			}
 		}
+		const std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
 		const float deltaTime = window.DeltaTime();
 		window.UpdateTimer();
 
+		//処理時間の計測を開始する
+		Profiler::BeginFrame();
+
+		//毎フレーム書き換えるバッファの、今回使う区画が空くのを待つ
+		{
+			PROFILE_SCOPE("WaitStreamingBuffer");
+			StreamingBuffer::BeginFrame();
+		}
+
 		//スケルタルアニメーション用データの作成準備
 		Mesh::SkeletalAnimation::ResetUniformData();
 
-		sceneStack.Update(deltaTime);
+		{
+			PROFILE_SCOPE("SceneUpdate");
+			sceneStack.Update(deltaTime);
+		}
 
 		//スケルタルアニメーション用データをGPUメモリに転送
-		Mesh::SkeletalAnimation::UploadUniformData();
+		{
+			PROFILE_SCOPE("SkinningUpload");
+			Mesh::SkeletalAnimation::UploadUniformData();
+		}
 
 		//音声再生プログラムを更新する
 		audioEngine.Update();
 
-		//バックバッファを消去する
-		glClearColor(0.8f, 0.2f, 0.1f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		//ヘッドレスモードでは描画しない
+		if (!headless)
+		{
+			//バックバッファを消去する
+			glClearColor(0.8f, 0.2f, 0.1f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			//GLコンテキストのパラメータを設定
+			GLState::Enable(GL_CULL_FACE);
+			GLState::Enable(GL_DEPTH_TEST);
+
+			PROFILE_SCOPE("SceneRender");
+			sceneStack.Render();
+		}
+		{
+			PROFILE_SCOPE("SwapBuffers");
+			window.SwapBuffers();
+		}
 
-		//GLコンテキストのパラメータを設定
-		glEnable(GL_CULL_FACE);
-		glEnable(GL_DEPTH_TEST);
+		//メモリ予算を超えていたら、使われていないアセットを退避する
+		{
+			PROFILE_SCOPE("Residency");
+			Residency::Manager::Instance().Update();
+		}
 
-		sceneStack.Render();
-		window.SwapBuffers();
+		//状態設定の呼び出し回数と、描画命令の数を記録する
+		GLState::EndFrame();
+		RenderStats::EndFrame();
+
+		//このフレームで書き込んだ区画の描画完了を待てるようにする
+		StreamingBuffer::EndFrame();
+
+		//処理時間の計測を終了する
+		Profiler::EndFrame();
+
+		if (headless)
+		{
+			const double frameTime = std::chrono::duration<double, std::milli>(
+				std::chrono::steady_clock::now() - frameStart).count();
+			timingFile << frameCount << ',' << deltaTime << ',' << frameTime << '\n';
+			totalFrameTime += frameTime;
+			if (frameTime > maxFrameTime)
+			{
+				maxFrameTime = frameTime;
+			}
+		}
+		++frameCount;
+		if (maxFrameCount > 0 && frameCount >= maxFrameCount)
+		{
+			break;
+		}
+	}
+
+	//ヘッドレスモードでは、実行したフレーム数と処理時間の平均と最大を表示する
+	if (headless && frameCount > 0)
+	{
+		const double averageFrameTime = totalFrameTime / static_cast<double>(frameCount);
+		std::cout << "[情報]ヘッドレス: " << frameCount << "フレーム 平均" << averageFrameTime <<
+			"ms 最大" << maxFrameTime << "ms (" << 1000.0 / averageFrameTime << "fps)\n";
 	}
 
+	//最近のフレームの処理時間を書き出す(chrome://tracingで読み込む)
+	Profiler::ExportChromeTrace("Profile.json");
+
+	//最近のフレームの描画命令の数を書き出す
+	RenderStats::DumpCsv("RenderStats.csv");
+
+	//シェーダーの作成時間を表示する(キャッシュが効いているか確認するため)
+	const Shader::BuildStatistics& shaderStats = Shader::GetBuildStatistics();
+	std::cout << "[情報]シェーダー: " << shaderStats.programCount << "個作成(キャッシュ" <<
+		shaderStats.cacheHitCount << "個) " << shaderStats.seconds * 1000 << "ms\n";
+
 	//スケルタルアニメーションの利用を終了する
 	Mesh::SkeletalAnimation::Finalize();
 
@@ -0,0 +1,18 @@
+/**
+* @file Bloom.vert
+*/
+#version 430
+
+layout(location = 1) out vec2 outTexCoord;
+
+/**
+* ʑŜ𕢂Op``悷钸_VF[_[
+*
+* _f[^g킸A_ԍWvZ
+*/
+void main()
+{
+	vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	outTexCoord = uv;
+	gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+/**
+* @file BloomDownsample.frag
+*
+* BRIGHT_PASS`ƁAkʂ疾邢o
+*/
+#version 430
+
+layout(location = 1) in vec2 inTexCoord;
+
+out vec4 fragColor;
+
+uniform sampler2D texColor;
+
+/**
+* fAtB^̏kptOgVF[_[
+*
+* SƎ΂4̔eNZǂݍŕς
+* oCjAtB^Ŏ4eNẐŁA5̓ǂݍ݂16eNZڂ
+*/
+void main()
+{
+	vec2 halfPixel = 0.5 / vec2(textureSize(texColor, 0));
+	fragColor = texture(texColor, inTexCoord) * 4.0;
+	fragColor += texture(texColor, inTexCoord - halfPixel);
+	fragColor += texture(texColor, inTexCoord + halfPixel);
+	fragColor += texture(texColor, inTexCoord + vec2(halfPixel.x, -halfPixel.y));
+	fragColor += texture(texColor, inTexCoord - vec2(halfPixel.x, -halfPixel.y));
+	fragColor *= 1.0 / 8.0;
+
+#ifdef BRIGHT_PASS
+	float brightness = max(fragColor.r, max(fragColor.g, fragColor.b));
+	float contribution = max(brightness - 1.0, 0.0);
+	fragColor.rgb *= contribution / max(brightness, 0.000001);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+/**
+* @file BloomUpsample.frag
+*/
+#version 430
+
+layout(location = 1) in vec2 inTexCoord;
+
+out vec4 fragColor;
+
+uniform sampler2D texColor;
+
+/**
+* fAtB^̊gptOgVF[_[
+*
+* 8ӏAӂ̒_2{Ap1{̏d݂ŕς
+*/
+void main()
+{
+	vec2 halfPixel = 0.5 / vec2(textureSize(texColor, 0));
+	fragColor = texture(texColor, inTexCoord + vec2(-halfPixel.x * 2.0, 0.0));
+	fragColor += texture(texColor, inTexCoord + vec2(-halfPixel.x, halfPixel.y)) * 2.0;
+	fragColor += texture(texColor, inTexCoord + vec2(0.0, halfPixel.y * 2.0));
+	fragColor += texture(texColor, inTexCoord + vec2(halfPixel.x, halfPixel.y)) * 2.0;
+	fragColor += texture(texColor, inTexCoord + vec2(halfPixel.x * 2.0, 0.0));
+	fragColor += texture(texColor, inTexCoord + vec2(halfPixel.x, -halfPixel.y)) * 2.0;
+	fragColor += texture(texColor, inTexCoord + vec2(0.0, -halfPixel.y * 2.0));
+	fragColor += texture(texColor, inTexCoord + vec2(-halfPixel.x, -halfPixel.y)) * 2.0;
+	fragColor *= 1.0 / 12.0;
+}
\ No newline at end of file
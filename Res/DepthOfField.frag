@@ -1,5 +1,9 @@
 /**
 * @file DephOfField.frag
+*
+* k𑜓xŏꍇ́Aȉ̃}N`2̃pXŕ`悷
+* GATHER_PASS:   k`ɂڂF. aɂ̓r[Wn̐[xl
+* UPSAMPLE_PASS: ̉𑜓xŁA[xllďkʂg債Asg̍ƍ
 */
 #version 430
 
@@ -7,7 +11,7 @@ layout(location = 0) in vec2 inTexCoord;
 
 out vec4 fragColor;
 
-uniform sampler2D texColorArray[2];//0:J[ 1:[x
+uniform sampler2D texColorArray[3];//0:J[ 1:[x 2:k𑜓xłڂF(UPSAMPLE_PASŜ)
 
 /**
 * ʂ̏
@@ -29,6 +33,11 @@ uniform vec4 viewInfo;
 */
 uniform vec4 cameraInfo;
 
+/**
+* 摜̂Aۂɕ`悳Ă͈͂̑傫(I𑜓x̏k. 0`1)
+*/
+uniform vec2 sourceScale;
+
 
 //|A\fBXNTv̂߂̍WXg
 const int poissonSampleCount = 12;
@@ -56,6 +65,19 @@ float ToRealZ(float w)
 	return -2.0 * near * far / (far + near - n * (far - near));
 }
 
+/**
+* ʂ̃eNX`W摜̃eNX`Wɕϊ
+*
+* @param uv ʂ̃eNX`W(0`1)
+*
+* @return 摜̕`悳Ẵ͈͓eNX`W
+*/
+vec2 ToSourceUV(vec2 uv)
+{
+	vec2 halfTexel = 0.5 / vec2(textureSize(texColorArray[0], 0));
+	return clamp(uv * sourceScale, halfTexel, sourceScale - halfTexel);
+}
+
 /**
 * ~̔avZ
 *
@@ -76,19 +98,65 @@ vec2 CalcCoC(float objectDistance)
 	(objectDistance * (focalPlace - focalLength))) * mmTopixel * viewInfo.xy;
 }
 
+#ifndef UPSAMPLE_PASS
 /**
 * ʊEVF[_[
 */
 void main()
 {
-	float centerZ = ToRealZ(texture(texColorArray[1], inTexCoord).r);
+	vec2 centerUV = ToSourceUV(inTexCoord);
+	float centerZ = ToRealZ(texture(texColorArray[1], centerUV).r);
 	vec2 coc = CalcCoC(centerZ);
-	fragColor.rgb = texture(texColorArray[0], inTexCoord).rgb;
+	fragColor.rgb = texture(texColorArray[0], centerUV).rgb;
 	for(int i = 0; i < poissonSampleCount; i++)
 	{
-		vec2 uv = inTexCoord + coc * poissonDisk[i];
+		vec2 uv = ToSourceUV(inTexCoord + coc * poissonDisk[i]);
 		fragColor.rgb += texture(texColorArray[0], uv).rgb;
 	}
 	fragColor.rgb = fragColor.rgb / float(poissonSampleCount + 1);
+#ifdef GATHER_PASS
+	fragColor.a = centerZ;
+#else
+	fragColor.a = 1.0;
+#endif
+}
+#else
+/**
+* k𑜓xłڂ摜g升VF[_[
+*
+* 4eNZoCjȀd݂ōƂA[xl傫قȂeNZ̏d݂
+* ɂAÔ̂̕ڂ̂̕ɂɂݏoƂh
+*/
+void main()
+{
+	vec2 centerUV = ToSourceUV(inTexCoord);
+	float centerZ = ToRealZ(texture(texColorArray[1], centerUV).r);
+	vec3 sharpColor = texture(texColorArray[0], centerUV).rgb;
+
+	ivec2 lowSize = textureSize(texColorArray[2], 0);
+	vec2 pos = inTexCoord * vec2(lowSize) - 0.5;
+	vec2 base = floor(pos);
+	vec2 f = pos - base;
+	vec3 blurredColor = vec3(0);
+	float totalWeight = 0.0;
+	for (int i = 0; i < 4; ++i)
+	{
+		ivec2 offset = ivec2(i & 1, i >> 1);
+		ivec2 texel = clamp(ivec2(base) + offset, ivec2(0), lowSize - 1);
+		vec4 s = texelFetch(texColorArray[2], texel, 0);
+		vec2 bilinear = mix(1.0 - f, f, vec2(offset));
+		float depthDiff = abs(s.a - centerZ) / max(-centerZ, 0.001);
+		float weight = bilinear.x * bilinear.y / (0.01 + depthDiff);
+		blurredColor += s.rgb * weight;
+		totalWeight += weight;
+	}
+	blurredColor /= max(totalWeight, 0.000001);
+
+	//~keNZ菬́Ả𑜓x̐Fg
+	//̉摜sourceScale͈̔͂ɕ`悳Ă̂ŁA͈̔͂̕Ŕ߂
+	float scale = float(textureSize(texColorArray[0], 0).x) * sourceScale.x / float(lowSize.x);
+	float cocPixels = CalcCoC(centerZ).x / viewInfo.x;
+	fragColor.rgb = mix(sharpColor, blurredColor, smoothstep(0.5, scale, cocPixels));
 	fragColor.a = 1.0;
 }
+#endif
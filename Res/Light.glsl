@@ -0,0 +1,98 @@
+/**
+* @file Light.glsl
+*
+* Cg̃f[^ƁANX^|CgCgƃX|bgCg̖邳߂֐
+* StaticMesh.fragATerrain.fragAWater.frag#includeŎ荞
+* Cg̃f[^̕тLight.hLightUniformBlockLocalLightɍ킹邱
+*/
+struct AmbientLight
+{
+	vec4 color;
+};
+
+struct DirectionalLight
+{
+	vec4 color;
+	vec4 direction;
+};
+
+//|CgCgƃX|bgCgʂ̃f[^(|CgCgdirAndCutOff.w-2)
+struct LocalLight
+{
+	vec4 colorAndRange;
+	vec4 posAndInnerCutOff;
+	vec4 dirAndCutOff;
+};
+
+//NX^(𕪊)IԂ߂̃p[^
+struct ClusterInfo
+{
+	vec4 depthPlane;//[hWr[Ԃ̐[x߂镽
+	vec4 scale;//xy=ʍW^Cԍւ̌W, zw=log([x)XCXԍւ̌WƃoCAX
+	ivec4 count;//xyz=ẽNX^
+};
+
+layout(std140) uniform LightUniformBlock
+{
+	AmbientLight ambientLight;
+	DirectionalLight directionalLight;
+	ClusterInfo cluster;
+	ivec4 lightCount;//x=|CgCg̐, y=X|bgCg̐, z=v
+};
+
+layout(std430, binding=0) readonly buffer LocalLightBlock
+{
+	LocalLight localLights[];
+};
+
+layout(std430, binding=1) readonly buffer LightClusterBlock
+{
+	uvec2 lightClusters[];//x=lightIndices̊Jnʒu, y=Cg
+};
+
+layout(std430, binding=2) readonly buffer LightIndexBlock
+{
+	uint lightIndices[];
+};
+
+/**
+* sNZ܂܂NX^ɉe|CgCgƃX|bgCg̖邳v
+*
+* @param position sNZ̃[hW
+* @param normal   sNZ̖@(Kς)
+*
+* @return Cg̖邳̍v
+*/
+vec3 GetLocalLightColor(vec3 position, vec3 normal)
+{
+	if (lightCount.z <= 0)
+	{
+		return vec3(0);
+	}
+	float depth = dot(cluster.depthPlane.xyz, position) + cluster.depthPlane.w;
+	ivec3 c;
+	c.xy = ivec2(gl_FragCoord.xy * cluster.scale.xy);
+	c.z = int(log(max(depth, 0.0001)) * cluster.scale.z + cluster.scale.w);
+	c = clamp(c, ivec3(0), cluster.count.xyz - 1);
+	uvec2 range = lightClusters[(c.z * cluster.count.y + c.y) * cluster.count.x + c.x];
+
+	vec3 color = vec3(0);
+	for (uint i = 0; i < range.y; ++i)
+	{
+		LocalLight light = localLights[lightIndices[range.x + i]];
+		vec3 lightVector = light.posAndInnerCutOff.xyz - position;
+		float lengthSq = dot(lightVector, lightVector);
+		vec3 lightDir = lightVector * inversesqrt(max(lengthSq, 0.0001));
+		float cosTheta = clamp(dot(normal, lightDir), 0.0, 1.0);
+		float intensity = 1.0 / (1.0 + lengthSq);
+
+		//e͈͂̋E0ɂȂ悤Ɍ
+		float ratio = lengthSq / (light.colorAndRange.w * light.colorAndRange.w);
+		float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+
+		float spotCosTheta = dot(lightDir, -light.dirAndCutOff.xyz);
+		float cutOff = smoothstep(light.dirAndCutOff.w, light.posAndInnerCutOff.w, spotCosTheta);
+		color += light.colorAndRange.rgb * cosTheta * intensity * window * window * cutOff;
+	}
+	return color;
+}
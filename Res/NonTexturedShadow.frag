@@ -1,9 +0,0 @@
-/**
-* @file NonTextureShadow.frag
-*/
-#version 430
-
-void main()
-{
-	
-}
\ No newline at end of file
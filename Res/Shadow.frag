@@ -1,18 +0,0 @@
-/**
-* @file Shadow.frag
-*/
-#version 430
-
-layout(location = 1) in vec2 inTexCoord;
-
-uniform sampler2D texColor;
-
-void main()
-{
-	//sx0.5̃sNZ͔j(e𗎂ƂȂ)
-	float a = texture(texColor, inTexCoord).a;
-	if(a < 0.5)
-	{
-		discard;
-	}
-}
\ No newline at end of file
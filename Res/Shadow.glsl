@@ -0,0 +1,30 @@
+/**
+* @file Shadow.glsl
+*
+* JXP[hVhE}bve̔䗦擾֐
+* StaticMesh.fragTerrain.frag#includeŎ荞
+*/
+uniform sampler2DShadow texShadow;
+uniform mat4 matShadow[4];//[hWeJXP[h̉epeNX`W(0`1)ɕϊs
+
+/**
+* e̔䗦擾(JXP[hVhE}bv)
+*
+* epeNX`2x2ɕAJɋ߂ɃJXP[hł
+* W͈͂Ɏ܂ŏ̃JXP[hgAǂ̃JXP[hɂȂΉe͂Ȃ
+*/
+float GetShadow(vec3 position)
+{
+	const float margin = 0.001;//ׂ̋QƂȂ߂̗]
+	for (int i = 0; i < 4; ++i)
+	{
+		vec3 p = (matShadow[i] * vec4(position, 1.0)).xyz;
+		if (all(greaterThan(p, vec3(margin))) && all(lessThan(p, vec3(1.0 - margin))))
+		{
+			p.xy = (p.xy + vec2(i % 2, i / 2)) * 0.5;
+			p.z -= 0.0005;//[xoCAX
+			return texture(texShadow, p);
+		}
+	}
+	return 1.0;
+}
@@ -1,93 +1,64 @@
 /**
 * @file StaticMesh.frag
+*
+* ̃}N`Ƌ@\؂ւ(Shader::ProgramVariants#version̒ɑ})
+*   SHADOW_PASS      e̕`p. sx0.5̃sNZj邾
+*   NON_TEXTURED     SHADOW_PASSƓɒ`āAeNX`QƂȂ悤ɂ
+*   SKINNED          XP^bVp. _F|Asx0.1̃sNZj
 */
 #version 430
 layout(location=0) in vec4 inColor;
 layout(location=1) in vec2 inTexCoord;
+#ifndef SHADOW_PASS
 layout(location=2) in vec3 inNormal;
 layout(location=3) in vec3 inPosition;
-layout(location=4) in vec3 inShadowPosition;
 
 out vec4 fragColor;
+#endif
 
 uniform sampler2D texColor;
-uniform sampler2DShadow texShadow;
 
-
-struct AmbientLight
-{
-	vec4 color;
-};
-
-struct DirectionalLight
-{
-	vec4 color;
-	vec4 direction;
-};
-
-struct PointLight
-{
-	vec4 color;
-	vec4 position;
-};
-
-struct SpotLight
-{
-	vec4 color;
-	vec4 dirAndCutOff;
-	vec4 posAndInnerCutOff;
-};
-
-layout(std140) uniform LightUniformBlock
+#ifdef SHADOW_PASS
+void main()
 {
-	AmbientLight ambientLight;
-	DirectionalLight directionalLight;
-	PointLight pointLight[100];
-	SpotLight spotLight[100];
-};
-
-uniform int pointLightCount;//|CgCg̐
-uniform int pointLightIndex[8];
+#ifndef NON_TEXTURED
+	//sx0.5̃sNZ͔j(e𗎂ƂȂ)
+	float a = texture(texColor, inTexCoord).a;
+	if(a < 0.5)
+	{
+		discard;
+	}
+#endif
+}
+#else
+#include "Shadow.glsl"
 
-uniform int spotLightCount;//X|bgCg̐
-uniform int spotLightIndex[8];
+#include "Light.glsl"
 
 /**
 * XvCgptOgVF[_[
 */
 void main()
 {
+#ifdef SKINNED
+	fragColor = inColor * texture(texColor, inTexCoord);
+	if (fragColor.a < 0.1)
+	{
+		discard;
+	}
+#else
+	fragColor = texture(texColor, inTexCoord);
+#endif
+
 	//błЂƂ̕su
 	vec3 normal = normalize(inNormal);
 	vec3 lightColor = ambientLight.color.rgb;
 	float power = max(dot(normal, -directionalLight.direction.xyz),0.0);
-	lightColor += directionalLight.color.rgb * power;
-
-	for(int i = 0; i < pointLightCount; i++)
-	{
-		int id = pointLightIndex[i];
-		vec3 lightVector = pointLight[id].position.xyz - inPosition;
-		vec3 lightDir = normalize(lightVector);
-		float cosTheta = clamp(dot(normal, lightDir), 0.0, 1.0);
-		float intensity = 1.0 / (1.0 + dot(lightVector, lightVector));
-		float shadow = texture(texShadow, inShadowPosition);//e̔䗦擾
-		lightColor += pointLight[id].color.rgb * cosTheta * intensity * shadow;
-	}
-
-	for(int i = 0; i < spotLightCount; i++)
-	{
-		int id = spotLightIndex[i];
-		vec3 lightVector = spotLight[id].posAndInnerCutOff.xyz - inPosition;
-		vec3 lightDir = normalize(lightVector);
-		float cosTheta = clamp(dot(normal, lightDir), 0.0, 1.0);
-		float intensity = 1.0 / (1.0 + dot(lightVector, lightVector));
-		float spotCosTheta = dot(lightDir, -spotLight[id].dirAndCutOff.xyz);
-		float cutOff = smoothstep(spotLight[id].dirAndCutOff.w,
-		spotLight[id].posAndInnerCutOff.w, spotCosTheta);
-		float shadow = texture(texShadow, inShadowPosition);//e̔䗦擾
-		lightColor += spotLight[id].color.rgb * cosTheta * intensity * cutOff * shadow;
-	}
+	float shadow = GetShadow(inPosition);//e̔䗦擾
+	lightColor += directionalLight.color.rgb * power * shadow;
 
-	fragColor = texture(texColor,inTexCoord);
+	//|CgCgƃX|bgCg̓NX^̃CgꗗvZ
+	lightColor += GetLocalLightColor(inPosition, normal);
 	fragColor.rgb *= lightColor;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -1,33 +1,81 @@
 /**
 * @file StaticMesh.vert
+*
+* ̃}N`Ƌ@\؂ւ(Shader::ProgramVariants#version̒ɑ})
+*   INSTANCED   fsCX^Xf[^ǂݍ
+*   SKINNED     XP^Aj[V̎pf[^Œ_ό`
+*   SHADOW_PASS e̕`ɕKvȒlvZ
 */
 #version 430
 
 layout(location=0) in vec3 vPosition;
 layout(location=1) in vec2 vTexCoord;
 layout(location=2) in vec3 vNormal;
+#ifdef SKINNED
+layout(location=3) in vec4 vWeights;
+layout(location=4) in vec4 vJoints;
+#endif
+#ifdef INSTANCED
+//CX^Xf[^
+layout(location=8) in mat4 vMatModel;//fs(location=8`11g)
+#endif
 
 layout(location=0) out vec4 outColor;
 layout(location=1) out vec2 outTexCoord;
 layout(location=2) out vec3 outNormal;
 layout(location=3) out vec3 outPosition;
-layout(location=4) out vec3 outShadowPosition;
 
 uniform mat4 matMVP;
+
+#if defined(SKINNED)
+layout(std140) uniform MeshMatrixUniformData
+{
+	vec4 color;
+	mat3x4 matModel[8];//]uĊi[Ă
+	mat3x4 matBones[256];//]uĊi[Ă
+} vd;
+
+layout(std140) uniform MaterialUniformBlock
+{
+	vec4 materialColor;
+};
+#elif !defined(INSTANCED)
 uniform mat4 matModel;
-uniform mat4 matShadow;
+#endif
+
+// ʎqꂽ_W𕜌邽߂̃p[^
+uniform vec3 positionScale = vec3(1);
+uniform vec3 positionOffset = vec3(0);
 
 /**
 * bVp_VF[_[
 */
 void main()
 {
-	mat3 matNormal = transpose(inverse(mat3(matModel)));
+#if defined(SKINNED)
+	mat3x4 matSkinTmp =
+		vd.matBones[int(vJoints.x)] * vWeights.x +
+		vd.matBones[int(vJoints.y)] * vWeights.y +
+		vd.matBones[int(vJoints.z)] * vWeights.z +
+		vd.matBones[int(vJoints.w)] * vWeights.w;
+	mat4 matSkin = mat4(transpose(matSkinTmp));
+	matSkin[3][3] = dot(vWeights, vec4(1));//EFCgKĂȂꍇ̑΍([3][3]1.0ɂȂƂ͌Ȃ)
+	mat4 matM = mat4(transpose(vd.matModel[0])) * matSkin;
+	outColor = materialColor * vd.color;
+#elif defined(INSTANCED)
+	mat4 matM = vMatModel;
+#else
+	mat4 matM = matModel;
+#endif
+	vec3 position = vPosition * positionScale + positionOffset;
+	vec4 worldPosition = matM * vec4(position, 1.0);
 
 	outTexCoord = vTexCoord;
+	gl_Position = matMVP * worldPosition;
+
+#ifndef SHADOW_PASS
+	mat3 matNormal = transpose(inverse(mat3(matM)));
 	outNormal = normalize(matNormal * vNormal);
-	outPosition = vec3(matModel * vec4(vPosition, 1.0));
-	outShadowPosition = vPosition;
-	outShadowPosition.z -= 0.0005;//[xoCAX
-	gl_Position = matMVP * (matModel * vec4(vPosition, 1.0));
+	outPosition = vec3(worldPosition);
+#endif
 }
\ No newline at end of file
@@ -7,50 +7,15 @@ layout(location=1) in vec2 inTexCoord;
 layout(location=2) in vec3 inTBN[3];
 layout(location=5) in vec3 inRawPosition;
 layout(location=6) in vec3 inPosition;
-layout(location=7) in vec3 inShadowPosition;
 
 out vec4 fragColor;
 
 uniform sampler2D texColorArray[4];
 uniform sampler2D texNormalArray[3];
-uniform isamplerBuffer texPointLightIndex;//use texelFetch
-uniform isamplerBuffer texSpotLightIndex;//use texelFetch
-uniform sampler2DShadow texShadow;
 
-const ivec2 mapSize = ivec2(200, 200);
-
-struct AmbientLight
-{
-	vec4 color;
-};
-
-struct DirectionalLight
-{
-	vec4 color;
-	vec4 direction;
-};
-
-struct PointLight
-{
-	vec4 color;
-	vec4 position;
-};
-
-struct SpotLight
-{
-	vec4 color;
-	vec4 dirAndCutOff;
-	vec4 posAndInnerCutOff;
-};
-
-layout(std140) uniform LightUniformBlock
-{
-	AmbientLight ambientLight;
-	DirectionalLight directionalLight;
-	PointLight pointLight[100];
-	SpotLight spotLight[100];
-};
+#include "Shadow.glsl"
 
+#include "Light.glsl"
 
 /**
 * XvCgptOgVF[_[
@@ -75,40 +40,10 @@ void main()
 
 	vec3 lightColor = ambientLight.color.rgb;
 	float power = max(dot(normal, -directionalLight.direction.xyz),0.0);
-	int offset = int(inRawPosition.z) * mapSize.x + int(inRawPosition.x);
-	ivec4 pointLightIndex = texelFetch(texPointLightIndex, offset);
-	float shadow = texture(texShadow, inShadowPosition);//e̔䗦擾
+	float shadow = GetShadow(inPosition);//e̔䗦擾
 	lightColor += directionalLight.color.rgb * power * shadow;
-	
 
-	for(int i = 0; i < 4; i++)
-	{
-		int id = pointLightIndex[i];
-		if(id >= 0)
-		{
-			vec3 lightVector = pointLight[id].position.xyz - inPosition;
-		vec3 lightDir = normalize(lightVector);
-		float cosTheta = clamp(dot(normal, lightDir), 0.0, 1.0);
-		float intensity = 1.0 / (1.0 + dot(lightVector, lightVector));
-		lightColor += pointLight[id].color.rgb * cosTheta * intensity;
-		}
-		
-	}
-	ivec4 spotLightIndex = texelFetch(texSpotLightIndex, offset);
-	for(int i = 0; i < 4; i++)
-	{
-		int id = spotLightIndex[i];
-		if(id >= 0)
-		{
-			vec3 lightVector = spotLight[id].posAndInnerCutOff.xyz - inPosition;
-		vec3 lightDir = normalize(lightVector);
-		float cosTheta = clamp(dot(normal, lightDir), 0.0, 1.0);
-		float intensity = 1.0 / (1.0 + dot(lightVector, lightVector));
-		float spotCosTheta = dot(lightDir, -spotLight[id].dirAndCutOff.xyz);
-		float cutOff = smoothstep(spotLight[id].dirAndCutOff.w,
-		spotLight[id].posAndInnerCutOff.w, spotCosTheta);
-		lightColor += spotLight[id].color.rgb * cosTheta * intensity * cutOff;
-		}
-	}
+	//|CgCgƃX|bgCg̓NX^̃CgꗗvZ
+	lightColor += GetLocalLightColor(inPosition, normal);
 	fragColor.rgb *= lightColor;
 }
\ No newline at end of file
@@ -12,11 +12,9 @@ layout(location=1) out vec2 outTexCoord;
 layout(location=2) out vec3 outTBN[3];
 layout(location=5) out vec3 outRawPosition;
 layout(location=6) out vec3 outPosition;
-layout(location=7) out vec3 outShadowPosition;
 
 uniform mat4 matMVP;
 uniform mat4 matModel;
-uniform mat4 matShadow;
 
 /**
 * bVp_VF[_[
@@ -34,8 +32,6 @@ void main()
 	outTBN[1] = b;
 	outTBN[2] = n;
 	outPosition = vec3(matModel * vec4(vPosition, 1.0));
-	outShadowPosition = vPosition;
-	outShadowPosition.z -= 0.0005;//[xoCAX
 	outRawPosition = vPosition;
 	gl_Position = matMVP * (matModel * vec4(vPosition, 1.0));
 }
\ No newline at end of file
@@ -81,9 +81,9 @@ void Actor::UpdateDrawData(float deltaTime)
 /**
 * AN^[̕`
 *
-* @param drawType `悷f[^̎
+* @param queue `vǉ`L[
 */
-void Actor::Draw(Mesh::DrawType)
+void Actor::Draw(Mesh::RenderQueue&)
 {
 
 }
@@ -109,8 +109,10 @@ StaticMeshActor::StaticMeshActor(const Mesh::FilePtr& m, const std::string& name
 
 /**
 * `
+*
+* @param queue `vǉ`L[
 */
-void StaticMeshActor::Draw(Mesh::DrawType drawType)
+void StaticMeshActor::Draw(Mesh::RenderQueue& queue)
 {
 	if (mesh)
 	{
@@ -121,48 +123,17 @@ void StaticMeshActor::Draw(Mesh::DrawType drawType)
 		const glm::mat4 matS = glm::scale(glm::mat4(1), scale);
 		const glm::mat4 matModel = matT * matR_XZY * matS;
 
-		if (drawType == Mesh::DrawType::color && !mesh->materials.empty())
+		if (queue.GetDrawType() == Mesh::DrawType::color && !mesh->materials.empty())
 		{
-			const Shader::ProgramPtr p = mesh->materials[0].program;
-			if (p)
+			if (!mesh->meshes.empty())
 			{
-				p->Use();
-				p->SetPointLightIndex(pointLightCount, pointLightIndex);
-				p->SetSpotLightIndex(spotLightCount, spotLightIndex);
+				lod = Mesh::SelectLod(mesh->meshes[0], matModel, lod);
 			}
-			Mesh::Draw(mesh, matModel, drawType);
+			queue.Submit(mesh, matModel, lod);
 		}
 	}
 }
 
-/**
-	* AN^[ɉe|CgCg̃CfbNXݒ肷
-	*
-	* @param v |CgCg̃CfbNXz
-	*/
-void StaticMeshActor::SetPointLightList(const std::vector<int>& v)
-{
-	pointLightCount = v.size();
-	for (int i = 0; i < 8 && i < static_cast<int>(v.size()); i++)
-	{
-		pointLightIndex[i] = v[1];
-	}
-}
-
-/**
-* AN^[ɉeX|bgCg̃CfbNXݒ肷
-*
-* @param v X|bgCg̃CfbNXz
-*/
-void StaticMeshActor::SetSpotLightList(const std::vector<int>& v)
-{
-	spotLightCount = v.size();
-	for (int i = 0; i < 8 && i < static_cast<int>(v.size()); i++)
-	{
-		spotLightIndex[i] = v[i];
-	}
-}
-
 /**
 * i[\ȃAN^[mۂ
 *
@@ -280,15 +251,15 @@ void ActorList::UpdateDrawData(float deltaTime)
 /**
 * Actor`悷
 *
-* @param drawType `悷f[^̎
+* @param queue `vǉ`L[
 */
-void ActorList::Draw(Mesh::DrawType drawType)
+void ActorList::Draw(Mesh::RenderQueue& queue)
 {
 	for (const ActorPtr& e : actors)
 	{
 		if (e && e->health > 0)
 		{
-			e->Draw(drawType);
+			e->Draw(queue);
 		}
 	}
 }
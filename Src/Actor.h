@@ -5,6 +5,7 @@
 #define ACTOR_H_INCLUDED
 #include <GL/glew.h>
 #include "Mesh.h"
+#include "RenderQueue.h"
 #include "Collision.h"
 #include <vector>
 #include <memory>
@@ -25,7 +26,7 @@ public:
 
 	virtual void Update(float);
 	virtual void UpdateDrawData(float);
-	virtual void Draw(Mesh::DrawType drawType);
+	virtual void Draw(Mesh::RenderQueue& queue);
 	virtual void OnHit(const ActorPtr&, const glm::vec3&) {};
 
 public:
@@ -52,19 +53,13 @@ public:
 		const glm::vec3& scale = glm::vec3(1));
 	virtual ~StaticMeshActor() = default;
 
-	virtual void Draw(Mesh::DrawType drawType) override;
+	virtual void Draw(Mesh::RenderQueue& queue) override;
 
 	const Mesh::FilePtr& GetMesh() const { return mesh; }
-	void SetPointLightList(const std::vector<int>& v);
-	void SetSpotLightList(const std::vector<int>& v);
 
 private:
 	Mesh::FilePtr mesh;
-
-	int pointLightCount = 0;
-	int pointLightIndex[8] = {};
-	int spotLightCount = 0;
-	int spotLightIndex[8] = {};
+	int lod = 0;//`悷ڍדx(LOD)
 };
 using StaticMeshActorPtr = std::shared_ptr<StaticMeshActor>;
 
@@ -86,7 +81,7 @@ public:
 	bool Remove(const ActorPtr&);
 	void Update(float);
 	void UpdateDrawData(float);
-	void Draw(Mesh::DrawType drawType);
+	void Draw(Mesh::RenderQueue& queue);
 	bool Empty() const { return actors.empty(); }
 
 	//Ce[^[擾֐
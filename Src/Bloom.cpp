@@ -0,0 +1,126 @@
+/**
+* @file Bloom.cpp
+*/
+#include "Bloom.h"
+#include "GLState.h"
+#include "RenderStats.h"
+#include <algorithm>
+#include <iostream>
+
+/**
+* u[GtFNg
+*
+* @retval true  
+* @retval false s
+*/
+bool Bloom::Init()
+{
+	downsampleShaders = Shader::ProgramVariants::Create(
+		"Res/Bloom.vert", "Res/BloomDownsample.frag");
+	progBrightPass = downsampleShaders->Get({ { "BRIGHT_PASS", 1 } });
+	progDownsample = downsampleShaders->Get();
+	progUpsample = Shader::Program::Create("Res/Bloom.vert", "Res/BloomUpsample.frag");
+	if (progBrightPass->IsNull() || progDownsample->IsNull() || progUpsample->IsNull())
+	{
+		return false;
+	}
+	return vao.Create(0, 0);
+}
+
+/**
+* gpkiݒ肷
+*
+* @param count ki(1`maxLevelCount)
+*
+* iقǂڂ͈̔͂LA`񐔂(`񐔂͒i~2-1)
+*/
+void Bloom::SetLevelCount(int count)
+{
+	levelCount = std::max(1, std::min(count, maxLevelCount));
+}
+
+/**
+* u[GtFNg̕`pXt[Otɒǉ
+*
+* @param graph  ǉ̃t[Ot
+* @param source 摜̕`
+*
+* @return ڂ邢i[A摜1/2̑傫̕`.
+*         摜ꍇFrameGraph::invalidId
+*
+* ʂ͌摜ɉZĎg
+*/
+FrameGraph::ResourceId Bloom::AddPasses(FrameGraph& graph, FrameGraph::ResourceId source)
+{
+	passCount = 0;
+
+	//摜1/2n߂āAiƂɏc1/2̕`
+	FrameGraph::RenderTargetDesc desc;
+	desc.internalFormat = GL_RGBA16F;
+	desc.type = FrameBufferType::colorOnly;
+	desc.width = graph.GetDesc(source).width;
+	desc.height = graph.GetDesc(source).height;
+	FrameGraph::ResourceId levels[maxLevelCount];
+	int count = 0;
+	for (; count < levelCount; ++count)
+	{
+		desc.width /= 2;
+		desc.height /= 2;
+		if (desc.width < 1 || desc.height < 1)
+		{
+			break;
+		}
+		//1iڂ͖邢oȂk
+		FrameGraph::PassBuilder pass = graph.AddPass(count ? "BloomDownsample" : "BloomBrightPass");
+		const FrameGraph::ResourceId src = pass.Read(count ? levels[count - 1] : source);
+		const FrameGraph::ResourceId dst = pass.CreateRenderTarget("Bloom", desc);
+		const Shader::ProgramPtr program = count ? progDownsample : progBrightPass;
+		pass.SetExecuteFunc([this, program, src, dst](const FrameGraph& g) {
+			GLState::Disable(GL_BLEND);
+			DrawPass(g, program, src, dst);
+		});
+		levels[count] = dst;
+		++passCount;
+	}
+	if (count == 0)
+	{
+		return FrameGraph::invalidId;
+	}
+
+	//g債Ȃ1̒iɉZ
+	for (int i = count - 1; i > 0; --i)
+	{
+		FrameGraph::PassBuilder pass = graph.AddPass("BloomUpsample");
+		const FrameGraph::ResourceId src = pass.Read(levels[i]);
+		const FrameGraph::ResourceId dst = pass.Write(pass.Read(levels[i - 1]));
+		pass.SetExecuteFunc([this, src, dst](const FrameGraph& g) {
+			GLState::Enable(GL_BLEND);
+			GLState::BlendFunc(GL_ONE, GL_ONE);
+			DrawPass(g, progUpsample, src, dst);
+		});
+		++passCount;
+	}
+	return levels[0];
+}
+
+/**
+* ʑŜ𕢂Op`1`悷
+*
+* @param graph   `Ǘt[Ot
+* @param program `ɎgVF[_[
+* @param source  ǂݍޕ`
+* @param target  `悷`
+*/
+void Bloom::DrawPass(const FrameGraph& graph, const Shader::ProgramPtr& program,
+	FrameGraph::ResourceId source, FrameGraph::ResourceId target) const
+{
+	GLState::Disable(GL_DEPTH_TEST);
+	GLState::Disable(GL_CULL_FACE);
+	graph.BindRenderTarget(target);
+	program->Use();
+	GLState::BindTexture(0, GL_TEXTURE_2D, graph.GetColorTexture(source)->Get());
+	GLState::BindVertexArray(vao.Id());
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	RenderStats::AddDrawCall();
+	RenderStats::AddPrimitives(GL_TRIANGLES, 3);
+}
@@ -0,0 +1,49 @@
+/**
+* @file Bloom.h
+*/
+#ifndef BLOOM_H_INCLUDED
+#define BLOOM_H_INCLUDED
+#include <GL/glew.h>
+#include "FrameGraph.h"
+#include "BufferObject.h"
+#include "Shader.h"
+#include "Texture.h"
+
+/**
+* u[GtFNg
+*
+* fAtB^(Kawase)ŁAkƊgJԂĖ邢ڂ
+* 1iɂkƊg1񂸂`悷邾Ȃ̂ŁAKEXڂ`񐔂Ȃ
+* i炷ƁAڂ͈̔͂Ȃɕ`񐔂
+* kiƂ̕`̓t[Oẗꎞ`ƂĊmۂ
+*/
+class Bloom
+{
+public:
+	static const int maxLevelCount = 6;//ki̍ől
+
+	Bloom() = default;
+	~Bloom() = default;
+	Bloom(const Bloom&) = delete;
+	Bloom& operator=(const Bloom&) = delete;
+
+	bool Init();
+	void SetLevelCount(int count);
+	int GetLevelCount() const { return levelCount; }
+	FrameGraph::ResourceId AddPasses(FrameGraph& graph, FrameGraph::ResourceId source);
+	int GetPassCount() const { return passCount; }//OAddPassesŒǉpX̐
+
+private:
+	void DrawPass(const FrameGraph& graph, const Shader::ProgramPtr& program,
+		FrameGraph::ResourceId source, FrameGraph::ResourceId target) const;
+
+	int levelCount = 5;//gpi
+	int passCount = 0;
+	Shader::ProgramVariantsPtr downsampleShaders;
+	Shader::ProgramPtr progBrightPass;//1iڗp(邢oȂk)
+	Shader::ProgramPtr progDownsample;
+	Shader::ProgramPtr progUpsample;
+	VertexArrayObject vao;//_f[^ȂAʑŜ̎Op``悷邽߂VAO
+};
+
+#endif // BLOOM_H_INCLUDED
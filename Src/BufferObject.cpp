@@ -2,6 +2,8 @@
 * @file BufferObject.cpp
 */
 #include "BufferObject.h"
+#include "GLState.h"
+#include "RenderStats.h"
 #include <iostream>
 
 /**
@@ -19,9 +21,18 @@ bool BufferObject::Create(GLenum target, GLsizeiptr size, const GLvoid* data,GLe
 {
 	Destroy();
 	glGenBuffers(1, &id);
+	//VAOoChĂƁAVAÕCfbNXobt@ςĂ܂̂ŉ
+	if (target == GL_ELEMENT_ARRAY_BUFFER)
+	{
+		GLState::BindVertexArray(0);
+	}
 	glBindBuffer(target, id);
 	glBufferData(target, size, data, usage);
 	glBindBuffer(target, 0);
+	if (data)
+	{
+		RenderStats::AddUpload(size);
+	}
 	this->target = target;
 	this->size = size;
 	const GLenum error = glGetError();
@@ -55,9 +66,15 @@ bool BufferObject::BufferSubData(GLintptr offset, GLsizeiptr size, const GLvoid*
 		//\Ȕ͈͂s
 		size = this->size - offset;
 	}
+	//VAOoChĂƁAVAÕCfbNXobt@ςĂ܂̂ŉ
+	if (target == GL_ELEMENT_ARRAY_BUFFER)
+	{
+		GLState::BindVertexArray(0);
+	}
 	glBindBuffer(target, id);
 	glBufferSubData(target, offset, size, data);
 	glBindBuffer(target, 0);
+	RenderStats::AddUpload(size);
 	const GLenum error = glGetError();
 	if (error != GL_NO_ERROR)
 	{
@@ -73,7 +90,7 @@ void BufferObject::Destroy()
 {
 	if (id)
 	{
-		glDeleteBuffers(1, &id);
+		GLState::DeleteBuffer(id);
 		id = 0;
 	}
 }
@@ -91,10 +108,10 @@ bool VertexArrayObject::Create(GLuint vbo, GLuint ibo)
 {
 	Destroy();
 	glGenVertexArrays(1, &id);
-	glBindVertexArray(id);
+	GLState::BindVertexArray(id);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-	glBindVertexArray(0);
+	GLState::BindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	vboId = vbo;
@@ -114,7 +131,7 @@ void VertexArrayObject::Destroy()
 {
 	if (id)
 	{
-		glDeleteVertexArrays(1, &id);
+		GLState::DeleteVertexArray(id);
 		id = 0;
 		vboId = 0;
 		iboId = 0;
@@ -131,7 +148,7 @@ void VertexArrayObject::Destroy()
 */
 void VertexArrayObject::Bind() const
 {
-	glBindVertexArray(id);
+	GLState::BindVertexArray(id);
 	glBindBuffer(GL_ARRAY_BUFFER, vboId);
 }
 
@@ -145,7 +162,7 @@ void VertexArrayObject::Bind() const
 */
 void VertexArrayObject::Unbind() const
 {
-	glBindVertexArray(0);
+	GLState::BindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
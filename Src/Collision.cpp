@@ -2,6 +2,13 @@
 * @file Collision.cpp
 */
 #include "Collision.h"
+#include <algorithm>
+
+//SSEgł́A̕4܂Ƃ߂Ĕ肷
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define COLLISION_USE_SSE
+#include <xmmintrin.h>
+#endif
 
 namespace Collision
 {
@@ -232,4 +239,178 @@ namespace Collision
 		const glm::vec3 distance = *p - s.center;
 		return dot(distance, distance) <= s.r * s.r;
 	}
+
+	/**
+	* AABBWϊ
+	*
+	* @param box ϊAABB
+	* @param m   ϊs
+	*
+	* @return ϊbox͂AABB
+	*/
+	AABB TransformAABB(const AABB& box, const glm::mat4& m)
+	{
+		const glm::vec3 center = (box.min + box.max) * 0.5f;
+		const glm::vec3 extents = (box.max - box.min) * 0.5f;
+		const glm::vec3 newCenter(m * glm::vec4(center, 1));
+		glm::vec3 newExtents(0);
+		for (int i = 0; i < 3; ++i)
+		{
+			newExtents += glm::abs(glm::vec3(m[i])) * extents[i];
+		}
+		return AABB{ newCenter - newExtents, newCenter + newExtents };
+	}
+
+	/**
+	* Wϊ
+	*
+	* @param s ϊ鋅
+	* @param m ϊs
+	*
+	* @return ϊs͂ދ
+	*/
+	Sphere TransformSphere(const Sphere& s, const glm::mat4& m)
+	{
+		const float scale = std::max(std::max(
+			glm::length(glm::vec3(m[0])), glm::length(glm::vec3(m[1]))),
+			glm::length(glm::vec3(m[2])));
+		return Sphere{ glm::vec3(m * glm::vec4(s.center, 1)), s.r * scale };
+	}
+
+	/**
+	* r[vWFNVs񂩂王쐬
+	*
+	* @param matVP r[vWFNVs
+	*
+	* @return [hWn̎
+	*/
+	Frustum CreateFrustum(const glm::mat4& matVP)
+	{
+		//NbvW-w<=x,y,z<=w畽ʂo
+		const glm::vec4 row0(matVP[0][0], matVP[1][0], matVP[2][0], matVP[3][0]);
+		const glm::vec4 row1(matVP[0][1], matVP[1][1], matVP[2][1], matVP[3][1]);
+		const glm::vec4 row2(matVP[0][2], matVP[1][2], matVP[2][2], matVP[3][2]);
+		const glm::vec4 row3(matVP[0][3], matVP[1][3], matVP[2][3], matVP[3][3]);
+		Frustum f;
+		f.planes[0] = row3 + row0;//
+		f.planes[1] = row3 - row0;//E
+		f.planes[2] = row3 + row1;//
+		f.planes[3] = row3 - row1;//
+		f.planes[4] = row3 + row2;//O
+		f.planes[5] = row3 - row2;//
+		for (int i = 0; i < 8; ++i)
+		{
+			glm::vec4 plane(0, 0, 0, 1);
+			if (i < 6)
+			{
+				const float len = glm::length(glm::vec3(f.planes[i]));
+				if (len > 0)
+				{
+					f.planes[i] /= len;
+				}
+				plane = f.planes[i];
+			}
+			f.nx[i] = plane.x;
+			f.ny[i] = plane.y;
+			f.nz[i] = plane.z;
+			f.d[i] = plane.w;
+		}
+		return f;
+	}
+
+	/**
+	* ̓ɂ邩ׂ
+	*
+	* @param f 
+	* @param s 
+	*
+	* @retval true  ̈ꕔ܂͑S̓ɂ
+	* @retval false ͎̊Oɂ
+	*/
+	bool TestFrustumSphere(const Frustum& f, const Sphere& s)
+	{
+#ifdef COLLISION_USE_SSE
+		const __m128 cx = _mm_set1_ps(s.center.x);
+		const __m128 cy = _mm_set1_ps(s.center.y);
+		const __m128 cz = _mm_set1_ps(s.center.z);
+		const __m128 negR = _mm_set1_ps(-s.r);
+		for (int i = 0; i < 8; i += 4)
+		{
+			__m128 dist = _mm_mul_ps(_mm_loadu_ps(f.nx + i), cx);
+			dist = _mm_add_ps(dist, _mm_mul_ps(_mm_loadu_ps(f.ny + i), cy));
+			dist = _mm_add_ps(dist, _mm_mul_ps(_mm_loadu_ps(f.nz + i), cz));
+			dist = _mm_add_ps(dist, _mm_loadu_ps(f.d + i));
+			if (_mm_movemask_ps(_mm_cmplt_ps(dist, negR)))
+			{
+				return false;
+			}
+		}
+		return true;
+#else
+		for (const glm::vec4& plane : f.planes)
+		{
+			if (glm::dot(glm::vec3(plane), s.center) + plane.w < -s.r)
+			{
+				return false;
+			}
+		}
+		return true;
+#endif
+	}
+
+	/**
+	* AABB̓ɂ邩ׂ
+	*
+	* @param f   
+	* @param box AABB
+	*
+	* @retval true  AABB̈ꕔ܂͑S̓ɂ(Ǝv)
+	* @retval false AABB͎̊Oɂ
+	*
+	* eʂɂāA@ɍł_ʂ̊OɂΎ̊OƔ肷
+	* ̊p̕t߂ł́AOɂAABBƔ肷邱Ƃ
+	*/
+	bool TestFrustumAABB(const Frustum& f, const AABB& box)
+	{
+		const glm::vec3 center = (box.min + box.max) * 0.5f;
+		const glm::vec3 extents = (box.max - box.min) * 0.5f;
+#ifdef COLLISION_USE_SSE
+		const __m128 cx = _mm_set1_ps(center.x);
+		const __m128 cy = _mm_set1_ps(center.y);
+		const __m128 cz = _mm_set1_ps(center.z);
+		const __m128 ex = _mm_set1_ps(extents.x);
+		const __m128 ey = _mm_set1_ps(extents.y);
+		const __m128 ez = _mm_set1_ps(extents.z);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		for (int i = 0; i < 8; i += 4)
+		{
+			const __m128 nx = _mm_loadu_ps(f.nx + i);
+			const __m128 ny = _mm_loadu_ps(f.ny + i);
+			const __m128 nz = _mm_loadu_ps(f.nz + i);
+			__m128 dist = _mm_mul_ps(nx, cx);
+			dist = _mm_add_ps(dist, _mm_mul_ps(ny, cy));
+			dist = _mm_add_ps(dist, _mm_mul_ps(nz, cz));
+			dist = _mm_add_ps(dist, _mm_loadu_ps(f.d + i));
+			__m128 radius = _mm_mul_ps(_mm_andnot_ps(signMask, nx), ex);
+			radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey));
+			radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+			if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps())))
+			{
+				return false;
+			}
+		}
+		return true;
+#else
+		for (const glm::vec4& plane : f.planes)
+		{
+			const glm::vec3 n(plane);
+			const float radius = glm::dot(glm::abs(n), extents);
+			if (glm::dot(n, center) + plane.w + radius < 0)
+			{
+				return false;
+			}
+		}
+		return true;
+#endif
+	}
 }
\ No newline at end of file
@@ -46,6 +46,31 @@ namespace Collision
 	};
 
 
+	/**
+	* sE{bNX
+	*/
+	struct AABB
+	{
+		glm::vec3 min = glm::vec3(0);//ŏW
+		glm::vec3 max = glm::vec3(0);//őW
+	};
+
+	/**
+	* 
+	*
+	* 6̕ʂ̓\. ʂxyz̖@Aw_̋
+	* SIMDpɁAʂ4Ƃɕׂ̂(]͕KɂȂ镽)
+	* q[ṽIuWFNgɊ܂܂邱Ƃ̂ŁA16oCgE͉肵Ȃ
+	*/
+	struct Frustum
+	{
+		glm::vec4 planes[6];
+		float nx[8];
+		float ny[8];
+		float nz[8];
+		float d[8];
+	};
+
 	/**
 	* ėpՓˌ`
 	*/
@@ -74,5 +99,12 @@ namespace Collision
 	bool TestSphereCapsule(const Sphere& s, const Capsule& c, glm::vec3* p);
 	bool TestSphereOBB(const Sphere& s, const OrientedBoundingBox& obb, glm::vec3* p);
 	bool TestShapeShape(const Shape&, const Shape&, glm::vec3* pa, glm::vec3* pb);
+
+	//JOp̊֐
+	AABB TransformAABB(const AABB&, const glm::mat4&);
+	Sphere TransformSphere(const Sphere&, const glm::mat4&);
+	Frustum CreateFrustum(const glm::mat4& matVP);
+	bool TestFrustumSphere(const Frustum&, const Sphere&);
+	bool TestFrustumAABB(const Frustum&, const AABB&);
 }
 #endif 
\ No newline at end of file
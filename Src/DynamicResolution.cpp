@@ -0,0 +1,182 @@
+/**
+* @file DynamicResolution.cpp
+*/
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace /* unnamed */
+{
+	const float averageWeight = 0.1f;//ړςɐVvl銄
+	//vlɂGPŰ󂫎Ԃ܂܂Ē߂ɏôŁAl͍߂ɂĂ
+	const float decreaseThreshold = 1.00f;//ڕWԂɑ΂邱̊𒴂𑜓x
+	const float increaseThreshold = 0.85f;//ڕWԂɑ΂邱̊𑜓xグ
+	const float maxScaleStep = 0.05f;//1ɕύXk̍ől
+	const int changeInterval = 8;//kύXŒZ̃t[Ԋu(ςǂ̂҂)
+	const int viewportAlignment = 8;//r[|[g̑傫̃sNZ̔{ɂ낦
+
+} // unnamed namespace
+
+/**
+* I𑜓x
+*
+* @param targetMilliseconds ڕWƂGPU(~b)
+* @param minScale           c̏k̍ŏl
+* @param maxScale           c̏k̍ől
+*
+* @retval true  
+* @retval false s
+*/
+bool DynamicResolution::Init(float targetMilliseconds, float minScale, float maxScale)
+{
+	Destroy();
+	this->targetMilliseconds = targetMilliseconds;
+	this->minScale = std::max(0.1f, std::min(minScale, maxScale));
+	this->maxScale = std::min(1.0f, maxScale);
+	scale = this->maxScale;
+	averageMilliseconds = 0;
+	framesSinceChange = 0;
+	current = 0;
+
+	glGenQueries(queryFrameCount * 2, &queries[0][0]);
+	if (glGetError() != GL_NO_ERROR)
+	{
+		std::cerr << "[G[]" << __func__ << ":^CX^vNG̍쐬Ɏs\n";
+		Destroy();
+		return false;
+	}
+	return true;
+}
+
+/**
+* NGj
+*/
+void DynamicResolution::Destroy()
+{
+	if (queries[0][0])
+	{
+		glDeleteQueries(queryFrameCount * 2, &queries[0][0]);
+	}
+	for (int i = 0; i < queryFrameCount; ++i)
+	{
+		queries[i][0] = queries[i][1] = 0;
+		pending[i] = false;
+	}
+}
+
+/**
+* `施߂𑗂钼OɌĂяoāAJñNG𔭍s
+*
+* Õt[܂ł̌vʂɂk̕ύX́AGetViewportSize甽f
+*/
+void DynamicResolution::BeginFrame()
+{
+	if (!queries[0][0])
+	{
+		return;
+	}
+
+	//ʂo܂ő҂ƕ`悪~܂̂ŁA܂ʂ̏oĂȂg͎g킸ɔ΂
+	if (pending[current])
+	{
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(queries[current][1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+		{
+			return;
+		}
+		GLuint64 begin = 0;
+		GLuint64 end = 0;
+		glGetQueryObjectui64v(queries[current][0], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(queries[current][1], GL_QUERY_RESULT, &end);
+		pending[current] = false;
+		Update(static_cast<float>(end - begin) / 1000000.0f);
+	}
+	glQueryCounter(queries[current][0], GL_TIMESTAMP);
+}
+
+/**
+* `施߂𑗂IɌĂяoāAĨNG𔭍s
+*/
+void DynamicResolution::EndFrame()
+{
+	if (!queries[0][0] || pending[current])
+	{
+		return;
+	}
+	glQueryCounter(queries[current][1], GL_TIMESTAMP);
+	pending[current] = true;
+	current = (current + 1) % queryFrameCount;
+}
+
+/**
+* 𑜓x̕ύXLEɂ
+*
+* @param enable trueȂLAfalseȂ疳(kőlɖ߂)
+*/
+void DynamicResolution::SetEnabled(bool enable)
+{
+	enabled = enable;
+	if (!enabled)
+	{
+		scale = maxScale;
+	}
+}
+
+/**
+* kKpr[|[g̑傫擾
+*
+* @param width  `̕
+* @param height `̍
+*
+* @return r[|[g̕ƍ
+*/
+glm::ivec2 DynamicResolution::GetViewportSize(int width, int height) const
+{
+	if (scale >= 1.0f)
+	{
+		return glm::ivec2(width, height);
+	}
+	const int w = static_cast<int>(width * scale) / viewportAlignment * viewportAlignment;
+	const int h = static_cast<int>(height * scale) / viewportAlignment * viewportAlignment;
+	return glm::ivec2(std::max(viewportAlignment, std::min(w, width)),
+		std::max(viewportAlignment, std::min(h, height)));
+}
+
+/**
+* GPUԂ̌vlkXV
+*
+* @param milliseconds vGPU(~b)
+*/
+void DynamicResolution::Update(float milliseconds)
+{
+	if (averageMilliseconds <= 0)
+	{
+		averageMilliseconds = milliseconds;
+	}
+	else
+	{
+		averageMilliseconds += (milliseconds - averageMilliseconds) * averageWeight;
+	}
+	if (!enabled || ++framesSinceChange < changeInterval || averageMilliseconds <= 0)
+	{
+		return;
+	}
+
+	//`掞Ԃ͉f(k2)ɂقڔႷƂ݂ȂāAڕWԂɎ܂k߂
+	const float ratio = targetMilliseconds / averageMilliseconds;
+	if (ratio < 1.0f / decreaseThreshold || ratio > 1.0f / increaseThreshold)
+	{
+		//2̂l̒Ԃ_
+		const float aim = (decreaseThreshold + increaseThreshold) * 0.5f;
+		const float idealScale = scale * std::sqrt(ratio * aim);
+		const float step = std::max(-maxScaleStep, std::min(idealScale - scale, maxScaleStep));
+		const float newScale = std::max(minScale, std::min(scale + step, maxScale));
+		if (newScale != scale)
+		{
+			scale = newScale;
+			framesSinceChange = 0;
+		}
+	}
+}
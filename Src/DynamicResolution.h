@@ -0,0 +1,61 @@
+/**
+* @file DynamicResolution.h
+*/
+#ifndef DYNAMICRESOLUTION_H_INCLUDED
+#define DYNAMICRESOLUTION_H_INCLUDED
+#include <GL/glew.h>
+#include <glm/vec2.hpp>
+
+/**
+* GPU̕`掞Ԃɍ킹ĕ`𑜓xς
+*
+* `施߂̑OɃ^CX^vNG𔭍sAt[Ǒʂ
+* GPUԂ̈ړς߂. ςڕWԂ𒴂Ȃ𑜓xA
+* \ȗ]TΉ𑜓xグ.
+* 𑜓x̕ύX́A`̈ꕔr[|[gƂĎgƂōŝŁA
+* FBO蒼Kv͂Ȃ
+*
+* ProfilerpXƂɎgGL_TIME_ELAPSEDNG͓qɂłȂ߁At[Ŝ
+* ^CX^v̍Ōv. ̍ɂCPȔ҂GPU󂢂ĂԂ܂܂̂ŁA
+* vl͎ۂ̕`掞Ԃ蒷߂ɏo. 󂫎Ԃ炷߁A`施߂𑗂钼O
+* BeginFrameAIEndFrameĂяo
+*/
+class DynamicResolution
+{
+public:
+	static const int queryFrameCount = 4;//ʂ҂ԂɎgNG̑g̐
+
+	DynamicResolution() = default;
+	~DynamicResolution() { Destroy(); }
+	DynamicResolution(const DynamicResolution&) = delete;
+	DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+	bool Init(float targetMilliseconds, float minScale = 0.5f, float maxScale = 1.0f);
+	void Destroy();
+	void BeginFrame();
+	void EndFrame();
+
+	void SetEnabled(bool enable);
+	bool IsEnabled() const { return enabled; }
+	void SetTargetTime(float milliseconds) { targetMilliseconds = milliseconds; }
+	float GetScale() const { return scale; }
+	float GetAverageTime() const { return averageMilliseconds; }
+	glm::ivec2 GetViewportSize(int width, int height) const;
+
+private:
+	void Update(float milliseconds);
+
+	GLuint queries[queryFrameCount][2] = {};//t[̊JnƏĨ^CX^vNG
+	bool pending[queryFrameCount] = {};//ʂǂݏoĂȂNGȂtrue
+	int current = 0;//̃t[ŎgNG̑g̔ԍ
+	bool enabled = true;
+
+	float targetMilliseconds = 16.0f;//ڕWƂGPU(~b)
+	float averageMilliseconds = 0;//GPUԂ̈ړ(~b)
+	float minScale = 0.5f;//c̏k̍ŏl
+	float maxScale = 1.0f;//c̏k̍ől
+	float scale = 1.0f;//݂̏c̏k
+	int framesSinceChange = 0;//kŌɕύXĂo߂t[
+};
+
+#endif // DYNAMICRESOLUTION_H_INCLUDED
@@ -0,0 +1,445 @@
+/**
+* @file FrameGraph.cpp
+*/
+#include "FrameGraph.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include <iostream>
+
+namespace /* unnamed */
+{
+	/**
+	* `悪gpoCgvZ
+	*
+	* @param desc `̍쐬p[^
+	*
+	* @return `̃J[obt@Ɛ[xobt@̍voCg
+	*/
+	size_t CalcByteSize(const FrameGraph::RenderTargetDesc& desc)
+	{
+		size_t bytesPerPixel = 0;
+		if (desc.type != FrameBufferType::depthOnly)
+		{
+			switch (desc.internalFormat)
+			{
+			case GL_RGBA16F: bytesPerPixel += 8; break;
+			case GL_RGBA32F: bytesPerPixel += 16; break;
+			default: bytesPerPixel += 4; break;
+			}
+		}
+		if (desc.type != FrameBufferType::colorOnly)
+		{
+			bytesPerPixel += 4;//GL_DEPTH_COMPONENT32F
+		}
+		return static_cast<size_t>(desc.width) * static_cast<size_t>(desc.height) * bytesPerPixel;
+	}
+
+} // unnamed namespace
+
+/**
+* ꎞ`쐬ApXނƂ錾
+*
+* @param name `̖O(G[\p)
+* @param desc `̍쐬p[^
+*
+* @return 쐬`ID
+*/
+FrameGraph::ResourceId FrameGraph::PassBuilder::CreateRenderTarget(
+	const char* name, const RenderTargetDesc& desc)
+{
+	Resource r;
+	r.name = name;
+	r.desc = desc;
+	graph.resources.push_back(r);
+	return Write(static_cast<ResourceId>(graph.resources.size() - 1));
+}
+
+/**
+* pX`ǂݍނƂ錾
+*
+* @param id ǂݍޕ`ID
+*
+* @return idƓl
+*/
+FrameGraph::ResourceId FrameGraph::PassBuilder::Read(ResourceId id)
+{
+	if (!graph.IsValid(id))
+	{
+		std::cerr << "[G[]" << __func__ << ":" << graph.passes[pass].name <<
+			"ȕ`(" << id << ")ǂݍƂ܂\n";
+		return invalidId;
+	}
+	graph.passes[pass].reads.push_back(id);
+	return id;
+}
+
+/**
+* pX`ɏނƂ錾
+*
+* @param id ޕ`ID
+*
+* @return idƓl
+*/
+FrameGraph::ResourceId FrameGraph::PassBuilder::Write(ResourceId id)
+{
+	if (!graph.IsValid(id))
+	{
+		std::cerr << "[G[]" << __func__ << ":" << graph.passes[pass].name <<
+			"ȕ`(" << id << ")ɏƂ܂\n";
+		return invalidId;
+	}
+	graph.passes[pass].writes.push_back(id);
+	++graph.resources[id].writerCount;
+	return id;
+}
+
+/**
+* pXsƂɌĂяo֐ݒ肷
+*
+* @param func Ăяo֐. ͕`擾邽߂̃t[Ot
+*/
+void FrameGraph::PassBuilder::SetExecuteFunc(const ExecuteFunc& func)
+{
+	graph.passes[pass].func = func;
+}
+
+/**
+* ǉpXƕ`Sč폜
+*
+* ꎞ`Ɋ蓖ĂFBÓÃt[ōėp邽߂ɎcĂ
+*/
+void FrameGraph::Clear()
+{
+	resources.clear();
+	passes.clear();
+	compiled = false;
+}
+
+/**
+* t[܂Ŏg`o^
+*
+* @param name   `̖O(G[\p)
+* @param fbo    `FBO. nullptrȂftHgt[obt@
+* @param width  `̕
+* @param height `̍
+*
+* @return o^`ID
+*/
+FrameGraph::ResourceId FrameGraph::Import(
+	const char* name, const FramebufferObjectPtr& fbo, int width, int height)
+{
+	Resource r;
+	r.name = name;
+	r.desc.width = width;
+	r.desc.height = height;
+	r.fbo = fbo;
+	r.imported = true;
+	resources.push_back(r);
+	return static_cast<ResourceId>(resources.size() - 1);
+}
+
+/**
+* `pXǉ
+*
+* @param name pX̖O(G[\p)
+*
+* @return ǂݏ`Ǝs֐ݒ肷邽߂̃IuWFNg
+*
+* pX͒ǉԂɎs. `ID́A쐬pXǉƂł
+* Ȃ̂ŁAǉԂ͏Ɉˑ֌W𖞂Ă
+*/
+FrameGraph::PassBuilder FrameGraph::AddPass(const char* name)
+{
+	Pass p;
+	p.name = name;
+	passes.push_back(p);
+	return PassBuilder(*this, static_cast<int>(passes.size() - 1));
+}
+
+/**
+* ŏIIɕKvȕ`w肷
+*
+* @param id `ID
+*
+* ̕`ɏރpXƁAꂪˑpXs
+*/
+void FrameGraph::SetOutput(ResourceId id)
+{
+	if (IsValid(id))
+	{
+		resources[id].output = true;
+	}
+}
+
+/**
+* spX߁Aꎞ`FBO蓖Ă
+*
+* @retval true  RpC
+* @retval false ރpX̂Ȃ`ǂݍƂ
+*/
+bool FrameGraph::Compile()
+{
+	stats = Statistics();
+	stats.passCount = passes.size();
+
+	//o͂tɂǂAʂgȂpXO
+	std::vector<bool> needed(resources.size(), false);
+	for (size_t i = 0; i < resources.size(); ++i)
+	{
+		needed[i] = resources[i].output;
+	}
+	for (auto itr = passes.rbegin(); itr != passes.rend(); ++itr)
+	{
+		itr->culled = true;
+		for (ResourceId id : itr->writes)
+		{
+			if (needed[id])
+			{
+				itr->culled = false;
+				break;
+			}
+		}
+		if (itr->culled)
+		{
+			++stats.culledPassCount;
+			continue;
+		}
+		for (ResourceId id : itr->reads)
+		{
+			needed[id] = true;
+		}
+	}
+
+	//`悲ƂɁAgpŏƍŌ̃pX߂
+	for (Resource& r : resources)
+	{
+		r.firstPass = r.lastPass = -1;
+	}
+	for (int i = 0; i < static_cast<int>(passes.size()); ++i)
+	{
+		const Pass& pass = passes[i];
+		if (pass.culled)
+		{
+			continue;
+		}
+		for (const std::vector<ResourceId>* list : { &pass.reads, &pass.writes })
+		{
+			for (ResourceId id : *list)
+			{
+				Resource& r = resources[id];
+				if (r.firstPass < 0)
+				{
+					r.firstPass = i;
+				}
+				r.lastPass = i;
+			}
+		}
+	}
+	bool result = true;
+	for (const Resource& r : resources)
+	{
+		if (!r.imported && r.firstPass >= 0 && r.writerCount == 0)
+		{
+			std::cerr << "[G[]" << __func__ << ":" << r.name << "ɏރpX܂\n";
+			result = false;
+		}
+	}
+
+	//pX̏ԂɁAgn߂ꎞ`FBO蓖āAgIFBOԋp
+	for (PoolEntry& e : pool)
+	{
+		e.inUse = false;
+		e.used = false;
+	}
+	for (int i = 0; i < static_cast<int>(passes.size()); ++i)
+	{
+		for (Resource& r : resources)
+		{
+			if (!r.imported && r.firstPass == i)
+			{
+				r.fbo = Acquire(r.desc);
+				++stats.transientCount;
+				stats.unaliasedBytes += CalcByteSize(r.desc);
+			}
+		}
+		for (const Resource& r : resources)
+		{
+			if (!r.imported && r.lastPass == i)
+			{
+				Release(r.fbo);
+			}
+		}
+	}
+
+	//̃t[ŎgȂFBO͍폜(ʃTCY̕ύXȂǂŕsvɂȂ)
+	for (auto itr = pool.begin(); itr != pool.end();)
+	{
+		if (itr->used)
+		{
+			++stats.pooledTargetCount;
+			stats.peakBytes += CalcByteSize(itr->desc);
+			++itr;
+		}
+		else
+		{
+			itr = pool.erase(itr);
+		}
+	}
+
+	compiled = result;
+	return result;
+}
+
+/**
+* OȂpXǉԂɎs
+*
+* epXCPUԂGPUԂ́ApXԖƂProfilerŌv
+*/
+void FrameGraph::Execute()
+{
+	if (!compiled)
+	{
+		std::cerr << "[G[]" << __func__ << ":RpCĂ܂\n";
+		return;
+	}
+	for (const Pass& pass : passes)
+	{
+		if (!pass.culled && pass.func)
+		{
+			PROFILE_GPU_SCOPE(pass.name.c_str());
+			pass.func(*this);
+		}
+	}
+}
+
+/**
+* `̍쐬p[^擾
+*
+* @param id `ID
+*
+* @return `̍쐬p[^
+*/
+const FrameGraph::RenderTargetDesc& FrameGraph::GetDesc(ResourceId id) const
+{
+	static const RenderTargetDesc dummy;
+	return IsValid(id) ? resources[id].desc : dummy;
+}
+
+/**
+* `FBOID擾
+*
+* @param id `ID
+*
+* @return FBOID. ftHgt[obt@⊄蓖ĂĂȂ`̏ꍇ0
+*/
+GLuint FrameGraph::GetFramebuffer(ResourceId id) const
+{
+	if (!IsValid(id) || !resources[id].fbo)
+	{
+		return 0;
+	}
+	return resources[id].fbo->GetFramebuffer();
+}
+
+/**
+* `̃J[obt@peNX`擾
+*
+* @param id `ID
+*
+* @return J[obt@peNX`. ݂Ȃꍇnullptr
+*/
+const Texture::Image2DPtr& FrameGraph::GetColorTexture(ResourceId id) const
+{
+	static const Texture::Image2DPtr null;
+	if (!IsValid(id) || !resources[id].fbo)
+	{
+		return null;
+	}
+	return resources[id].fbo->GetColorTexture();
+}
+
+/**
+* `̐[xobt@peNX`擾
+*
+* @param id `ID
+*
+* @return [xobt@peNX`. ݂Ȃꍇnullptr
+*/
+const Texture::Image2DPtr& FrameGraph::GetDepthTexture(ResourceId id) const
+{
+	static const Texture::Image2DPtr null;
+	if (!IsValid(id) || !resources[id].fbo)
+	{
+		return null;
+	}
+	return resources[id].fbo->GetDepthTexture();
+}
+
+/**
+* `oChAr[|[g`Ŝɐݒ肷
+*
+* @param id `ID
+*/
+void FrameGraph::BindRenderTarget(ResourceId id) const
+{
+	const RenderTargetDesc& desc = GetDesc(id);
+	GLState::BindFramebuffer(GetFramebuffer(id));
+	glViewport(0, 0, desc.width, desc.height);
+}
+
+/**
+* `IDLׂ
+*
+* @param id `ID
+*
+* @retval true  L
+* @retval false 
+*/
+bool FrameGraph::IsValid(ResourceId id) const
+{
+	return id >= 0 && id < static_cast<ResourceId>(resources.size());
+}
+
+/**
+* gĂȂFBO蓖Ă
+*
+* @param desc `̍쐬p[^
+*
+* @return 蓖ĂFBO. 쐬p[^v󂫂ȂΐV쐬
+*/
+FramebufferObjectPtr FrameGraph::Acquire(const RenderTargetDesc& desc)
+{
+	for (PoolEntry& e : pool)
+	{
+		if (!e.inUse && e.desc == desc)
+		{
+			e.inUse = true;
+			e.used = true;
+			return e.fbo;
+		}
+	}
+	PoolEntry e;
+	e.desc = desc;
+	e.fbo = FramebufferObject::Create(desc.width, desc.height, desc.internalFormat, desc.type);
+	e.inUse = true;
+	e.used = true;
+	pool.push_back(e);
+	return e.fbo;
+}
+
+/**
+* 蓖ĂFBOԋpAق̈ꎞ`Ŏg悤ɂ
+*
+* @param fbo ԋpFBO
+*/
+void FrameGraph::Release(const FramebufferObjectPtr& fbo)
+{
+	for (PoolEntry& e : pool)
+	{
+		if (e.fbo == fbo)
+		{
+			e.inUse = false;
+			return;
+		}
+	}
+}
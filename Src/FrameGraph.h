@@ -0,0 +1,150 @@
+/**
+* @file FrameGraph.h
+*/
+#ifndef FRAMEGRAPH_H_INCLUDED
+#define FRAMEGRAPH_H_INCLUDED
+#include <GL/glew.h>
+#include "FramebufferObject.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+* `pẌˑ֌WL^A`̊mۂƎsǗ
+*
+* g:
+* 1. t[̍ŏClearĂ
+* 2. AddPassŕ`pXǉA߂lPassBuilderœǂݏ`
+*    s֐ݒ肷. ʂVhE}bv̂悤ɁAt[܂Ŏg`Importœo^
+* 3. ŏIIɕKvȕ`SetOutputŎw肵ACompileĂ
+* 4. ExecuteŁAKvȃpXǉԂɎs
+*
+* CreateRenderTargetō쐬`(ꎞ`)́AŏɏރpX
+* ŌɓǂݍރpX܂ł̊Ԃ݂. ݂ԂdȂ炸A傫ƌ`
+* ꎞ`́AFBOL. ̂߁A`O̓e͕sɂȂ.
+* ꎞ`ɍŏɏރpX́AKʑŜ邩㏑邱.
+*/
+class FrameGraph
+{
+public:
+	using ResourceId = int;
+	static const ResourceId invalidId = -1;
+	using ExecuteFunc = std::function<void(const FrameGraph&)>;
+
+	/**
+	* ꎞ`̍쐬p[^
+	*/
+	struct RenderTargetDesc
+	{
+		int width = 0;
+		int height = 0;
+		GLenum internalFormat = GL_RGBA8;
+		FrameBufferType type = FrameBufferType::colorAndDepth;
+
+		bool operator==(const RenderTargetDesc& other) const
+		{
+			return width == other.width && height == other.height &&
+				internalFormat == other.internalFormat && type == other.type;
+		}
+	};
+
+	/**
+	* `pXǂݏ`錾邽߂̃NX
+	*/
+	class PassBuilder
+	{
+	public:
+		PassBuilder(FrameGraph& g, int p) : graph(g), pass(p) {}
+		ResourceId CreateRenderTarget(const char* name, const RenderTargetDesc& desc);
+		ResourceId Read(ResourceId id);
+		ResourceId Write(ResourceId id);
+		void SetExecuteFunc(const ExecuteFunc& func);
+
+	private:
+		FrameGraph& graph;
+		int pass;
+	};
+
+	/**
+	* `̎gp
+	*/
+	struct Statistics
+	{
+		size_t passCount = 0;//ǉꂽpX̐
+		size_t culledPassCount = 0;//ʂgȂ̂ŎsȂpX̐
+		size_t transientCount = 0;//gpꎞ`̐
+		size_t pooledTargetCount = 0;//ꎞ`Ɋ蓖ĂFBO̐
+		size_t peakBytes = 0;//ꎞ`Ɋ蓖ĂFBO̍voCg
+		size_t unaliasedBytes = 0;//FBOLȂꍇɕKvȃoCg
+	};
+
+	FrameGraph() = default;
+	~FrameGraph() = default;
+	FrameGraph(const FrameGraph&) = delete;
+	FrameGraph& operator=(const FrameGraph&) = delete;
+
+	void Clear();
+	ResourceId Import(const char* name, const FramebufferObjectPtr& fbo, int width, int height);
+	PassBuilder AddPass(const char* name);
+	void SetOutput(ResourceId id);
+	bool Compile();
+	void Execute();
+
+	const RenderTargetDesc& GetDesc(ResourceId id) const;
+	GLuint GetFramebuffer(ResourceId id) const;
+	const Texture::Image2DPtr& GetColorTexture(ResourceId id) const;
+	const Texture::Image2DPtr& GetDepthTexture(ResourceId id) const;
+	void BindRenderTarget(ResourceId id) const;
+	const Statistics& GetStatistics() const { return stats; }
+
+private:
+	/**
+	* `
+	*/
+	struct Resource
+	{
+		std::string name;
+		RenderTargetDesc desc;
+		FramebufferObjectPtr fbo;//C|[g`A܂͊蓖ĂFBO
+		bool imported = false;
+		bool output = false;
+		int writerCount = 0;//ރpX̐
+		int firstPass = -1;//ŏɎgppX̔ԍ
+		int lastPass = -1;//ŌɎgppX̔ԍ
+	};
+
+	/**
+	* `pX
+	*/
+	struct Pass
+	{
+		std::string name;
+		ExecuteFunc func;
+		std::vector<ResourceId> reads;
+		std::vector<ResourceId> writes;
+		bool culled = false;
+	};
+
+	/**
+	* ꎞ`Ɋ蓖ĂFBO
+	*/
+	struct PoolEntry
+	{
+		RenderTargetDesc desc;
+		FramebufferObjectPtr fbo;
+		bool inUse = false;//݂̃pXŊ蓖ĒȂtrue
+		bool used = false;//̃t[Ŋ蓖ĂȂtrue
+	};
+
+	bool IsValid(ResourceId id) const;
+	FramebufferObjectPtr Acquire(const RenderTargetDesc& desc);
+	void Release(const FramebufferObjectPtr& fbo);
+
+	std::vector<Resource> resources;
+	std::vector<Pass> passes;
+	std::vector<PoolEntry> pool;//t[܂ōėpFBO
+	bool compiled = false;
+	Statistics stats;
+};
+
+#endif // FRAMEGRAPH_H_INCLUDED
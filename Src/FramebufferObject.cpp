@@ -2,6 +2,7 @@
 * @file FramebufferObject.cpp
 */
 #include "FramebufferObject.h"
+#include "GLState.h"
 
 /**
 * t[obt@IuWFNg쐬
@@ -50,7 +51,7 @@ FramebufferObjectPtr FramebufferObject::Create(int w, int h,
 
 	//t[obt@쐬
 	glGenFramebuffers(1, &fbo->id);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo->id);
+	GLState::BindFramebuffer(fbo->id);
 	if (fbo->texColor)
 	{
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
@@ -61,7 +62,7 @@ FramebufferObjectPtr FramebufferObject::Create(int w, int h,
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
 			fbo->texDepth->Target(), fbo->texDepth->Get(), 0);
 	}
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(0);
 
 	return fbo;
 }
@@ -74,7 +75,7 @@ FramebufferObject::~FramebufferObject()
 {
 	if (id)
 	{
-		glDeleteFramebuffers(1, &id);
+		GLState::DeleteFramebuffer(id);
 	}
 }
 
@@ -3,10 +3,37 @@
 */
 #include "GLFWEW.h"
 #include <iostream>
+#include <cstring>
 
 //GLFWGLEWbv邽߂̖O
 namespace GLFWEW
 {
+	namespace /* unnamed */
+	{
+		/**
+		* ͋L^t@C̃wb_
+		*/
+		struct InputLogHeader
+		{
+			char magic[4];//t@C̎ʎq
+			uint32_t version;//t@C`̃o[W
+			uint32_t seed;//L^Ƃ̗̎
+		};
+		const char inputLogMagic[4] = { 'I', 'N', 'P', 'L' };
+		const uint32_t inputLogVersion = 1;
+
+		/**
+		* ͋L^t@C1t[̃f[^
+		*/
+		struct InputLogFrame
+		{
+			float deltaTime;//oߎ
+			uint32_t buttons;//GamePad::buttons
+			uint32_t buttonDown;//GamePad::buttonDown
+		};
+
+	} // unnamed namespace
+
 	/**
 	*GLFW̃G[񍐂
 	*
@@ -54,11 +81,16 @@ namespace GLFWEW
 *@param w EBhE̕`͈͂̕(sNZ)
 *@param h EBhE̕`͈͂̍(sNZ)
 *@param title EBhE^Cg(UTF-80I[)
+*@param headless trueȂEBhE\A҂Ȃ
 *
 *@retval true 
 *@retval false s
+*
+*headlesstruȅꍇA\̃EBhEGLReLXg쐬
+*(eV[̏Ńobt@VF[_[쐬邽)
+*GPÛȂł́AMesaȂǂ̃\tgEFAOpenGLg
 */
-	bool Window::Init(int w, int h, const char* title)
+	bool Window::Init(int w, int h, const char* title, bool headless)
 	{
 		if (isInitialized)
 		{
@@ -76,13 +108,22 @@ namespace GLFWEW
 		}
 		if (!window)
 		{
+			if (headless)
+			{
+				glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+			}
 			window = glfwCreateWindow(w, h, title, nullptr, nullptr);
 			if (!window)
 			{
 				return false;
 			}
 			glfwMakeContextCurrent(window);
+			if (headless)
+			{
+				glfwSwapInterval(0);
+			}
 		}
+		isHeadless = headless;
 		if (glewInit() != GLEW_OK)
 		{
 			std::cerr << "ERROR: GLEW̏Ɏs܂" << std::endl;
@@ -113,16 +154,25 @@ namespace GLFWEW
 */
 	bool Window::ShouldClose() const
 	{
+		if (isReplayFinished)
+		{
+			return true;
+		}
 		return glfwWindowShouldClose(window) != 0;
 	}
 
 /**
 *tgobt@ƃobNobt@؂ւ
+*
+*wbhX[hł́ACxg̏s
 */
 	void Window::SwapBuffers() const
 	{
 		glfwPollEvents();
-		glfwSwapBuffers(window);
+		if (!isHeadless)
+		{
+			glfwSwapBuffers(window);
+		}
 	}
 
 /**
@@ -304,9 +354,18 @@ namespace GLFWEW
 
 /**
 * ^C}[XV
+*
+* ͂ĐĂƂ́AoߎԂƃQ[pbh̏ԂL^t@Cǂݍ
+* SetFixedDeltaTimeŌoߎԂw肵Ƃ́Aۂ̎Ԃ̑ɂ̒lg
 */
 	void Window::UpdateTimer()
 	{
+		if (inputLogMode == InputLogMode::replay)
+		{
+			ReadInputLog();
+			return;
+		}
+
 		//oߎԂv
 		const double currentTime = glfwGetTime();
 		deltaTime = currentTime - previousTime;
@@ -318,7 +377,15 @@ namespace GLFWEW
 		{
 			deltaTime = 0.1f;
 		}
+		if (fixedDeltaTime > 0)
+		{
+			deltaTime = fixedDeltaTime;
+		}
 		UpdateGamePad();
+		if (inputLogMode == InputLogMode::record)
+		{
+			WriteInputLog();
+		}
 	}
  
 /**
@@ -335,10 +402,136 @@ namespace GLFWEW
 * oߎԂ擾
 *
 * @return GLFWĂ̌oߎ(b)
+*
+* ͂L^EĐĂƂ́AL^oߎԂ̍vԂ
+* (L^ƍĐœlɂȂ悤ɂ邽)
 */
 	double Window::Time() const
 	{
+		if (inputLogMode != InputLogMode::none)
+		{
+			return inputLogTime;
+		}
 		return glfwGetTime();
 	}
 
+/**
+* ͂̋L^Jn
+*
+* @param path L^t@C
+* @param seed ̎(t@CɋL^AĐGetInputLogSeedŎ擾ł)
+*
+* @retval true  L^Jn
+* @retval false t@C쐬łȂ
+*
+* ȌAUpdateTimerĂяoтɌoߎԂƃQ[pbh̏ԂL^
+*/
+	bool Window::StartRecording(const char* path, uint32_t seed)
+	{
+		StopInputLog();
+		inputLog.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!inputLog)
+		{
+			std::cerr << "[G[]" << __func__ << ":" << path << "쐬ł܂\n";
+			return false;
+		}
+		InputLogHeader header;
+		std::memcpy(header.magic, inputLogMagic, sizeof(header.magic));
+		header.version = inputLogVersion;
+		header.seed = seed;
+		inputLog.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		inputLogMode = InputLogMode::record;
+		inputLogSeed = seed;
+		return true;
+	}
+
+/**
+* ͂̍ĐJn
+*
+* @param path StartRecordingŋL^t@C
+*
+* @retval true  ĐJn
+* @retval false t@Cǂݍ߂Ȃ
+*
+* ȌAUpdateTimer͎ۂ̎ԂƓ͂̑ɋL^lg
+* Ō܂ōĐShouldClosetrueԂ
+*/
+	bool Window::StartReplay(const char* path)
+	{
+		StopInputLog();
+		inputLog.open(path, std::ios::in | std::ios::binary);
+		if (!inputLog)
+		{
+			std::cerr << "[G[]" << __func__ << ":" << path << "J܂\n";
+			return false;
+		}
+		InputLogHeader header;
+		inputLog.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!inputLog || std::memcmp(header.magic, inputLogMagic, sizeof(header.magic)) != 0 ||
+			header.version != inputLogVersion)
+		{
+			std::cerr << "[G[]" << __func__ << ":" << path << "͓͋L^t@Cł͂܂\n";
+			inputLog.close();
+			return false;
+		}
+		inputLogMode = InputLogMode::replay;
+		inputLogSeed = header.seed;
+		return true;
+	}
+
+/**
+* ͂̋L^EĐI
+*/
+	void Window::StopInputLog()
+	{
+		if (inputLog.is_open())
+		{
+			inputLog.close();
+		}
+		inputLogMode = InputLogMode::none;
+		inputLogFrameCount = 0;
+		inputLogTime = 0;
+		isReplayFinished = false;
+	}
+
+/**
+* 1t[̓͂L^
+*/
+	void Window::WriteInputLog()
+	{
+		const InputLogFrame frame = {
+			static_cast<float>(deltaTime), gamepad.buttons, gamepad.buttonDown };
+		inputLog.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+		deltaTime = frame.deltaTime;//ĐƓxɂ낦
+		inputLogTime += deltaTime;
+		++inputLogFrameCount;
+	}
+
+/**
+* 1t[̓͂Đ
+*
+* t@C̏IɒBA͂čĐIƂ
+*/
+	void Window::ReadInputLog()
+	{
+		InputLogFrame frame;
+		inputLog.read(reinterpret_cast<char*>(&frame), sizeof(frame));
+		if (!inputLog)
+		{
+			if (!isReplayFinished)
+			{
+				std::cout << "[]͂̍ĐI܂(" << inputLogFrameCount << "t[)\n";
+				isReplayFinished = true;
+			}
+			deltaTime = 0;
+			gamepad = GamePad();
+			return;
+		}
+		deltaTime = frame.deltaTime;
+		gamepad.buttons = frame.buttons;
+		gamepad.buttonDown = frame.buttonDown;
+		inputLogTime += deltaTime;
+		++inputLogFrameCount;
+	}
+
 } //namespace GLFWGW
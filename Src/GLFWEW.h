@@ -6,6 +6,8 @@
 #include <GL/glew.h>
 #include "GamePad.h"
 #include <GLFW/glfw3.h>
+#include <fstream>
+#include <cstdint>
 
 namespace GLFWEW
 {
@@ -16,12 +18,14 @@ namespace GLFWEW
 	{
 	public:
 		static Window& Instance();
-		bool Init(int w, int h, const char* title);
+		bool Init(int w, int h, const char* title, bool headless = false);
+		bool IsHeadless() const { return isHeadless; }
 		bool ShouldClose() const;
 		void SwapBuffers() const;
 
 		void InitTimer();
 		void UpdateTimer();
+		void SetFixedDeltaTime(double dt) { fixedDeltaTime = dt; }
 		double DeltaTime() const;
 		double Time() const;
 		int Width() const { return width; }
@@ -30,21 +34,48 @@ namespace GLFWEW
 		bool IsKeyPressed(int Key) const;
 		const GamePad& GetGamePad() const;
 
+		bool StartRecording(const char* path, uint32_t seed);
+		bool StartReplay(const char* path);
+		void StopInputLog();
+		bool IsInputLogActive() const { return inputLogMode != InputLogMode::none; }
+		uint32_t GetInputLogSeed() const { return inputLogSeed; }
+
 	private:
 		Window();
 		~Window();
 		Window(const Window&) = delete;
 		Window& operator = (const Window&) = delete;
 		void UpdateGamePad();
+		void WriteInputLog();
+		void ReadInputLog();
+
+		/**
+		* ͂̋L^EĐ̏
+		*/
+		enum class InputLogMode
+		{
+			none,//L^ĐĂȂ
+			record,//t[̓͂t@CɋL^Ă
+			replay,//t@CɋL^ꂽ͂ĐĂ
+		};
 
 		bool isGLFWInitialized = false;
 		bool isInitialized = false;
+		bool isHeadless = false;//EBhE\ɎsȂtrue
 		GLFWwindow* window = nullptr;
 		int width = 0;
 		int height = 0;
 		double previousTime = 0;
 		double deltaTime = 0;
+		double fixedDeltaTime = 0;//0傫΁Aۂ̎Ԃ̑Ɏgoߎ
 		GamePad gamepad;
+
+		InputLogMode inputLogMode = InputLogMode::none;
+		std::fstream inputLog;//͂L^EĐt@C
+		uint32_t inputLogSeed = 0;//L^Ƃ̗̎
+		uint64_t inputLogFrameCount = 0;//L^EĐt[
+		double inputLogTime = 0;//L^EĐoߎԂ̍v
+		bool isReplayFinished = false;//Ō܂ōĐtrue
 	};
 
 } //namespace GLFWEW
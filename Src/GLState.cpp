@@ -0,0 +1,444 @@
+/**
+* @file GLState.cpp
+*/
+#include "GLState.h"
+#include "RenderStats.h"
+
+namespace GLState
+{
+	namespace /* unnamed */
+	{
+		const GLuint unknown = static_cast<GLuint>(-1);//ԂȂƂl
+		const int maxTextureUnitCount = 16;//L^eNX`C[Wjbg̐
+		const int textureTargetCount = 3;//L^eNX`̎ނ̐
+		const int maxUniformBufferCount = 16;//L^UBOoCfBO|Cg̐
+		const int maxStorageBufferCount = 8;//L^SSBOoCfBO|Cg̐
+
+		/**
+		* UBOASSBÕoCfBO|CgɊ蓖Ă͈
+		*/
+		struct BufferRange
+		{
+			GLuint buffer = unknown;
+			GLintptr offset = 0;
+			GLsizeiptr size = 0;
+		};
+
+		/**
+		* L^ĂOpenGL̏
+		*/
+		struct State
+		{
+			GLuint program = unknown;
+			GLuint vao = unknown;
+			GLuint activeTexture = unknown;
+			GLuint textures[maxTextureUnitCount][textureTargetCount];
+			GLuint fbo = unknown;
+			GLuint blend = unknown;
+			GLuint depthTest = unknown;
+			GLuint cullFace = unknown;
+			GLenum blendSrc = unknown;
+			GLenum blendDst = unknown;
+			GLuint depthMask = unknown;
+			BufferRange uniformBuffers[maxUniformBufferCount];
+			BufferRange storageBuffers[maxStorageBufferCount];
+
+			State()
+			{
+				for (auto& unit : textures)
+				{
+					for (GLuint& e : unit)
+					{
+						e = unknown;
+					}
+				}
+			}
+		};
+		State state;
+		Statistics current;//݂̃t[̌Ăяo
+		Statistics previous;//Õt[̌Ăяo
+
+		/**
+		* L^ԂƐVԂrAقȂꍇ͋L^XV
+		*
+		* @param cache L^
+		* @param value V
+		*
+		* @retval true  Ԃς(OpenGL̊֐ĂяoKv)
+		* @retval false Ԃ͕ςȂ
+		*/
+		bool Update(GLuint& cache, GLuint value)
+		{
+			if (cache == value)
+			{
+				++current.elided;
+				return false;
+			}
+			cache = value;
+			++current.issued;
+			return true;
+		}
+
+		/**
+		* L^͈͂ƐV͈͂rAقȂꍇ̓obt@͈̔͂oCh
+		*
+		* @param cache  L^͈(nullptrȂL^Ȃ)
+		* @param target obt@̎
+		* @param index  oCfBO|Cg
+		* @param buffer obt@IuWFNgID
+		* @param offset 蓖Ă͈͂̃oCgItZbg
+		* @param size   蓖Ă͈͂̃oCg
+		*/
+		void BindBufferRange(BufferRange* cache, GLenum target,
+			GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+		{
+			if (cache)
+			{
+				if (cache->buffer == buffer && cache->offset == offset && cache->size == size)
+				{
+					++current.elided;
+					return;
+				}
+				cache->buffer = buffer;
+				cache->offset = offset;
+				cache->size = size;
+			}
+			++current.issued;
+			glBindBufferRange(target, index, buffer, offset, size);
+		}
+
+		/**
+		* eNX`̎ނL^p̔ԍɕϊ
+		*
+		* @param target eNX`̎
+		*
+		* @return L^p̔ԍ. L^Ȃނ̏ꍇ-1
+		*/
+		int GetTargetIndex(GLenum target)
+		{
+			switch (target)
+			{
+			case GL_TEXTURE_2D: return 0;
+			case GL_TEXTURE_CUBE_MAP: return 1;
+			case GL_TEXTURE_BUFFER: return 2;
+			default: return -1;
+			}
+		}
+
+		/**
+		* LE؂ւ@\̋L^擾
+		*
+		* @param cap @\̎
+		*
+		* @return L^. L^Ȃ@\̏ꍇnullptr
+		*/
+		GLuint* GetCapability(GLenum cap)
+		{
+			switch (cap)
+			{
+			case GL_BLEND: return &state.blend;
+			case GL_DEPTH_TEST: return &state.depthTest;
+			case GL_CULL_FACE: return &state.cullFace;
+			default: return nullptr;
+			}
+		}
+
+		/**
+		* eNX`C[WjbgI
+		*
+		* @param unit eNX`C[Wjbg̔ԍ
+		*/
+		void ActiveTexture(GLuint unit)
+		{
+			if (Update(state.activeTexture, unit))
+			{
+				glActiveTexture(GL_TEXTURE0 + unit);
+			}
+		}
+
+	} // unnamed namespace
+
+	/**
+	* vOIuWFNggp
+	*
+	* @param program vOIuWFNgID
+	*/
+	void UseProgram(GLuint program)
+	{
+		if (Update(state.program, program))
+		{
+			glUseProgram(program);
+		}
+	}
+
+	/**
+	* VAOoCh
+	*
+	* @param vao VAOID
+	*/
+	void BindVertexArray(GLuint vao)
+	{
+		if (Update(state.vao, vao))
+		{
+			glBindVertexArray(vao);
+		}
+	}
+
+	/**
+	* eNX`oCh
+	*
+	* @param unit    eNX`C[Wjbg̔ԍ
+	* @param target  eNX`̎
+	* @param texture eNX`ID
+	*/
+	void BindTexture(GLuint unit, GLenum target, GLuint texture)
+	{
+		const int targetIndex = GetTargetIndex(target);
+		if (unit >= static_cast<GLuint>(maxTextureUnitCount) || targetIndex < 0)
+		{
+			ActiveTexture(unit);
+			glBindTexture(target, texture);
+			RenderStats::AddTextureBind();
+			++current.issued;
+			return;
+		}
+		if (state.textures[unit][targetIndex] == texture)
+		{
+			++current.elided;
+			return;
+		}
+		ActiveTexture(unit);
+		Update(state.textures[unit][targetIndex], texture);
+		glBindTexture(target, texture);
+		RenderStats::AddTextureBind();
+	}
+
+	/**
+	* t[obt@IuWFNgoCh
+	*
+	* @param fbo t[obt@IuWFNgID(0ȂftHgt[obt@)
+	*/
+	void BindFramebuffer(GLuint fbo)
+	{
+		if (Update(state.fbo, fbo))
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		}
+	}
+
+	/**
+	* @\Lɂ
+	*
+	* @param cap Lɂ@\
+	*/
+	void Enable(GLenum cap)
+	{
+		GLuint* p = GetCapability(cap);
+		if (!p)
+		{
+			glEnable(cap);
+			++current.issued;
+		}
+		else if (Update(*p, GL_TRUE))
+		{
+			glEnable(cap);
+		}
+	}
+
+	/**
+	* @\𖳌ɂ
+	*
+	* @param cap ɂ@\
+	*/
+	void Disable(GLenum cap)
+	{
+		GLuint* p = GetCapability(cap);
+		if (!p)
+		{
+			glDisable(cap);
+			++current.issued;
+		}
+		else if (Update(*p, GL_FALSE))
+		{
+			glDisable(cap);
+		}
+	}
+
+	/**
+	* uhWݒ肷
+	*
+	* @param sfactor `悷FɊ|W
+	* @param dfactor `̐FɊ|W
+	*/
+	void BlendFunc(GLenum sfactor, GLenum dfactor)
+	{
+		if (state.blendSrc == sfactor && state.blendDst == dfactor)
+		{
+			++current.elided;
+			return;
+		}
+		state.blendSrc = sfactor;
+		state.blendDst = dfactor;
+		++current.issued;
+		glBlendFunc(sfactor, dfactor);
+	}
+
+	/**
+	* [xobt@ւ݂̏ݒ肷
+	*
+	* @param flag GL_TRUEȂ珑ށAGL_FALSEȂ珑܂Ȃ
+	*/
+	void DepthMask(GLboolean flag)
+	{
+		if (Update(state.depthMask, flag))
+		{
+			glDepthMask(flag);
+		}
+	}
+
+	/**
+	* UBO͈̔͂oCfBO|CgɊ蓖Ă
+	*
+	* @param index  oCfBO|Cg
+	* @param buffer obt@IuWFNgID
+	* @param offset 蓖Ă͈͂̃oCgItZbg
+	* @param size   蓖Ă͈͂̃oCg
+	*/
+	void BindUniformBuffer(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+	{
+		BufferRange* cache = index < static_cast<GLuint>(maxUniformBufferCount) ?
+			&state.uniformBuffers[index] : nullptr;
+		BindBufferRange(cache, GL_UNIFORM_BUFFER, index, buffer, offset, size);
+	}
+
+	/**
+	* SSBO͈̔͂oCfBO|CgɊ蓖Ă
+	*
+	* @param index  oCfBO|Cg
+	* @param buffer obt@IuWFNgID
+	* @param offset 蓖Ă͈͂̃oCgItZbg
+	* @param size   蓖Ă͈͂̃oCg
+	*/
+	void BindShaderStorageBuffer(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+	{
+		BufferRange* cache = index < static_cast<GLuint>(maxStorageBufferCount) ?
+			&state.storageBuffers[index] : nullptr;
+		BindBufferRange(cache, GL_SHADER_STORAGE_BUFFER, index, buffer, offset, size);
+	}
+
+	/**
+	* vOIuWFNg폜
+	*
+	* @param program vOIuWFNgID
+	*/
+	void DeleteProgram(GLuint program)
+	{
+		if (state.program == program)
+		{
+			UseProgram(0);
+		}
+		glDeleteProgram(program);
+	}
+
+	/**
+	* VAO폜
+	*
+	* @param vao VAOID
+	*/
+	void DeleteVertexArray(GLuint vao)
+	{
+		glDeleteVertexArrays(1, &vao);
+		if (state.vao == vao)
+		{
+			state.vao = 0;
+		}
+	}
+
+	/**
+	* eNX`폜
+	*
+	* @param texture eNX`ID
+	*/
+	void DeleteTexture(GLuint texture)
+	{
+		glDeleteTextures(1, &texture);
+		for (auto& unit : state.textures)
+		{
+			for (GLuint& e : unit)
+			{
+				if (e == texture)
+				{
+					e = 0;
+				}
+			}
+		}
+	}
+
+	/**
+	* t[obt@IuWFNg폜
+	*
+	* @param fbo t[obt@IuWFNgID
+	*/
+	void DeleteFramebuffer(GLuint fbo)
+	{
+		glDeleteFramebuffers(1, &fbo);
+		if (state.fbo == fbo)
+		{
+			state.fbo = 0;
+		}
+	}
+
+	/**
+	* obt@IuWFNg폜
+	*
+	* @param buffer obt@IuWFNgID
+	*/
+	void DeleteBuffer(GLuint buffer)
+	{
+		glDeleteBuffers(1, &buffer);
+		for (BufferRange& e : state.uniformBuffers)
+		{
+			if (e.buffer == buffer)
+			{
+				e.buffer = unknown;
+			}
+		}
+		for (BufferRange& e : state.storageBuffers)
+		{
+			if (e.buffer == buffer)
+			{
+				e.buffer = unknown;
+			}
+		}
+	}
+
+	/**
+	* L^Ԃj
+	*
+	* ̏Ԑݒ͕KOpenGL̊֐Ăяo
+	*/
+	void Invalidate()
+	{
+		state = State();
+	}
+
+	/**
+	* t[̏IɌĂяoāAĂяo񐔂L^
+	*/
+	void EndFrame()
+	{
+		previous = current;
+		current = Statistics();
+	}
+
+	/**
+	* Õt[̌Ăяo񐔂擾
+	*
+	* @return Õt[̌Ăяo
+	*/
+	const Statistics& GetFrameStatistics()
+	{
+		return previous;
+	}
+
+} // namespace GLState
@@ -0,0 +1,52 @@
+/**
+* @file GLState.h
+*/
+#ifndef GLSTATE_H_INCLUDED
+#define GLSTATE_H_INCLUDED
+#include <GL/glew.h>
+#include <cstddef>
+
+/**
+* OpenGL̏ԂL^Aω̂ȂԐݒȗ@\i[閼O
+*
+* vOAVAOAeNX`At[obt@AUBOASSBÕoChƁA
+* uhA[xeXgAJO̐ݒ̖͂OԂ̊֐ʂčs
+* OpenGL̊֐Ăяoꍇ́AInvalidateŋL^jȂ΂ȂȂ
+*/
+namespace GLState
+{
+	/**
+	* Ԑݒ֐̌Ăяo
+	*/
+	struct Statistics
+	{
+		size_t issued = 0;//ۂOpenGL̊֐Ăяo
+		size_t elided = 0;//ԂςȂ̂ŏȗ
+	};
+
+	void UseProgram(GLuint program);
+	void BindVertexArray(GLuint vao);
+	void BindTexture(GLuint unit, GLenum target, GLuint texture);
+	void BindFramebuffer(GLuint fbo);
+	void Enable(GLenum cap);
+	void Disable(GLenum cap);
+	void BlendFunc(GLenum sfactor, GLenum dfactor);
+	void DepthMask(GLboolean flag);
+	void BindUniformBuffer(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+	void BindShaderStorageBuffer(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+	//IuWFNg폜ƁAoChIɉ
+	//L^ƐHȂ悤ɁA폜͈ȉ̊֐ōs
+	void DeleteProgram(GLuint program);
+	void DeleteVertexArray(GLuint vao);
+	void DeleteTexture(GLuint texture);
+	void DeleteFramebuffer(GLuint fbo);
+	void DeleteBuffer(GLuint buffer);
+
+	void Invalidate();
+	void EndFrame();
+	const Statistics& GetFrameStatistics();
+
+} // namespace GLState
+
+#endif // GLSTATE_H_INCLUDED
@@ -1,9 +1,32 @@
 #include "Light.h"
+#include "GLState.h"
+#include <algorithm>
 #include <iostream>
+#include <cstring>
 
 namespace /* unnamed*/
 {
 	const char UniformBlockName[] = "LightUniformBlock";
+
+	/**
+	* lقȂꍇ
+	*
+	* @param dst 
+	* @param src l
+	*
+	* @retval true  lς
+	* @retval false l͕ςȂ
+	*/
+	template<typename T>
+	bool Assign(T& dst, const T& src)
+	{
+		if (std::memcmp(&dst, &src, sizeof(T)) == 0)
+		{
+			return false;
+		}
+		dst = src;
+		return true;
+	}
 }//Unnamed namespace
 
 /*
@@ -13,11 +36,28 @@ namespace /* unnamed*/
 */
 bool LightBuffer::Init(GLuint bindingPoint)
 {
-	ubo[0] = UniformBuffer::Create(sizeof(data), bindingPoint, UniformBlockName);
-	ubo[1] = UniformBuffer::Create(sizeof(data), bindingPoint, UniformBlockName);
-	currentUboIndex = 0;
+	this->bindingPoint = bindingPoint;
+	localLights.clear();
+	dirtyFlags.clear();
+	dirtyCount = 0;
+	isUniformDirty = true;
 
-	return ubo[0] && ubo[1];
+	//ȍ~ɍ쐬VF[_[ɂ͎IɊ蓖Ă
+	Shader::SetUniformBlockBinding(UniformBlockName, bindingPoint);
+	localLights.reserve(maxLocalLightCount);
+	dirtyFlags.reserve(maxLocalLightCount);
+	if (!ubo.Create(GL_UNIFORM_BUFFER, sizeof(data), &data, GL_DYNAMIC_DRAW))
+	{
+		return false;
+	}
+	if (!ssbo.Create(GL_SHADER_STORAGE_BUFFER,
+		sizeof(LocalLight) * maxLocalLightCount, nullptr, GL_DYNAMIC_DRAW))
+	{
+		return false;
+	}
+	//SẴCgςt[ł߂悤ɁAUBOSSBO̍v菭傫Ă
+	return staging.Create(GL_COPY_READ_BUFFER,
+		sizeof(data) + sizeof(LocalLight) * maxLocalLightCount + 256, "LightStagingBuffer");
 }
 
 /**
@@ -37,7 +77,7 @@ bool LightBuffer::BindToShader(const Shader::ProgramPtr& program)
 		std::cerr << "[G[]UniformubN' " << UniformBlockName << "'܂\n";
 		return false;
 	}
-	glUniformBlockBinding(id, blockIndex, ubo[0]->BindingPoint());
+	glUniformBlockBinding(id, blockIndex, bindingPoint);
 	const GLenum result = glGetError();
 	if (result != GL_NO_ERROR)
 	{
@@ -52,61 +92,175 @@ bool LightBuffer::BindToShader(const Shader::ProgramPtr& program)
 *
 * @param al Cg̃AN^[Xg
 * @param ambientColor ̖邳
+*
+* OƒlςCgɂύXtO𗧂Ă
 */
 void LightBuffer::Update(const ActorList& al, const glm::vec3& ambientColor)
 {
-	data.ambientLight.color = glm::vec4(ambientColor, 0);
+	LightUniformBlock block = data;
+	block.ambientLight.color = glm::vec4(ambientColor, 0);
 
-	int pointLightCount = 0;
-	int spotLightCount = 0;
+	size_t count = 0;
+	glm::ivec4 lightCount(0);
 	for (auto i = al.begin(); i != al.end(); i++)
 	{
 		if (DirectionalLightActorPtr p =
 			std::dynamic_pointer_cast<DirectionalLightActor>(*i))
 		{
-			data.directinalLight.color = glm::vec4(p->color, 0);
-			data.directinalLight.direction = glm::vec4(p->direction, 0);
+			block.directinalLight.color = glm::vec4(p->color, 0);
+			block.directinalLight.direction = glm::vec4(p->direction, 0);
 		}
 		else if (PointLightActorPtr p = std::dynamic_pointer_cast<PointLightActor>(*i))
 		{
-			if (pointLightCount < 100)
+			if (count < maxLocalLightCount)
 			{
-				p->index = pointLightCount;
-				PointLight& light = data.pointLight[pointLightCount];
-				light.color = glm::vec4(p->color, 1);
-				light.position = glm::vec4(p->position, 1);
-				++pointLightCount;
+				p->index = static_cast<int>(count);
+				LocalLight light;
+				light.colorAndRange = glm::vec4(p->color, p->range);
+				light.posAndInnerCutOff = glm::vec4(p->position, -1);
+				light.dirAndCutOff = glm::vec4(0, -1, 0, -2);
+				SetLocalLight(count, light);
+				++count;
+				++lightCount.x;
 			}
 		}
 		else if (SpotLightActorPtr p = std::dynamic_pointer_cast<SpotLightActor>(*i))
 		{
-			if (spotLightCount < 100)
+			if (count < maxLocalLightCount)
 			{
-				p->index = spotLightCount;
-				SpotLight& light = data.spotLight[spotLightCount];
-				light.color = glm::vec4(p->color, 1);
-				light.dirAndCutOff = glm::vec4(p->direction, p->cutOff);
+				p->index = static_cast<int>(count);
+				LocalLight light;
+				light.colorAndRange = glm::vec4(p->color, p->range);
 				light.posAndInnerCutOff = glm::vec4(p->position, p->innerCutOff);
-				++spotLightCount;
+				light.dirAndCutOff = glm::vec4(p->direction, p->cutOff);
+				SetLocalLight(count, light);
+				++count;
+				++lightCount.y;
 			}
 		}
 	}
+
+	//Cg͓]Ȃ(NX^QƂȂ̂ŁASSBOɎcĂĂȂ)
+	for (size_t i = count; i < dirtyFlags.size(); ++i)
+	{
+		dirtyCount -= dirtyFlags[i];
+	}
+	localLights.resize(count);
+	dirtyFlags.resize(count);
+
+	lightCount.z = lightCount.x + lightCount.y;
+	block.lightCount = lightCount;
+	isUniformDirty |= Assign(data, block);
+}
+
+/**
+* Cgf[^ݒ肵AlςĂΕύXtO𗧂Ă
+*
+* @param index Cgԍ
+* @param light ݒ肷郉Cgf[^
+*/
+void LightBuffer::SetLocalLight(size_t index, const LocalLight& light)
+{
+	if (index >= localLights.size())
+	{
+		localLights.push_back(light);
+		dirtyFlags.push_back(1);
+		++dirtyCount;
+		return;
+	}
+	if (Assign(localLights[index], light) && !dirtyFlags[index])
+	{
+		dirtyFlags[index] = 1;
+		++dirtyCount;
+	}
 }
 
 /**
-* Cgf[^GPUɓ]
+* NX^̃p[^ݒ肷
+*
+* @param info LightCluster쐬p[^
+*/
+void LightBuffer::SetClusterInfo(const LightClusterInfo& info)
+{
+	isUniformDirty |= Assign(data.cluster, info);
+}
+
+/**
+* ύXꂽCgf[^GPUɓ]
+*
+* ύXꂽCgA͈͂Ƃ1񂸂]
 */
 void LightBuffer::Upload()
 {
-	UniformBufferPtr pUbo = ubo[currentUboIndex];
-	pUbo->BufferSubData(&data, 0, sizeof(data));
-	currentUboIndex = !currentUboIndex;
+	statistics = Statistics();
+	statistics.dirtyLightCount = dirtyCount;
+	if (isUniformDirty)
+	{
+		Write(ubo, 0, sizeof(data), &data);
+		isUniformDirty = false;
+		++statistics.uploadCount;
+		statistics.uploadedBytes += sizeof(data);
+	}
+	if (dirtyCount == 0)
+	{
+		return;
+	}
+	const size_t count = localLights.size();
+	for (size_t first = 0; first < count; )
+	{
+		if (!dirtyFlags[first])
+		{
+			++first;
+			continue;
+		}
+		size_t last = first + 1;
+		while (last < count && dirtyFlags[last])
+		{
+			++last;
+		}
+		const GLsizeiptr size = sizeof(LocalLight) * (last - first);
+		Write(ssbo, sizeof(LocalLight) * first, size, &localLights[first]);
+		std::fill(dirtyFlags.begin() + first, dirtyFlags.begin() + last, 0);
+		++statistics.uploadCount;
+		statistics.uploadedBytes += size;
+		first = last;
+	}
+	dirtyCount = 0;
+}
+
+/**
+* f[^StreamingBufferoRŃobt@ɏ
+*
+* @param buffer ݐ̃obt@
+* @param offset ݐ̃oCgItZbg
+* @param size   ރoCg
+* @param p      ރf[^̃AhX
+*
+* StreamingBufferɏ߂ȂꍇglBufferSubDataŒڏ
+*/
+void LightBuffer::Write(BufferObject& buffer, GLintptr offset, GLsizeiptr size, const void* p)
+{
+	const GLintptr stagingOffset = staging.Push(p, size, 16);
+	if (stagingOffset < 0)
+	{
+		buffer.BufferSubData(offset, size, p);
+		return;
+	}
+	glBindBuffer(GL_COPY_READ_BUFFER, staging.Id());
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.Id());
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, stagingOffset, offset, size);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 }
 
 /**
-* CgpUBOGLReLXgUBOpoCfBO|CgɊ蓖Ă
+* CgpUBOSSBOGLReLXg̃oCfBO|CgɊ蓖Ă
 */
 void LightBuffer::Bind()
 {
-	ubo[!currentUboIndex]->BindBufferRange(0, sizeof(data));
-}
\ No newline at end of file
+	GLState::BindUniformBuffer(bindingPoint, ubo.Id(), 0, sizeof(data));
+
+	//TCY0͈̔͂̓oChłȂ̂ŁACgȂĂ1͈̔͂蓖Ă
+	const GLsizeiptr size = sizeof(LocalLight) * std::max<size_t>(localLights.size(), 1);
+	GLState::BindShaderStorageBuffer(localLightBindingPoint, ssbo.Id(), 0, size);
+}
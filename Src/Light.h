@@ -5,7 +5,8 @@
 #define LIGHT_H_INCLUDED
 #include <GL/glew.h>
 #include "shader.h"
-#include "UniformBuffer.h"
+#include "BufferObject.h"
+#include "StreamingBuffer.h"
 #include "Actor.h"
 #include <glm/glm.hpp>
 #include <vector>
@@ -29,22 +30,25 @@ struct DirectinalLight
 };
 
 /**
-* |CgCg
+* |CgCgƃX|bgCgʂ̃f[^(SSBO̗vf)
+*
+* |CgCg̓JbgItpcos-2ɂāAX|bgCǧvZŏ1ɂȂ悤ɂ
 */
-struct PointLight
+struct LocalLight
 {
-	glm::vec4 color = glm::vec4(1);
-	glm::vec4 position = glm::vec4(0);
+	glm::vec4 colorAndRange = glm::vec4(1, 1, 1, 20);//xyz=F, w=e͈͂̔a
+	glm::vec4 posAndInnerCutOff = glm::vec4(0, 0, 0, -1);//xyz=ʒu, w=̃JbgItpcos
+	glm::vec4 dirAndCutOff = glm::vec4(0, -1, 0, -2);//xyz=, w=ÕJbgItpcos
 };
 
 /**
-* X|bgCg
+* NX^(𕪊)IԂ߂̃p[^
 */
-struct SpotLight
+struct LightClusterInfo
 {
-	glm::vec4 color = glm::vec4(1);
-	glm::vec4 dirAndCutOff = glm::vec4(0, -1, 0, 0.9f);
-	glm::vec4 posAndInnerCutOff = glm::vec4(0, 0, 0, 0.95f);
+	glm::vec4 depthPlane = glm::vec4(0, 0, 0, 1);//[hWr[Ԃ̐[x߂镽
+	glm::vec4 scale = glm::vec4(0);//xy=ʍW^Cԍւ̌W, zw=log([x)XCXԍւ̌WƃoCAX
+	glm::ivec4 count = glm::ivec4(1, 1, 1, 0);//xyz=ẽNX^
 };
 
 /**
@@ -54,8 +58,8 @@ struct LightUniformBlock
 {
 	AmbientLight ambientLight;
 	DirectinalLight directinalLight;
-	PointLight pointLight[100];
-	SpotLight spotLight[100];
+	LightClusterInfo cluster;
+	glm::ivec4 lightCount = glm::ivec4(0);//x=|CgCg̐, y=X|bgCg̐, z=v
 };
 
 
@@ -90,6 +94,7 @@ public:
 public:
 	glm::vec3 color;
 	glm::vec3 direction;
+	float range = 20;//e͈͂̔a([g)
 	int index = -1;
 };
 using PointLightActorPtr = std::shared_ptr<PointLightActor>;
@@ -114,27 +119,68 @@ public:
 	glm::vec3 direction;
 	float cutOff;
 	float innerCutOff;
+	float range = 20;//e͈͂̔a([g)
 	int index = -1;
 };
 using SpotLightActorPtr = std::shared_ptr<SpotLightActor>;
 
 /**
-* UBO𗘗păCgf[^GPUɓ]邽߂̃NX
+* UBOSSBO𗘗păCgf[^GPUɓ]邽߂̃NX
+*
+* AwCgANX^̃p[^UBOɁA
+* |CgCgƃX|bgCgSSBOLocalLightzɊi[
+* ǂ̃CggLightClusterNX^Ƃ̃CgԍŌ܂
+*
+* UpdateőOƒlςCgɕύXtO𗧂āA
+* Uploadł͕ύXꂽCgA͈͂Ƃɓ]
+* ςĂȂΓ]Ȃ
+*
+* ]StreamingBufferɏłAGPUUBOSSBOɃRs[
+* `撆̃obt@glBufferSubDataŏCPUGPU̓N邱Ƃ邪A
+* Rs[̓R}hƂďԂɎŝœ͋NȂ
 */
 class LightBuffer
 {
 public:
+	static const GLuint localLightBindingPoint = 0;//LocalLightzSSBOoCfBO|Cg
+	static const size_t maxLocalLightCount = 4096;//]ł|CgCgƃX|bgCg̍v
+
+	/**
+	* ]̓v
+	*/
+	struct Statistics
+	{
+		size_t dirtyLightCount = 0;//ύXꂽCg̐
+		size_t uploadCount = 0;//]͈͂̐(UBO܂)
+		size_t uploadedBytes = 0;//]oCg
+	};
+
 	LightBuffer() = default;
 	~LightBuffer() = default;
 	bool Init(GLuint bindingPoint);
 	bool BindToShader(const Shader::ProgramPtr& program);
 	void Update(const ActorList& al, const glm::vec3& ambientColor);
+	void SetClusterInfo(const LightClusterInfo& info);
+	const std::vector<LocalLight>& GetLocalLights() const { return localLights; }
+	size_t GetPointLightCount() const { return static_cast<size_t>(data.lightCount.x); }
+	size_t GetSpotLightCount() const { return static_cast<size_t>(data.lightCount.y); }
 	void Upload();
 	void Bind();
+	const Statistics& GetStatistics() const { return statistics; }//ŌUpload̓v
 	
 private:
+	void SetLocalLight(size_t index, const LocalLight& light);
+	void Write(BufferObject& buffer, GLintptr offset, GLsizeiptr size, const void* p);
+
 	LightUniformBlock data;
-	UniformBufferPtr ubo[2];
-	int currentUboIndex = 0;//UBO_uobt@̏ݑCfbNX
+	std::vector<LocalLight> localLights;//SSBOƓт̃Cgf[^
+	std::vector<uint8_t> dirtyFlags;//CgƂ̕ύXtO(1Ȃ]Kv)
+	size_t dirtyCount = 0;//ύXtOĂ郉Cg̐
+	bool isUniformDirty = true;//UBO̓]KvȂtrue
+	BufferObject ubo;
+	BufferObject ssbo;
+	StreamingBuffer staging;//UBOSSBOփRs[f[^̈ꎞu
+	GLuint bindingPoint = 0;//UBO蓖ĂoCfBO|Cg
+	Statistics statistics;
 };
 #endif //LIGHT_H_INCLUDED
\ No newline at end of file
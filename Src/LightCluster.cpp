@@ -0,0 +1,336 @@
+/**
+* @file LightCluster.cpp
+*/
+#include "LightCluster.h"
+#include "GLState.h"
+#include <algorithm>
+#include <cmath>
+
+//SSEgł́A^CE̕ʂ4܂Ƃ߂Ĕ肷
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define LIGHTCLUSTER_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace /* unnamed */
+{
+	/**
+	* ƃ^CE̕ʂ̈ʒu֌W𒲂ׂ
+	*
+	* @param na    ʂ̖@̑1(x܂y)̔z
+	* @param nz    ʂ̖@z̔z
+	* @param count ʂ̐(4̔{)
+	* @param a     ̒S̑1(x܂y)
+	* @param z     ̒Sz
+	* @param r     ̔a
+	* @param front ̈ꕔʂ̕\ɂ镽ʂ̃rbg1ɂȂ
+	* @param back  ̈ꕔʂ̗ɂ镽ʂ̃rbg1ɂȂ
+	*/
+	void TestPlanes(const float* na, const float* nz, int count,
+		float a, float z, float r, uint32_t* front, uint32_t* back)
+	{
+		uint32_t f = 0;
+		uint32_t b = 0;
+#ifdef LIGHTCLUSTER_USE_SSE
+		const __m128 va = _mm_set1_ps(a);
+		const __m128 vz = _mm_set1_ps(z);
+		const __m128 vr = _mm_set1_ps(r);
+		const __m128 vnr = _mm_set1_ps(-r);
+		for (int i = 0; i < count; i += 4)
+		{
+			const __m128 d = _mm_add_ps(
+				_mm_mul_ps(_mm_loadu_ps(na + i), va), _mm_mul_ps(_mm_loadu_ps(nz + i), vz));
+			f |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(d, vnr))) << i;
+			b |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(d, vr))) << i;
+		}
+#else
+		for (int i = 0; i < count; ++i)
+		{
+			const float d = na[i] * a + nz[i] * z;
+			f |= static_cast<uint32_t>(d >= -r) << i;
+			b |= static_cast<uint32_t>(d <= r) << i;
+		}
+#endif
+		*front = f;
+		*back = b;
+	}
+
+	/**
+	* dȂ^C͈̔͂擾
+	*
+	* @param front     TestPlanesŎ擾Äꕔ\ɂ镽ʂ̃rbg
+	* @param back      TestPlanesŎ擾Äꕔɂ镽ʂ̃rbg
+	* @param tileCount ^C̐
+	* @param minTile   ŏ̃^Cԍ̊i[
+	* @param maxTile   Ō̃^Cԍ̊i[
+	*
+	* @retval true  dȂ^C
+	* @retval false ͂ǂ̃^CƂdȂȂ
+	*
+	* ^Ci͕i̕\i+1̗ɂ
+	*/
+	bool GetTileRange(uint32_t front, uint32_t back, int tileCount,
+		int16_t* minTile, int16_t* maxTile)
+	{
+		const uint32_t mask = front & (back >> 1) & ((1u << tileCount) - 1);
+		if (!mask)
+		{
+			return false;
+		}
+		int i = 0;
+		while (!(mask & (1u << i)))
+		{
+			++i;
+		}
+		int j = tileCount - 1;
+		while (!(mask & (1u << j)))
+		{
+			--j;
+		}
+		*minTile = static_cast<int16_t>(i);
+		*maxTile = static_cast<int16_t>(j);
+		return true;
+	}
+
+} // unnamed namespace
+
+/**
+* NX^p̃obt@쐬
+*
+* @retval true  쐬
+* @retval false 쐬s
+*/
+bool LightCluster::Init()
+{
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+	clusters.resize(clusterCount);
+	counts.resize(clusterCount);
+	indices.reserve(maxLightIndexCount);
+	clusterOffset = -1;
+	indexOffset = -1;
+	if (!clusterBuffer.Create(GL_SHADER_STORAGE_BUFFER,
+		sizeof(glm::uvec2) * clusterCount, "LightClusterBuffer"))
+	{
+		return false;
+	}
+	return indexBuffer.Create(GL_SHADER_STORAGE_BUFFER,
+		sizeof(uint32_t) * maxLightIndexCount, "LightIndexBuffer");
+}
+
+/**
+* Cg̉e͈͂͂ދdȂNX^͈̔͂߂
+*
+* @param light   Cg
+* @param matView r[s
+* @param near    ̎O̐[x
+* @param far     ̉̐[x
+* @param range   ͈͂̊i[
+*
+* @retval true  ƏdȂ
+* @retval false ƏdȂȂ
+*/
+bool LightCluster::ComputeRange(const LocalLight& light, const glm::mat4& matView,
+	float near, float far, Range& range) const
+{
+	//X|bgCg͉~͂ދA|CgCg͉e͈͂̋Ŕ肷
+	glm::vec3 center = light.posAndInnerCutOff;
+	float radius = light.colorAndRange.w;
+	const float cosCutOff = light.dirAndCutOff.w;
+	if (cosCutOff > 0)
+	{
+		const glm::vec3 dir = light.dirAndCutOff;
+		if (cosCutOff > 0.7071f)
+		{
+			//Jp45xȂA_ƒʂ̉~ʂ鋅
+			radius = light.colorAndRange.w / (2 * cosCutOff);
+			center += dir * radius;
+		}
+		else
+		{
+			//Jp45xȏȂAʂ̉~ԓƂ鋅
+			center += dir * (light.colorAndRange.w * cosCutOff);
+			radius = light.colorAndRange.w * std::sqrt(1 - cosCutOff * cosCutOff);
+		}
+	}
+	if (radius <= 0)
+	{
+		return false;
+	}
+
+	const glm::vec3 c = matView * glm::vec4(center, 1);
+	const float depth = -c.z;
+	if (depth + radius <= near || depth - radius >= far)
+	{
+		return false;
+	}
+
+	uint32_t front, back;
+	TestPlanes(planeX[0], planeX[1], planeCountX, c.x, c.z, radius, &front, &back);
+	if (!GetTileRange(front, back, tileCountX, &range.minX, &range.maxX))
+	{
+		return false;
+	}
+	TestPlanes(planeY[0], planeY[1], planeCountY, c.y, c.z, radius, &front, &back);
+	if (!GetTileRange(front, back, tileCountY, &range.minY, &range.maxY))
+	{
+		return false;
+	}
+
+	const float minDepth = std::max(depth - radius, near);
+	const float maxDepth = std::min(depth + radius, far);
+	const int minZ = static_cast<int>(std::log(minDepth) * info.scale.z + info.scale.w);
+	const int maxZ = static_cast<int>(std::log(maxDepth) * info.scale.z + info.scale.w);
+	range.minZ = static_cast<int16_t>(std::min(std::max(minZ, 0), sliceCount - 1));
+	range.maxZ = static_cast<int16_t>(std::min(std::max(maxZ, 0), sliceCount - 1));
+	return true;
+}
+
+/**
+* NX^Ƃ̃Cgꗗ쐬
+*
+* @param lights       Cg̔z
+* @param matView      r[s
+* @param matProj      vWFNVs
+* @param near         ̎O̐[x
+* @param far          ̉̐[x
+* @param viewportSize `悷r[|[g̑傫(sNZ)
+*/
+void LightCluster::Build(const std::vector<LocalLight>& lights, const glm::mat4& matView,
+	const glm::mat4& matProj, float near, float far, const glm::ivec2& viewportSize)
+{
+	statistics = Statistics();
+	statistics.lightCount = lights.size();
+
+	//VF[_[NX^IԂ߂̃p[^
+	//r[Ԃ̐[x̓r[s3sڂ̕𔽓]ʂƂ̋
+	const float logRatio = std::log(far / near);
+	info.depthPlane = -glm::vec4(matView[0][2], matView[1][2], matView[2][2], matView[3][2]);
+	info.scale.x = static_cast<float>(tileCountX) / static_cast<float>(std::max(viewportSize.x, 1));
+	info.scale.y = static_cast<float>(tileCountY) / static_cast<float>(std::max(viewportSize.y, 1));
+	info.scale.z = sliceCount / logRatio;
+	info.scale.w = -sliceCount * std::log(near) / logRatio;
+	info.count = glm::ivec4(tileCountX, tileCountY, sliceCount, 0);
+
+	//^CE̕ʂ
+	//NDCxWndc傫_́AP00*x + (P20+ndc)*z > 0𖞂(yl)
+	for (int i = 0; i < planeCountX; ++i)
+	{
+		const float ndc = -1.0f + 2.0f * std::min(i, tileCountX) / tileCountX;
+		const glm::vec2 n = glm::normalize(glm::vec2(matProj[0][0], matProj[2][0] + ndc));
+		planeX[0][i] = n.x;
+		planeX[1][i] = n.y;
+	}
+	for (int i = 0; i < planeCountY; ++i)
+	{
+		const float ndc = -1.0f + 2.0f * std::min(i, tileCountY) / tileCountY;
+		const glm::vec2 n = glm::normalize(glm::vec2(matProj[1][1], matProj[2][1] + ndc));
+		planeY[0][i] = n.x;
+		planeY[1][i] = n.y;
+	}
+
+	//CgƂɃNX^͈̔͂߁ANX^Ƃ̃Cg𐔂
+	std::fill(counts.begin(), counts.end(), 0);
+	ranges.clear();
+	for (size_t i = 0; i < lights.size(); ++i)
+	{
+		Range range;
+		if (!ComputeRange(lights[i], matView, near, far, range))
+		{
+			continue;
+		}
+		range.light = static_cast<uint32_t>(i);
+		ranges.push_back(range);
+		for (int z = range.minZ; z <= range.maxZ; ++z)
+		{
+			for (int y = range.minY; y <= range.maxY; ++y)
+			{
+				uint32_t* p = &counts[(z * tileCountY + y) * tileCountX];
+				for (int x = range.minX; x <= range.maxX; ++x)
+				{
+					++p[x];
+				}
+			}
+		}
+	}
+	statistics.visibleLightCount = ranges.size();
+
+	//CgJnʒu߂(𒴂NX^̓Cg炷)
+	uint32_t offset = 0;
+	for (int i = 0; i < clusterCount; ++i)
+	{
+		statistics.maxClusterLightCount =
+			std::max<size_t>(statistics.maxClusterLightCount, counts[i]);
+		const uint32_t count =
+			std::min(counts[i], static_cast<uint32_t>(maxLightIndexCount) - offset);
+		statistics.droppedIndexCount += counts[i] - count;
+		counts[i] = count;
+		clusters[i] = glm::uvec2(offset, 0);
+		offset += count;
+	}
+	indices.resize(offset);
+
+	//Cgԍ
+	for (const Range& range : ranges)
+	{
+		for (int z = range.minZ; z <= range.maxZ; ++z)
+		{
+			for (int y = range.minY; y <= range.maxY; ++y)
+			{
+				const int first = (z * tileCountY + y) * tileCountX;
+				for (int x = range.minX; x <= range.maxX; ++x)
+				{
+					glm::uvec2& e = clusters[first + x];
+					if (e.y < counts[first + x])
+					{
+						indices[e.x + e.y] = range.light;
+						++e.y;
+					}
+				}
+			}
+		}
+	}
+	statistics.indexCount = indices.size();
+}
+
+/**
+* NX^zƃCgԍzGPUɓ]
+*/
+void LightCluster::Upload()
+{
+	const GLintptr offset = clusterBuffer.Push(clusters.data(),
+		sizeof(glm::uvec2) * clusters.size(), offsetAlignment);
+	if (offset >= 0)
+	{
+		clusterOffset = offset;
+	}
+
+	//TCY0͈̔͂̓oChłȂ̂ŁACgԍȂĂ1͓]
+	if (indices.empty())
+	{
+		indices.push_back(0);
+	}
+	const GLsizeiptr size = sizeof(uint32_t) * indices.size();
+	const GLintptr offsetIndex = indexBuffer.Push(indices.data(), size, offsetAlignment);
+	if (offsetIndex >= 0)
+	{
+		indexOffset = offsetIndex;
+		indexSize = size;
+	}
+}
+
+/**
+* NX^zƃCgԍzGLReLXgSSBOpoCfBO|CgɊ蓖Ă
+*/
+void LightCluster::Bind()
+{
+	if (clusterOffset >= 0)
+	{
+		GLState::BindShaderStorageBuffer(clusterBindingPoint, clusterBuffer.Id(),
+			clusterOffset, sizeof(glm::uvec2) * clusters.size());
+	}
+	if (indexOffset >= 0)
+	{
+		GLState::BindShaderStorageBuffer(indexBindingPoint, indexBuffer.Id(),
+			indexOffset, indexSize);
+	}
+}
@@ -0,0 +1,99 @@
+/**
+* @file LightCluster.h
+*/
+#ifndef LIGHTCLUSTER_H_INCLUDED
+#define LIGHTCLUSTER_H_INCLUDED
+#include <GL/glew.h>
+#include "Light.h"
+#include "StreamingBuffer.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+/**
+* iq̋(NX^)ɕA悲Ƃɉe郉Cg̈ꗗ
+*
+* ʂtileCountX~tileCountỸ^CɁA[xΐԊusliceCount̃XCXɕ
+* Cg̉e͈͂͂ދƃ^CE̕ʂ4܂Ƃ߂Ĕ肵A
+* dȂNX^ɃCgԍǉ
+* NX^Ƃ(Jnʒu, Cg)ƃCgԍ̔zSSBOŃVF[_[ɓn
+* VF[_[gl_FragCoordƐ[xNX^IсÄꗗɂ郉CgvZ
+*
+* g:
+* 1. LightBuffer::UpdateŃCgXVƁABuildŃNX^
+* 2. GetInfo̒lLightBuffer::SetClusterInfoɐݒ肷
+* 3. `̑OUploadBindĂяo
+*/
+class LightCluster
+{
+public:
+	static const int tileCountX = 16;//̃^C
+	static const int tileCountY = 9;//c̃^C
+	static const int sliceCount = 24;//[x̃XCX
+	static const int clusterCount = tileCountX * tileCountY * sliceCount;
+	static const size_t maxLightIndexCount = 128 * 1024;//SNX^̃Cgԍ̍v̏
+	static const GLuint clusterBindingPoint = 1;//NX^zSSBOoCfBO|Cg
+	static const GLuint indexBindingPoint = 2;//CgԍzSSBOoCfBO|Cg
+
+	/**
+	* NX^쐬̓v
+	*/
+	struct Statistics
+	{
+		size_t lightCount = 0;//肵Cg̐
+		size_t visibleLightCount = 0;//ƏdȂ郉Cg̐
+		size_t indexCount = 0;//SNX^̃Cgԍ̍v
+		size_t maxClusterLightCount = 0;//1̃NX^Ɋ܂܂郉Cg̍ő吔
+		size_t droppedIndexCount = 0;//𒴂ߒǉłȂCgԍ̐
+	};
+
+	LightCluster() = default;
+	~LightCluster() = default;
+	LightCluster(const LightCluster&) = delete;
+	LightCluster& operator=(const LightCluster&) = delete;
+
+	bool Init();
+	void Build(const std::vector<LocalLight>& lights, const glm::mat4& matView,
+		const glm::mat4& matProj, float near, float far, const glm::ivec2& viewportSize);
+	void Upload();
+	void Bind();
+
+	const LightClusterInfo& GetInfo() const { return info; }
+	const Statistics& GetStatistics() const { return statistics; }
+
+private:
+	/**
+	* CgdȂNX^͈̔
+	*/
+	struct Range
+	{
+		uint32_t light;//Cgԍ
+		int16_t minX, maxX, minY, maxY, minZ, maxZ;
+	};
+
+	bool ComputeRange(const LocalLight& light, const glm::mat4& matView,
+		float near, float far, Range& range) const;
+
+	//^CE̕ʂ̖@(_ʂ̂ŁAr[ԂxzA܂yzŕ\)
+	//SSE4ǂݍ߂悤ɁAvf4̔{ɂ낦(16oCgE͉肵Ȃ)
+	static const int planeCountX = (tileCountX + 1 + 3) / 4 * 4;
+	static const int planeCountY = (tileCountY + 1 + 3) / 4 * 4;
+	float planeX[2][planeCountX] = {};//[0]=x̌W, [1]=žW
+	float planeY[2][planeCountY] = {};//[0]=y̌W, [1]=žW
+
+	LightClusterInfo info;
+	std::vector<glm::uvec2> clusters;//NX^Ƃ(Cgԍz̊Jnʒu, Cg)
+	std::vector<uint32_t> indices;//Cgԍz
+	std::vector<uint32_t> counts;//Ɨp. NX^Ƃ̃Cg
+	std::vector<Range> ranges;//Ɨp. CgƂ̃NX^͈̔
+	Statistics statistics;
+
+	StreamingBuffer clusterBuffer;
+	StreamingBuffer indexBuffer;
+	GLint offsetAlignment = 1;//SSBÕItZbg̐TCY
+	GLintptr clusterOffset = -1;//Ōɓ]NX^zSSBÖʒu
+	GLintptr indexOffset = -1;//Ōɓ]CgԍzSSBÖʒu
+	GLsizeiptr indexSize = 0;//Ōɓ]Cgԍz̃oCg
+};
+
+#endif // LIGHTCLUSTER_H_INCLUDED
@@ -6,11 +6,33 @@
 #include "StatusScene.h"
 #include "GameOverscene.h"
 #include "Mesh.h"
+#include "GLState.h"
 #include "SkeletalMeshActor.h"
+#include "Profiler.h"
+#include "RenderStats.h"
 #include <iostream>
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+namespace /* unnamed */
+{
+	/**
+	* ~bPʂ̎Ԃ_ȉ2̕ɂ
+	*
+	* @param ms (~b)
+	*
+	* @return Ԃ\
+	*/
+	std::wstring ToMillisecondString(float ms)
+	{
+		const int t = static_cast<int>(ms * 100 + 0.5f);//0.01msP
+		const int fraction = t % 100;
+		return std::to_wstring(t / 100) + (fraction < 10 ? L".0" : L".") +
+			std::to_wstring(fraction) + L"ms";
+	}
+
+} // unnamed namespace
+
 /**
 * Փ˂
 *
@@ -61,7 +83,7 @@ void PlayerCollisionHandler(const ActorPtr& a, const ActorPtr& b, const glm::vec
 */
 bool MainGameScene::Initialize()
 {
-	fontRenderer.Init(1000);
+	fontRenderer.Init(4000);
 	fontRenderer.LoadFromFile("Res/font.fnt");
 	spriteRenderer.Init(1000, "Res/Sprite.vert", "Res/Sprite.frag");
 	sprites.reserve(100);
@@ -69,72 +91,56 @@ bool MainGameScene::Initialize()
 	spr.Scale(glm::vec2(2));
 	sprites.push_back(spr);
 	meshBuffer.Init(1'000'000 * sizeof(Mesh::Vertex), 3'000'000 * sizeof(GLushort));
+	renderQueue.Init(meshBuffer);
 	lightBuffer.Init(1);
 	lightBuffer.BindToShader(meshBuffer.GetStaticMeshShader());
+	lightBuffer.BindToShader(meshBuffer.GetMeshShaders()->Get({ { "INSTANCED", 1 } }));
 	lightBuffer.BindToShader(meshBuffer.GetTerrainShader());
 	lightBuffer.BindToShader(meshBuffer.GetWaterShader());
-	meshBuffer.LoadMesh("Res/red_pine_tree.gltf");
-	meshBuffer.LoadMesh("Res/jizo_statue.gltf");
-	meshBuffer.LoadSkeletalMesh("Res/bikuni.gltf");
-	meshBuffer.LoadSkeletalMesh("Res/oni_small.gltf");
-	meshBuffer.LoadMesh("Res/wall_stone.gltf");
+	lightBuffer.BindToShader(meshBuffer.GetSkeletalMeshShader());
+	lightCluster.Init();
+	Mesh::ImportOption importOption;
+	importOption.quantize = true;
+	{
+		//؂͐̂ŁÂ̂͊ȗLODŕ`悷
+		Mesh::ImportOption treeOption = importOption;
+		treeOption.lodCount = 4;
+		meshBuffer.LoadMesh("Res/red_pine_tree.gltf", treeOption);
+	}
+	meshBuffer.LoadMesh("Res/jizo_statue.gltf", importOption);
+	meshBuffer.LoadSkeletalMesh("Res/bikuni.gltf", importOption);
+	meshBuffer.LoadSkeletalMesh("Res/oni_small.gltf", importOption);
+	meshBuffer.LoadMesh("Res/wall_stone.gltf", importOption);
 
 	//p[eBNVXe
 	particleSystem.Init(1000);
 
-	//FBO쐬
-	const GLFWEW::Window& window = GLFWEW::Window::Instance();
-	fboMain = FramebufferObject::Create(window.Width(), window.Height(), GL_RGBA16F);
+	//ʊE[xGtFNgp̕ʃ|SbV쐬
+	//`FBÓA`̂тɃt[Ot蓖Ă
 	Mesh::FilePtr rt = meshBuffer.AddPlane("RenderTarget");
-
+	dofShaders = Shader::ProgramVariants::Create("Res/DEpthOfField.vert", "Res/DepthOfField.frag");
 	if (rt)
 	{
-		rt->materials[0].program = Shader::Program::Create(
-			"Res/DEpthOfField.vert", "Res/DepthOfField.frag");
-		rt->materials[0].texture[0] = fboMain->GetColorTexture();
-		rt->materials[0].texture[1] = fboMain->GetDepthTexture();
+		rt->materials[0].program = dofShaders->Get();
 	}
 	if (!rt || !rt->materials[0].program)
 	{
 		return false;
 	}
 
-	//DoF`p
-	fboDepthOfField = FramebufferObject::Create(window.Width(), window.Height(), GL_RGBA16F);
-
-	//摜x̏c1/2(ʐς1/4)̑傫̃u[pFBO
-	int w = window.Width();
-	int h = window.Height();
-	for (int j = 0; j < sizeof(fboBloom) / sizeof(fboBloom[0]); j++)
+	//u[GtFNg
+	if (!bloom.Init())
 	{
-		w /= 2;
-		h /= 2;
-		for (int i = 0; i < sizeof(fboBloom[0]) / sizeof(fboBloom[0][0]); i++)
-		{
-			fboBloom[j][i] = FramebufferObject::Create(w, h, GL_RGBA16F,
-				FrameBufferType::colorOnly);
-			if (!fboBloom[j][i])
-			{
-				return false;
-			}
-		}
+		return false;
 	}
 
-	//u[GtFNgp̕ʃ|SbV쐬
-	if (Mesh::FilePtr mesh = meshBuffer.AddPlane("BrightPassFilter"))
-	{
-		Shader::ProgramPtr p = Shader::Program::Create("Res/Simple.vert", "Res/BrightPassFilter.frag");
-		p->Use();
-		p->SetViewProjectionMatrix(glm::mat4(1));
-		mesh->materials[0].program = p;
-	}
-	if (Mesh::FilePtr mesh = meshBuffer.AddPlane("NormalBlur"))
+	//GPUԂ1t[(60fps)Ɏ܂悤ɕ`𑜓xς
+	if (!dynamicResolution.Init(16.0f))
 	{
-		Shader::ProgramPtr p = Shader::Program::Create("Res/Simple.vert", "Res/NormalBlur.frag");
-		p->Use();
-		p->SetViewProjectionMatrix(glm::mat4(1));
-		mesh->materials[0].program = p;
+		return false;
 	}
+
+	//|XgGtFNgp̕ʃ|SbV쐬
 	if (Mesh::FilePtr mesh = meshBuffer.AddPlane("Simple"))
 	{
 		Shader::ProgramPtr p = Shader::Program::Create("Res/Simple.vert", "Res/Simple.frag");
@@ -144,7 +150,7 @@ bool MainGameScene::Initialize()
 	}
 	if (glGetError())
 	{
-		std::cout << "[G[]" << __func__ << ":u[pbV̍쐬Ɏs\n";
+		std::cout << "[G[]" << __func__ << ":|XgGtFNgpbV̍쐬Ɏs\n";
 		return false;
 	}
 
@@ -156,13 +162,29 @@ bool MainGameScene::Initialize()
 		{
 			return false;
 		}
+
+		//Ȃ̂̉e͕`挋ʂۑĂAt[Rs[Ďg
+		shadowCacheSupported = GLEW_VERSION_4_3 || GLEW_ARB_copy_image;
+		if (shadowCacheSupported)
+		{
+			fboShadowStatic = FramebufferObject::Create(
+				4096, 4096, GL_ONE, FrameBufferType::depthOnly);
+			if (glGetError())
+			{
+				return false;
+			}
+		}
+		for (ShadowCascade& e : shadowCascades)
+		{
+			e.cached = false;
+		}
 	}
 
 	//sampler2DShadow̔r[hݒ肷
-	glBindTexture(GL_TEXTURE_2D, fboShadow->GetDepthTexture()->Get());
+	GLState::BindTexture(0, GL_TEXTURE_2D, fboShadow->GetDepthTexture()->Get());
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::BindTexture(0, GL_TEXTURE_2D, 0);
 
 	//nCg}bv쐬
 	if (!heightMap.LoadFromFile("Res/Terrain.tga", 20.0f, 0.5f))
@@ -177,6 +199,7 @@ bool MainGameScene::Initialize()
 	{
 		return false;
 	}
+	terrainOccluders = heightMap.CreateOccluders(4, 8);
 
 	glm::vec3 startPos(100, 0, 100);
 	startPos.y = heightMap.Height(startPos);
@@ -212,7 +235,6 @@ bool MainGameScene::Initialize()
 
 	lights.Update(0);
 	lightBuffer.Update(lights, glm::vec3(0.1f, 0.05f, 0.15f));
-	heightMap.UpdateLightIndex(lights);
 
 	//nlzu
 	{
@@ -376,41 +398,47 @@ void MainGameScene::Update(float deltaTime)
 		camera.target = player->position;
 		camera.position = camera.target + glm::vec3(0, 8, 13);
 	}
-	player->Update(deltaTime);
-	enemies.Update(deltaTime);
-	trees.Update(deltaTime);
-	objects.Update(deltaTime);
-
-	DetectCollision(player, enemies);
-	DetectCollision(player, trees);
-	DetectCollision(player, objects);
+	{
+		PROFILE_SCOPE("ActorUpdate");
+		player->Update(deltaTime);
+		enemies.Update(deltaTime);
+		trees.Update(deltaTime);
+		objects.Update(deltaTime);
+	}
 
-	//vC[̍U
-	ActorPtr AttackCollision = player->GetAttackCollision();
-	if (AttackCollision)
 	{
-		bool hit = false;
-		DetectCollision(AttackCollision, enemies,
-			[this, &hit](const ActorPtr& a, const ActorPtr& b, const glm::vec3& p)
+		PROFILE_SCOPE("Collision");
+		DetectCollision(player, enemies);
+		DetectCollision(player, trees);
+		DetectCollision(player, objects);
+
+		//vC[̍U
+		ActorPtr AttackCollision = player->GetAttackCollision();
+		if (AttackCollision)
 		{
-			SkeletalMeshActorPtr bb = std::static_pointer_cast<SkeletalMeshActor>(b);
-			bb->health -= a->health;
-			if (bb->health <= 0)
+			bool hit = false;
+			DetectCollision(AttackCollision, enemies,
+				[this, &hit](const ActorPtr& a, const ActorPtr& b, const glm::vec3& p)
 			{
-				bb->colLocal = Collision::Shape{};
-				bb->health = 1;
-				bb->GetMesh()->Play("Down", false);
+				SkeletalMeshActorPtr bb = std::static_pointer_cast<SkeletalMeshActor>(b);
+				bb->health -= a->health;
+				if (bb->health <= 0)
+				{
+					bb->colLocal = Collision::Shape{};
+					bb->health = 1;
+					bb->GetMesh()->Play("Down", false);
+				}
+				else
+				{
+					bb->GetMesh()->Play("Hit", false);
+				}
+				hit = true;
 			}
-			else
+			);
+			if (hit)
 			{
-				bb->GetMesh()->Play("Hit", false);
+				AttackCollision->health = 0;
 			}
-			hit = true;
-		}
-		);
-		if (hit)
-		{
-			AttackCollision->health = 0;
 		}
 	}
 
@@ -433,38 +461,16 @@ void MainGameScene::Update(float deltaTime)
 	}
 
 	//Cg̍XV
-	glm::vec3 ambientColor(0.1f, 0.05f, 0.15f);
-	lightBuffer.Update(lights, ambientColor);
-	for (auto e : trees)
-	{
-		const std::vector<ActorPtr> neighborhood = lights.FindNearbyActors(e->position, 20);
-		std::vector<int> pointLightIndex;
-		std::vector<int> spotLghtIndex;
-		pointLightIndex.reserve(neighborhood.size());
-		spotLghtIndex.reserve(neighborhood.size());
-		for (auto light : neighborhood)
-		{
-			if (PointLightActorPtr p = std::dynamic_pointer_cast<PointLightActor>(light))
-			{
-				if (pointLightIndex.size() < 8)
-				{
-					pointLightIndex.push_back(p->index);
-				}
-			}
-			else if (SpotLightActorPtr p = std::dynamic_pointer_cast<SpotLightActor>(light))
-			{
-				if (spotLghtIndex.size() < 8)
-				{
-					spotLghtIndex.push_back(p->index);
-				}
-			}
-		}
-		StaticMeshActorPtr p = std::static_pointer_cast<StaticMeshActor>(e);
-		p->SetPointLightList(pointLightIndex);
-		p->SetSpotLightList(spotLghtIndex);
+	{
+		PROFILE_SCOPE("Lights");
+		glm::vec3 ambientColor(0.1f, 0.05f, 0.15f);
+		lightBuffer.Update(lights, ambientColor);
 	}
 
-	particleSystem.Update(deltaTime);
+	{
+		PROFILE_SCOPE("Particles");
+		particleSystem.Update(deltaTime);
+	}
 
 	//GSłړIBtOtrueɂ
 	if (jizoId >= 0)
@@ -476,17 +482,111 @@ void MainGameScene::Update(float deltaTime)
 		}
 	}
 
-	player->UpdateDrawData(deltaTime);
-	enemies.UpdateDrawData(deltaTime);
-	trees.UpdateDrawData(deltaTime);
-	objects.UpdateDrawData(deltaTime);
-	lights.Update(deltaTime);
+	{
+		PROFILE_SCOPE("Skinning");
+		player->UpdateDrawData(deltaTime);
+		enemies.UpdateDrawData(deltaTime);
+		trees.UpdateDrawData(deltaTime);
+		objects.UpdateDrawData(deltaTime);
+		lights.Update(deltaTime);
+	}
+
+	//wbhX[hł͕`悵Ȃ̂ŁAʕ\p͍̕Ȃ
+	if (window.IsHeadless())
+	{
+		return;
+	}
 
 	const float w = window.Width();
 	const float h = window.Height();
 	const float lineHeight = fontRenderer.LineHeight();
 	fontRenderer.BeginUpdate();
 	fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lineHeight), L"CQ[");
+
+	//Õt[̎JǑʂ\
+	const Mesh::CullingStatistics& cullColor = Mesh::GetCullingStatistics(Mesh::DrawType::color);
+	const Mesh::CullingStatistics& cullShadow = Mesh::GetCullingStatistics(Mesh::DrawType::shadow);
+	const std::wstring cullingText =
+		L"Draw:" + std::to_wstring(cullColor.drawn) + L" Cull:" + std::to_wstring(cullColor.culled) +
+		L" ShadowDraw:" + std::to_wstring(cullShadow.drawn) +
+		L" ShadowCull:" + std::to_wstring(cullShadow.culled) +
+		L" ShadowStatic:" + std::to_wstring(shadowStaticRenderCount) + L"/" +
+		std::to_wstring(Mesh::shadowCascadeCount);
+	const OcclusionCuller::Statistics& occlusionStats = occlusionCuller.GetStatistics();
+	const size_t occludedPercent = occlusionStats.testedCount ?
+		occlusionStats.occludedCount * 100 / occlusionStats.testedCount : 0;
+	const std::wstring occlusionText =
+		L" Occluded:" + std::to_wstring(occlusionStats.occludedCount) + L"/" +
+		std::to_wstring(occlusionStats.testedCount) + L"(" + std::to_wstring(occludedPercent) + L"%)";
+	fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lineHeight * 2),
+		(cullingText + occlusionText).c_str());
+	const GLState::Statistics& glStats = GLState::GetFrameStatistics();
+	const std::wstring glStateText =
+		L"GLState Issued:" + std::to_wstring(glStats.issued) +
+		L" Elided:" + std::to_wstring(glStats.elided) +
+		L" BloomPass:" + std::to_wstring(bloom.GetPassCount());
+	fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lineHeight * 3), glStateText.c_str());
+	const Mesh::RenderQueue::Statistics& queueStats = renderQueue.GetStatistics();
+	const std::wstring queueText =
+		L"DrawCall:" + std::to_wstring(queueStats.drawCalls) +
+		L" Indirect:" + std::to_wstring(queueStats.indirectDrawCalls) +
+		L" Commands:" + std::to_wstring(queueStats.commands) +
+		L" Instances:" + std::to_wstring(queueStats.instances) +
+		(renderQueue.IsMultiDrawIndirectEnabled() ? L" MDI" : L" CPU");
+	fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lineHeight * 4), queueText.c_str());
+	const FrameGraph::Statistics& graphStats = frameGraph.GetStatistics();
+	const std::wstring graphText =
+		L"Pass:" + std::to_wstring(graphStats.passCount - graphStats.culledPassCount) +
+		L" Culled:" + std::to_wstring(graphStats.culledPassCount) +
+		L" RT:" + std::to_wstring(graphStats.transientCount) +
+		L" FBO:" + std::to_wstring(graphStats.pooledTargetCount) +
+		L" DoF:1/" + std::to_wstring(camera.GetDepthOfFieldDownscale()) +
+		L" VRAM:" + std::to_wstring(graphStats.peakBytes / (1024 * 1024)) + L"MB/" +
+		std::to_wstring(graphStats.unaliasedBytes / (1024 * 1024)) + L"MB";
+	fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lineHeight * 5), graphText.c_str());
+	const int resolutionPercent = static_cast<int>(dynamicResolution.GetScale() * 100 + 0.5f);
+	const int gpuTime = static_cast<int>(dynamicResolution.GetAverageTime() * 10 + 0.5f);//0.1msP
+	const std::wstring resolutionText =
+		L"Resolution:" + std::to_wstring(resolutionPercent) + L"%" +
+		L" GPU:" + std::to_wstring(gpuTime / 10) + L"." + std::to_wstring(gpuTime % 10) + L"ms";
+	fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lineHeight * 6), resolutionText.c_str());
+	const LightCluster::Statistics& clusterStats = lightCluster.GetStatistics();
+	const std::wstring clusterText =
+		L"Lights:" + std::to_wstring(clusterStats.visibleLightCount) + L"/" +
+		std::to_wstring(clusterStats.lightCount) +
+		L" Index:" + std::to_wstring(clusterStats.indexCount) +
+		L" MaxPerCluster:" + std::to_wstring(clusterStats.maxClusterLightCount) +
+		L" Upload:" + std::to_wstring(lightBuffer.GetStatistics().uploadedBytes) + L"B";
+	fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lineHeight * 7), clusterText.c_str());
+
+	//߂̃t[̕`施߂̐̕ςƍő\
+	const RenderStats::Summary renderStats = RenderStats::GetSummary();
+	const std::wstring renderStatsText =
+		L"Avg/Max Draw:" + std::to_wstring(renderStats.average.drawCalls) + L"/" +
+		std::to_wstring(renderStats.max.drawCalls) +
+		L" Tri:" + std::to_wstring(renderStats.average.triangles) + L"/" +
+		std::to_wstring(renderStats.max.triangles) +
+		L" State:" + std::to_wstring(renderStats.average.stateChanges) +
+		L" Tex:" + std::to_wstring(renderStats.average.textureBinds) +
+		L" Upload:" + std::to_wstring(renderStats.average.uploadCount) + L"(" +
+		std::to_wstring(renderStats.average.uploadedBytes / 1024) + L"KB)";
+	fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lineHeight * 8), renderStatsText.c_str());
+
+	//ԂƂ̏Ԃ̕ς\(q̐[ɉĎ)
+	float profileLine = 9;
+	for (const Profiler::SummaryItem& e : Profiler::GetSummary())
+	{
+		std::wstring profileText(e.depth * 2, L' ');
+		profileText.append(e.name.begin(), e.name.end());
+		profileText += L" CPU:" + ToMillisecondString(e.cpuTime);
+		if (e.hasGpuTime)
+		{
+			profileText += L" GPU:" + ToMillisecondString(e.gpuTime);
+		}
+		fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lineHeight * profileLine),
+			profileText.c_str());
+		++profileLine;
+	}
 	fontRenderer.EndUpdate();
 }
 
@@ -496,198 +596,407 @@ void MainGameScene::Update(float deltaTime)
 void MainGameScene::Render()
 {
 	const GLFWEW::Window& window = GLFWEW::Window::Instance();
+	Mesh::ResetCullingStatistics();
 
-	//epFBOɕ`
-	{
-		glBindFramebuffer(GL_FRAMEBUFFER, fboShadow->GetFramebuffer());
-		auto tex = fboShadow->GetDepthTexture();
-		glViewport(0, 0, tex->Width(), tex->Height());
-		glClear(GL_DEPTH_BUFFER_BIT);
-		glEnable(GL_DEPTH_TEST);
-		glEnable(GL_CULL_FACE);
-		glDisable(GL_BLEND);
-
-		//fBNViCǧep̃r[Wñr[s쐬
-		//_́AJ̒_烉Cg100mړʒuɐݒ肷
-		glm::vec3 direction(0, -1, 0);
-		for (auto e : lights)
-		{
-			if (auto p = std::dynamic_pointer_cast<DirectionalLightActor>(e))
-			{
-				direction = p->direction;
-				break;
-			}
-		}
-		const glm::vec3 position = camera.target - direction * 100.0f;
-		const glm::mat4 matView =
-			glm::lookAt(position, camera.target, glm::vec3(0, 1, 0));
-
-		//seɂvWFNVs쐬
-		const float width = 100;//`͈͂̕
-		const float height = 100;//`͈͂̍
-		const float near = 10.0f;//`͈͂̎ŐE
-		const float far = 200.0f;//`͈͂̉̋E
-		const glm::mat4 matProj =
-			glm::ortho<float>(-width / 2, width / 2, -height / 2, height / 2, near, far);
-
-		//r[vWFNVsݒ肵ăbV`
-		meshBuffer.SetShadowViewProjectionMatrix(matProj * matView);
-		RenderMesh(Mesh::DrawType::shadow);
-	}
-
-	glBindFramebuffer(GL_FRAMEBUFFER, fboMain->GetFramebuffer());
-	const auto texMain = fboMain->GetColorTexture();
-	glViewport(0, 0, texMain->Width(), texMain->Height());
-	const glm::vec2 screenSize(window.Width(), window.Height());
-	spriteRenderer.Draw(screenSize);
-	fontRenderer.Draw(screenSize);
-
-	glEnable(GL_DEPTH_TEST);
-
-	lightBuffer.Upload();
-	lightBuffer.Bind();
-
-	//FBOɕ`
-	glClearColor(0.5f, 0.6f, 0.8f, 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_CULL_FACE);
-	glEnable(GL_BLEND);
+	//3Df͕`̍̈ꕔɕ`悵AʊE[xGtFNgŉʑŜɊg傷
+	const glm::ivec2 viewportSize =
+		dynamicResolution.GetViewportSize(window.Width(), window.Height());
+	const glm::vec2 sourceScale =
+		glm::vec2(viewportSize) / glm::vec2(window.Width(), window.Height());
 
+	const glm::vec2 screenSize(window.Width(), window.Height());
 	const glm::mat4 matView = glm::lookAt(camera.position, camera.target, camera.up);
 	const float aspectRatio =
 		static_cast<float>(window.Width()) / static_cast<float>(window.Height());
 	const glm::mat4 matProj =
 		glm::perspective(camera.fov * 0.5f, aspectRatio,camera.near,camera.far);
-	meshBuffer.SetViewProjectionMatrix(matProj * matView);
-	meshBuffer.SetCameraPosition(camera.position);
-	meshBuffer.SetTime(window.Time());
-	meshBuffer.BindShadowTexture(fboShadow->GetDepthTexture());
 
-	RenderMesh(Mesh::DrawType::color);
-	particleSystem.Draw(matProj, matView);
+	//Օ`悵āABĂ؂G`悵Ȃ悤ɂ
+	{
+		PROFILE_SCOPE("Occluders");
+		RenderOccluders(matProj * matView);
+	}
 
-	meshBuffer.UnbindShadowTexture();
+	//̋悲ƂɁAe|CgCgƃX|bgCg̈ꗗ
+	{
+		PROFILE_SCOPE("LightCluster");
+		lightCluster.Build(lightBuffer.GetLocalLights(), matView, matProj,
+			camera.near, camera.far, viewportSize);
+		lightBuffer.SetClusterInfo(lightCluster.GetInfo());
+	}
 
+	//`pXgݗĂ
+	//t[܂ŎgepFBOƉʈȊO̕`́At[Ot蓖Ă
+	frameGraph.Clear();
+	const FrameGraph::ResourceId rtShadow = frameGraph.Import("Shadow", fboShadow,
+		fboShadow->GetDepthTexture()->Width(), fboShadow->GetDepthTexture()->Height());
+	const FrameGraph::ResourceId rtScreen =
+		frameGraph.Import("Screen", nullptr, window.Width(), window.Height());
 
-	//ʊE[xGtFNg
+	//epFBOɕ`
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, fboDepthOfField->GetFramebuffer());
-		const auto tex = fboDepthOfField->GetColorTexture();
-		glViewport(0, 0, tex->Width(), tex->Height());
-		
-		glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		glDisable(GL_DEPTH_TEST);
-		glDisable(GL_CULL_FACE);
-		glDisable(GL_BLEND);
+		FrameGraph::PassBuilder pass = frameGraph.AddPass("Shadow");
+		pass.Write(rtShadow);
+		pass.SetExecuteFunc([this](const FrameGraph&) { RenderShadow(); });
+	}
 
-		camera.Update(matView);
+	//3Df`
+	FrameGraph::ResourceId rtMain = FrameGraph::invalidId;
+	{
+		FrameGraph::PassBuilder pass = frameGraph.AddPass("Main");
+		pass.Read(rtShadow);
+		FrameGraph::RenderTargetDesc desc;
+		desc.width = window.Width();
+		desc.height = window.Height();
+		desc.internalFormat = GL_RGBA16F;
+		desc.type = FrameBufferType::colorAndDepth;
+		rtMain = pass.CreateRenderTarget("Main", desc);
+		pass.SetExecuteFunc([this, &window, rtMain, screenSize, viewportSize, matView, matProj](
+			const FrameGraph& g) {
+			g.BindRenderTarget(rtMain);
+			spriteRenderer.Draw(screenSize);
+			fontRenderer.Draw(screenSize);
+			glViewport(0, 0, viewportSize.x, viewportSize.y);
+
+			GLState::Enable(GL_DEPTH_TEST);
+
+			lightBuffer.Upload();
+			lightBuffer.Bind();
+			lightCluster.Upload();
+			lightCluster.Bind();
+
+			//FBOɕ`
+			glClearColor(0.5f, 0.6f, 0.8f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			GLState::Enable(GL_DEPTH_TEST);
+			GLState::Enable(GL_CULL_FACE);
+			GLState::Enable(GL_BLEND);
+
+			meshBuffer.SetViewProjectionMatrix(matProj * matView);
+			meshBuffer.SetCameraPosition(camera.position);
+			Mesh::SetLodView(camera.position, camera.fov * 0.5f, static_cast<float>(viewportSize.y));
+			meshBuffer.SetTime(window.Time());
+			meshBuffer.BindShadowTexture(fboShadow->GetDepthTexture());
+
+			Mesh::EnableCulling(Collision::CreateFrustum(matProj * matView));
+			RenderMesh(Mesh::DrawType::color, matView);
+			Mesh::DisableCulling();
+			particleSystem.Draw(matProj, matView);
+
+			meshBuffer.UnbindShadowTexture();
+		});
+	}
 
-		Mesh::FilePtr mesh = meshBuffer.GetFile("RenderTarget");
-		Shader::ProgramPtr prog = mesh->materials[0].program;
-		prog->Use();
-		prog->SetViewInfo(static_cast<float>(window.Width()),
-			static_cast<float>(window.Height()), camera.near, camera.far);
-		prog->SetCameraInfo(camera.focalPlane, camera.focalLength,
-			camera.aperture, camera.sensorSize);
-		Mesh::Draw(mesh, glm::mat4(1));
+	//ʊE[xGtFNg
+	//k𑜓x̏ꍇ́Ak`łڂĂ猳̉𑜓xɊg升
+	camera.Update(matView);
+	FrameGraph::ResourceId rtDepthOfField = FrameGraph::invalidId;
+	{
+		FrameGraph::RenderTargetDesc desc = frameGraph.GetDesc(rtMain);
+		desc.type = FrameBufferType::colorOnly;
+		FrameGraph::ResourceId rtGather = FrameGraph::invalidId;
+		const int downscale = camera.GetDepthOfFieldDownscale();
+		if (downscale > 1)
+		{
+			FrameGraph::PassBuilder pass = frameGraph.AddPass("DepthOfFieldGather");
+			pass.Read(rtMain);
+			FrameGraph::RenderTargetDesc gatherDesc = desc;
+			gatherDesc.width = std::max(1, desc.width / downscale);
+			gatherDesc.height = std::max(1, desc.height / downscale);
+			rtGather = pass.CreateRenderTarget("DepthOfFieldGather", gatherDesc);
+			pass.SetExecuteFunc([this, rtMain, rtGather, sourceScale](const FrameGraph& g) {
+				RenderDepthOfField(g, dofShaders->Get({ { "GATHER_PASS", 1 } }),
+					rtGather, rtMain, FrameGraph::invalidId, sourceScale);
+			});
+		}
 
-		fontRenderer.Draw(screenSize);
+		FrameGraph::PassBuilder pass = frameGraph.AddPass("DepthOfField");
+		pass.Read(rtMain);
+		if (rtGather != FrameGraph::invalidId)
+		{
+			pass.Read(rtGather);
+		}
+		rtDepthOfField = pass.CreateRenderTarget("DepthOfField", desc);
+		pass.SetExecuteFunc([this, rtMain, rtGather, rtDepthOfField, screenSize, sourceScale](
+			const FrameGraph& g) {
+			const Shader::ProgramPtr& prog = (rtGather != FrameGraph::invalidId) ?
+				dofShaders->Get({ { "UPSAMPLE_PASS", 1 } }) : dofShaders->Get();
+			RenderDepthOfField(g, prog, rtDepthOfField, rtMain, rtGather, sourceScale);
+			fontRenderer.Draw(screenSize);
+		});
 	}
 
-
 	//u[GtFNg
+	const FrameGraph::ResourceId rtBloom = bloom.AddPasses(frameGraph, rtDepthOfField);
+
+	//SẴftHgt[obt@ɍ`悷
 	{
-		//邢o
+		FrameGraph::PassBuilder pass = frameGraph.AddPass("Composite");
+		pass.Read(rtDepthOfField);
+		if (rtBloom != FrameGraph::invalidId)
 		{
-			auto tex = fboBloom[0][0]->GetColorTexture();
-			glBindFramebuffer(GL_FRAMEBUFFER, fboBloom[0][0]->GetFramebuffer());
-			glViewport(0, 0, tex->Width(), tex->Height());
-			glClear(GL_COLOR_BUFFER_BIT);
-			Mesh::FilePtr mesh = meshBuffer.GetFile("BrightPassFilter");
-			mesh->materials[0].texture[0] = fboDepthOfField->GetColorTexture();
-			Mesh::Draw(mesh, glm::mat4(1));
+			pass.Read(rtBloom);
 		}
-
-		//kRs[
-		Mesh::FilePtr simpleMesh = meshBuffer.GetFile("Simple");
-		for (int i = 0; i < sizeof(fboBloom) / sizeof(fboBloom[0]) - 1; i++)
-		{
-			auto tex = fboBloom[i + 1][0]->GetColorTexture();
-			glBindFramebuffer(GL_FRAMEBUFFER, fboBloom[i + 1][0]->GetFramebuffer());
-			glViewport(0, 0, tex->Width(), tex->Height());
-			glClear(GL_COLOR_BUFFER_BIT);
-			simpleMesh->materials[0].texture[0] = fboBloom[i][0]->GetColorTexture();
+		pass.Write(rtScreen);
+		pass.SetExecuteFunc([this, rtScreen, rtDepthOfField, rtBloom, screenSize](
+			const FrameGraph& g) {
+			g.BindRenderTarget(rtScreen);
+			spriteRenderer.Draw(screenSize);
+
+			//ʊE[xGtFNgKp̉摜`
+			GLState::Disable(GL_DEPTH_TEST);
+			GLState::Disable(GL_CULL_FACE);
+			GLState::Disable(GL_BLEND);
+			Mesh::FilePtr simpleMesh = meshBuffer.GetFile("Simple");
+			simpleMesh->materials[0].texture[0] = g.GetColorTexture(rtDepthOfField);
 			Mesh::Draw(simpleMesh, glm::mat4(1));
-		}
 
-		//KEXڂ
-		Mesh::FilePtr blurMesh = meshBuffer.GetFile("NormalBlur");
-		Shader::ProgramPtr progBlur = blurMesh->materials[0].program;
-		for (int i = sizeof(fboBloom) / sizeof(fboBloom[0]) - 1; i >= 0; i--)
+			//gU`
+			if (rtBloom != FrameGraph::invalidId)
+			{
+				GLState::Enable(GL_BLEND);
+				GLState::BlendFunc(GL_ONE, GL_ONE);
+				simpleMesh->materials[0].texture[0] = g.GetColorTexture(rtBloom);
+				Mesh::Draw(simpleMesh, glm::mat4(1));
+			}
+#if 0
+			//fobÔ߂ɁAep̐[xeNX`\
+			{
+				GLState::Disable(GL_BLEND);
+				simpleMesh->materials[0].texture[0] = fboShadow->GetDepthTexture();
+				glm::mat4 m = glm::scale(glm::translate(
+					glm::mat4(1), glm::vec3(-0.45f, 0, 0)), glm::vec3(0.5f, 0.89f, 1));
+				Mesh::Draw(simpleMesh, m);
+			}
+#endif
+		});
+	}
+	frameGraph.SetOutput(rtScreen);
+
+	//KvȃpXs
+	//GPUԂ̌vɃJOȂǂCPȖ҂Ԃ܂܂Ȃ悤ɁAs̒Ov
+	dynamicResolution.BeginFrame();
+	if (frameGraph.Compile())
+	{
+		frameGraph.Execute();
+	}
+	dynamicResolution.EndFrame();
+}
+
+/**
+* ep̐[xeNX``悷
+*
+* ŕAꂼ͂ޔ͈͂JXP[hƂ2x2ɕepFBOɕ`悷
+* eJXP[h̕`͈͂̓CgԂ̊iqɍ킹ē̂ŁAJĂ
+* `͈͕͂ςȂ. ͈͂ƃCǧOƓȂAۑĂ
+* Ȃ̂̉eRs[āÂ`悷
+*/
+void MainGameScene::RenderShadow()
+{
+	const GLFWEW::Window& window = GLFWEW::Window::Instance();
+	const int tileSize = fboShadow->GetDepthTexture()->Width() / 2;//1JXP[h̕ƍ
+	const float casterDistance = 100.0f;//`͈͂胉Cgɂ镨̂̉e܂߂鋗
+	const float maxShadowDistance = 200.0f;//e`悷ő勗
+
+	//fBNViCǧ烉CgԂ̉]쐬
+	glm::vec3 direction(0, -1, 0);
+	for (auto e : lights)
+	{
+		if (auto p = std::dynamic_pointer_cast<DirectionalLightActor>(e))
 		{
-			auto tex = fboBloom[i][0]->GetColorTexture();
-			glBindFramebuffer(GL_FRAMEBUFFER, fboBloom[i][1]->GetFramebuffer());
-			glViewport(0, 0, tex->Width(), tex->Height());
-			glClear(GL_COLOR_BUFFER_BIT);
-			progBlur->Use();
-			progBlur->SetBlurDirection(1.0f / static_cast<float>(tex->Width()), 0.0f);
-			blurMesh->materials[0].texture[0] = fboBloom[i][0]->GetColorTexture();
-			Mesh::Draw(blurMesh, glm::mat4(1));
-
-			glBindFramebuffer(GL_FRAMEBUFFER, fboBloom[i][0]->GetFramebuffer());
-			glClear(GL_COLOR_BUFFER_BIT);
-			progBlur->Use();
-			progBlur->SetBlurDirection(0.0f, 1.0f / static_cast<float>(tex->Height()));
-			blurMesh->materials[0].texture[0] = fboBloom[i][1]->GetColorTexture();
-			Mesh::Draw(blurMesh, glm::mat4(1));
+			direction = p->direction;
+			break;
 		}
-		//g&Z
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_ONE, GL_ONE);
-		for (int i = sizeof(fboBloom) / sizeof(fboBloom[0]) - 1; i > 0; i--)
+	}
+	direction = glm::normalize(direction);
+	const glm::vec3 upHint = std::abs(direction.y) > 0.99f ? glm::vec3(0, 0, 1) : glm::vec3(0, 1, 0);
+	const glm::mat4 matLightRotation = glm::lookAt(glm::vec3(0), direction, upHint);
+	if (direction != shadowLightDirection)
+	{
+		shadowLightDirection = direction;
+		for (ShadowCascade& e : shadowCascades)
 		{
-			auto tex = fboBloom[i - 1][0]->GetColorTexture();
-			glBindFramebuffer(GL_FRAMEBUFFER, fboBloom[i - 1][0]->GetFramebuffer());
-			glViewport(0, 0, tex->Width(), tex->Height());
-			simpleMesh->materials[0].texture[0] = fboBloom[i][0]->GetColorTexture();
-			Mesh::Draw(simpleMesh, glm::mat4(1));
+			e.cached = false;
 		}
 	}
 
-	//SẴftHgt[obt@ɍ`悷
-	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		glViewport(0, 0, window.Width(), window.Height());
+	//J̍Wn(`ɎgvWFNVsƓpg)
+	const glm::vec3 front = glm::normalize(camera.target - camera.position);
+	const glm::vec3 right = glm::normalize(glm::cross(front, camera.up));
+	const glm::vec3 up = glm::cross(right, front);
+	const float aspectRatio =
+		static_cast<float>(window.Width()) / static_cast<float>(window.Height());
+	const float tanHalfFovY = std::tan(camera.fov * 0.25f);
+	const float shadowDistance = std::min(camera.far, maxShadowDistance);
 
-		const glm::vec2 screenSize(window.Width(), window.Height());
-		spriteRenderer.Draw(screenSize);
+	GLState::Enable(GL_DEPTH_TEST);
+	GLState::Enable(GL_CULL_FACE);
+	GLState::Disable(GL_BLEND);
+	GLState::DepthMask(GL_TRUE);
 
-		//ʊE[xGtFNgKp̉摜`
-		glDisable(GL_BLEND);
-		Mesh::FilePtr simpleMesh = meshBuffer.GetFile("Simple");
-		simpleMesh->materials[0].texture[0] = fboDepthOfField->GetColorTexture();
-		Mesh::Draw(simpleMesh, glm::mat4(1));
+	glm::mat4 matShadowTexture[Mesh::shadowCascadeCount];
+	shadowStaticRenderCount = 0;
+	for (int i = 0; i < Mesh::shadowCascadeCount; ++i)
+	{
+		//ʒu͓ԊuƑΐ̒Ԃɂ(OقǋȂ)
+		float sliceNear = camera.near;
+		float sliceFar = shadowDistance;
+		for (int k = 0; k < 2; ++k)
+		{
+			const float t = static_cast<float>(i + k) / Mesh::shadowCascadeCount;
+			const float uniformSplit = camera.near + (shadowDistance - camera.near) * t;
+			const float logSplit = camera.near * std::pow(shadowDistance / camera.near, t);
+			(k ? sliceFar : sliceNear) = glm::mix(uniformSplit, logSplit, 0.75f);
+		}
 
-		//gU`
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_ONE, GL_ONE);
-		simpleMesh->materials[0].texture[0] = fboBloom[0][0]->GetColorTexture();
-		Mesh::Draw(simpleMesh, glm::mat4(1));
+		//̈ꕔ͂ދ߂
+		glm::vec3 corners[8];
+		glm::vec3 center(0);
+		for (int k = 0; k < 8; ++k)
+		{
+			const float d = (k < 4) ? sliceNear : sliceFar;
+			const float h = d * tanHalfFovY;
+			const float w = h * aspectRatio;
+			corners[k] = camera.position + front * d +
+				right * ((k & 1) ? w : -w) + up * ((k & 2) ? h : -h);
+			center += corners[k];
+		}
+		center /= 8.0f;
+		float radius = 0;
+		for (const glm::vec3& e : corners)
+		{
+			radius = std::max(radius, glm::length(e - center));
+		}
+		radius = std::ceil(radius);
+
+		//SCgԂ̊iqɍ킹
+		//iq̊ԊueNZ̐{ɂāAJĂe̗֊sȂ悤ɂ
+		//`͈͂͊iq1LāASĂ͂ݏoȂ悤ɂ
+		const float extent = radius * 1.25f;
+		const float texelSize = extent * 2.0f / static_cast<float>(tileSize);
+		const float cellSize = std::max(1.0f, std::floor(radius * 0.25f / texelSize)) * texelSize;
+		const glm::vec3 lightSpaceCenter = glm::vec3(matLightRotation * glm::vec4(center, 1));
+		const glm::ivec3 cell = glm::ivec3(glm::floor(lightSpaceCenter / cellSize + 0.5f));
+
+		ShadowCascade& cascade = shadowCascades[i];
+		if (cascade.cell != cell || cascade.radius != radius)
+		{
+			cascade.cell = cell;
+			cascade.radius = radius;
+			cascade.cached = false;
+		}
+		cascade.matView =
+			glm::translate(glm::mat4(1), -glm::vec3(cell) * cellSize) * matLightRotation;
+		cascade.matProj = glm::ortho(-extent, extent, -extent, extent,
+			-(extent + casterDistance), extent);
+		const glm::mat4 matVP = cascade.matProj * cascade.matView;
+
+		//[hWeNX`W(0`1)ɕϊs
+		matShadowTexture[i] = glm::translate(glm::mat4(1), glm::vec3(0.5f)) *
+			glm::scale(glm::mat4(1), glm::vec3(0.5f)) * matVP;
+
+		const GLint x = (i % 2) * tileSize;
+		const GLint y = (i / 2) * tileSize;
+		meshBuffer.SetShadowViewProjectionMatrix(matVP);
+		Mesh::EnableCulling(Collision::CreateFrustum(matVP));
+		if (shadowCacheSupported)
+		{
+			//Ȃ̂̉éA`͈͂CǧςƂ`
+			if (!cascade.cached)
+			{
+				GLState::BindFramebuffer(fboShadowStatic->GetFramebuffer());
+				glViewport(x, y, tileSize, tileSize);
+				GLState::Enable(GL_SCISSOR_TEST);
+				glScissor(x, y, tileSize, tileSize);
+				glClear(GL_DEPTH_BUFFER_BIT);
+				GLState::Disable(GL_SCISSOR_TEST);
+				RenderMesh(Mesh::DrawType::shadow, cascade.matView, MeshGroup::staticOnly);
+				cascade.cached = true;
+				++shadowStaticRenderCount;
+			}
+			glCopyImageSubData(
+				fboShadowStatic->GetDepthTexture()->Get(), GL_TEXTURE_2D, 0, x, y, 0,
+				fboShadow->GetDepthTexture()->Get(), GL_TEXTURE_2D, 0, x, y, 0,
+				tileSize, tileSize, 1);
+			GLState::BindFramebuffer(fboShadow->GetFramebuffer());
+			glViewport(x, y, tileSize, tileSize);
+			RenderMesh(Mesh::DrawType::shadow, cascade.matView, MeshGroup::dynamicOnly);
+		}
+		else
+		{
+			GLState::BindFramebuffer(fboShadow->GetFramebuffer());
+			glViewport(x, y, tileSize, tileSize);
+			GLState::Enable(GL_SCISSOR_TEST);
+			glScissor(x, y, tileSize, tileSize);
+			glClear(GL_DEPTH_BUFFER_BIT);
+			GLState::Disable(GL_SCISSOR_TEST);
+			RenderMesh(Mesh::DrawType::shadow, cascade.matView);
+			++shadowStaticRenderCount;
+		}
+		Mesh::DisableCulling();
+	}
+	meshBuffer.SetShadowMatrices(Mesh::shadowCascadeCount, matShadowTexture);
+}
 
+/**
+* Օp̐[xobt@ɎՕ`悷
+*
+* @param matVP J̃r[vWFNVs
+*
+* en`bVƁAûLE{bNX(Ε)ՕƂĎg
+*/
+void MainGameScene::RenderOccluders(const glm::mat4& matVP)
+{
+	occlusionCuller.Begin(matVP);
+	for (const OcclusionCuller::OccluderMesh& e : terrainOccluders)
+	{
+		occlusionCuller.AddOccluder(e);
 	}
-#if 0
-	//fobÔ߂ɁAep̐[xeNX`\
+	for (const ActorPtr& e : objects)
 	{
-		glDisable(GL_BLEND);
-		Mesh::FilePtr simpleMesh = meshBuffer.GetFile("Simple");
-		simpleMesh->materials[0].texture[0] = fboShadow->GetDepthTexture();
-		glm::mat4 m = glm::scale(glm::translate(
-			glm::mat4(1), glm::vec3(-0.45f, 0, 0)), glm::vec3(0.5f, 0.89f, 1));
-		Mesh::Draw(simpleMesh, m);
+		if (e->colWorld.type == Collision::Shape::Type::obb)
+		{
+			occlusionCuller.AddOccluder(e->colWorld.obb);
+		}
 	}
-#endif
+	occlusionCuller.End();
+}
+
+/**
+* ʊE[xGtFNg̃pX1`悷
+*
+* @param graph   `Ǘt[Ot
+* @param program `ɎgVF[_[
+* @param target  `
+* @param source  摜(J[Ɛ[x)̕`
+* @param gather  k𑜓xłڂ`. gȂꍇFrameGraph::invalidId
+* @param sourceScale 摜̂`悳Ă͈͂̑傫(I𑜓x̏k)
+*/
+void MainGameScene::RenderDepthOfField(const FrameGraph& graph, const Shader::ProgramPtr& program,
+	FrameGraph::ResourceId target, FrameGraph::ResourceId source, FrameGraph::ResourceId gather,
+	const glm::vec2& sourceScale)
+{
+	graph.BindRenderTarget(target);
+	glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	GLState::Disable(GL_DEPTH_TEST);
+	GLState::Disable(GL_CULL_FACE);
+	GLState::Disable(GL_BLEND);
+
+	Mesh::FilePtr mesh = meshBuffer.GetFile("RenderTarget");
+	Mesh::Material& m = mesh->materials[0];
+	m.program = program;
+	m.texture[0] = graph.GetColorTexture(source);
+	m.texture[1] = graph.GetDepthTexture(source);
+	m.texture[2] = graph.GetColorTexture(gather);
+	program->Use();
+	const FrameGraph::RenderTargetDesc& desc = graph.GetDesc(source);
+	program->SetViewInfo(static_cast<float>(desc.width),
+		static_cast<float>(desc.height), camera.near, camera.far);
+	program->SetCameraInfo(camera.focalPlane, camera.focalLength,
+		camera.aperture, camera.sensorSize);
+	program->SetUniform("sourceScale", sourceScale);
+	Mesh::Draw(mesh, glm::mat4(1));
 }
 
 /**
@@ -743,31 +1052,76 @@ void MainGameScene::Camera::Update(const glm::mat4& matView)
 	aperture = focalLength / fnumber;
 }
 
+/**
+* ʊE[xGtFNg𑜓x̏k擾
+*
+* @return c̏k(1Ȃ猳̉𑜓x)
+*/
+int MainGameScene::Camera::GetDepthOfFieldDownscale() const
+{
+	switch (dofQuality)
+	{
+	case DepthOfFieldQuality::half: return 2;
+	case DepthOfFieldQuality::quarter: return 4;
+	default: return 1;
+	}
+}
+
 /**
 * bV`悷
 *
 * @param drawType `悷f[^̎
+* @param matView  `Ɏgpr[s
+*
+* SẴbV`L[ɒǉĂAבւĂ܂Ƃ߂ĕ`悷
 */
-void MainGameScene::RenderMesh(Mesh::DrawType drawType)
+void MainGameScene::RenderMesh(Mesh::DrawType drawType, const glm::mat4& matView,
+	MeshGroup group)
 {
-	glm::vec3 cubePos(100, 0, 100);
-	cubePos.y = heightMap.Height(cubePos);
-	const glm::mat4 matModel = glm::translate(glm::mat4(1), cubePos);
-	Mesh::Draw(meshBuffer.GetFile("Cube"), matModel,drawType);
-	Mesh::Draw(meshBuffer.GetFile("Terrain"), glm::mat4(1),drawType);
-
-	player->Draw(drawType);
-	enemies.Draw(drawType);
-	trees.Draw(drawType);
-	objects.Draw(drawType);
-	//fontRenderer.Draw(screenSize);
-
-	glm::vec3 treePos(110, 0, 110);
-	treePos.y = heightMap.Height(treePos);
-	const glm::mat4 matTreeModel =
-		glm::translate(glm::mat4(1), treePos) * glm::scale(glm::mat4(1), glm::vec3(3));
-	Mesh::Draw(meshBuffer.GetFile("Res/red_pine_tree.gltf"), matTreeModel,drawType);
-
-	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-	Mesh::Draw(meshBuffer.GetFile("Water"), glm::mat4(1),drawType);
+	renderQueue.Begin(drawType, matView);
+
+	if (group != MeshGroup::dynamicOnly)
+	{
+		glm::vec3 cubePos(100, 0, 100);
+		cubePos.y = heightMap.Height(cubePos);
+		const glm::mat4 matModel = glm::translate(glm::mat4(1), cubePos);
+		renderQueue.Submit(meshBuffer.GetFile("Cube"), matModel);
+		renderQueue.Submit(meshBuffer.GetFile("Terrain"), glm::mat4(1));
+	}
+
+	//ՕJO̓J猩`悾Ɏg
+	if (drawType == Mesh::DrawType::color)
+	{
+		Mesh::EnableOcclusionCulling(&occlusionCuller);
+	}
+	if (group != MeshGroup::staticOnly)
+	{
+		enemies.Draw(renderQueue);
+	}
+	if (group != MeshGroup::dynamicOnly)
+	{
+		trees.Draw(renderQueue);
+	}
+	Mesh::DisableOcclusionCulling();
+
+	if (group != MeshGroup::staticOnly)
+	{
+		player->Draw(renderQueue);
+	}
+	if (group != MeshGroup::dynamicOnly)
+	{
+		objects.Draw(renderQueue);
+		//fontRenderer.Draw(screenSize);
+
+		glm::vec3 treePos(110, 0, 110);
+		treePos.y = heightMap.Height(treePos);
+		const glm::mat4 matTreeModel =
+			glm::translate(glm::mat4(1), treePos) * glm::scale(glm::mat4(1), glm::vec3(3));
+		renderQueue.Submit(meshBuffer.GetFile("Res/red_pine_tree.gltf"), matTreeModel);
+
+		renderQueue.SubmitBlended(meshBuffer.GetFile("Water"), glm::mat4(1),
+			GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	}
+
+	renderQueue.Flush();
 }
\ No newline at end of file
@@ -8,13 +8,19 @@
 #include "Sprite.h"
 #include "Font.h"
 #include "Mesh.h"
+#include "RenderQueue.h"
 #include "Terrain.h"
 #include "Actor.h"
 #include "PlayerActor.h"
 #include "JizoActor.h"
 #include "Light.h"
+#include "LightCluster.h"
 #include "FramebufferObject.h"
 #include "Particle.h"
+#include "Bloom.h"
+#include "FrameGraph.h"
+#include "DynamicResolution.h"
+#include "OcclusionCuller.h"
 #include <vector>
 #include <random>
 
@@ -36,7 +42,31 @@ public:
 	bool HandleJizoEffects(int id, const glm::vec3& pos);
 
 private:
-	void RenderMesh(Mesh::DrawType);
+	/**
+	* RenderMeshŕ`悷镨̂̎
+	*/
+	enum class MeshGroup
+	{
+		all,//SĂ̕
+		staticOnly,//n`A؁AuȂǂ̓Ȃ
+		dynamicOnly,//vC[GȂǂ̓
+	};
+	void RenderMesh(Mesh::DrawType, const glm::mat4& matView, MeshGroup group = MeshGroup::all);
+	void RenderShadow();
+	void RenderOccluders(const glm::mat4& matVP);
+	void RenderDepthOfField(const FrameGraph& graph, const Shader::ProgramPtr& program,
+		FrameGraph::ResourceId target, FrameGraph::ResourceId source, FrameGraph::ResourceId gather,
+		const glm::vec2& sourceScale);
+
+	/**
+	* ʊE[xGtFNg̕i
+	*/
+	enum class DepthOfFieldQuality
+	{
+		full,//̉𑜓xłڂ
+		half,//c1/2̉𑜓xłڂāẢ𑜓xɊg升
+		quarter,//c1/4̉𑜓xłڂāẢ𑜓xɊg升
+	};
 
 	bool flag = false;
 	std::mt19937 rand;
@@ -46,6 +76,7 @@ private:
 	SpriteRenderer spriteRenderer;
 	FontRenderer fontRenderer;
 	Mesh::Buffer meshBuffer;
+	Mesh::RenderQueue renderQueue;
 	Terrain::HeightMap heightMap;
 	PlayerActorPtr player;
 	ActorList enemies;
@@ -53,14 +84,35 @@ private:
 	ActorList objects;
 
 	LightBuffer lightBuffer;
+	LightCluster lightCluster;//̋悲Ƃɉe郉Cg̈ꗗ
 	ActorList lights;
 
 	ParticleSystem particleSystem;
+	Bloom bloom;
 
-	FramebufferObjectPtr fboMain;
-	FramebufferObjectPtr fboDepthOfField;
-	FramebufferObjectPtr fboBloom[6][2];
-	FramebufferObjectPtr fboShadow;
+	FrameGraph frameGraph;//`pXƈꎞ`Ǘ
+	Shader::ProgramVariantsPtr dofShaders;//ʊE[xGtFNgpVF[_[
+	DynamicResolution dynamicResolution;//3Df`悷𑜓x𐧌䂷
+	OcclusionCuller occlusionCuller;//؂Gn`ǂɉBĂ邩肷
+	std::vector<OcclusionCuller::OccluderMesh> terrainOccluders;//Օp̑en`bV
+	FramebufferObjectPtr fboShadow;//ep̐[xeNX`(2x2ɕĊeJXP[h`悷)
+	FramebufferObjectPtr fboShadowStatic;//Ȃ̂`悵ep̐[xeNX`
+
+	/**
+	* JXP[hVhE}bv1
+	*/
+	struct ShadowCascade
+	{
+		glm::mat4 matView = glm::mat4(1);
+		glm::mat4 matProj = glm::mat4(1);
+		glm::ivec3 cell = glm::ivec3(0);//CgԂŊiqɍ킹S̈ʒu
+		float radius = 0;//`͈͂̔a
+		bool cached = false;//fboShadowStatic̕`挋ʂgȂtrue
+	};
+	ShadowCascade shadowCascades[Mesh::shadowCascadeCount];
+	glm::vec3 shadowLightDirection = glm::vec3(0);//ÓIȉe`悵Ƃ̃Cǧ
+	bool shadowCacheSupported = false;//glCopyImageSubDatagȂtrue
+	int shadowStaticRenderCount = 0;//ÓIȉe`JXP[h̐
 
 	struct Camera
 	{
@@ -85,7 +137,11 @@ private:
 		float aperture = 20.0f;//Ap[` = J(~)
 		float focalPlane = 10000.0f;//tH[Jv- = sg̍
 
+		//掿p[^
+		DepthOfFieldQuality dofQuality = DepthOfFieldQuality::half;//ʊE[xGtFNg̕i
+
 		void Update(const glm::mat4& matView);
+		int GetDepthOfFieldDownscale() const;
 	};
 	Camera camera;
 };
@@ -3,6 +3,10 @@
 */
 #include "Mesh.h"
 #include "SkeletalMesh.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "GLState.h"
+#include "RenderStats.h"
 #include "json11/json11.hpp"
 #include <glm/gtc/quaternion.hpp>
 #include <fstream>
@@ -10,6 +14,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/constants.hpp>
 #include <iostream>
+#include <cfloat>
+#include <cmath>
 
 /**
 * bVɊւ@\i[閼O
@@ -173,6 +179,630 @@ namespace Mesh
 		*pp = binFiles[bufferId].data() + baesByteOffset;
 	}
 
+	/**
+	* ̌^̃oCg擾
+	*
+	* @param componentType ̌^
+	*
+	* @return componentTypẽoCg
+	*/
+	GLsizei GetComponentByteSize(GLenum componentType)
+	{
+		switch (componentType)
+		{
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE:
+			return 1;
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
+			return 2;
+		default:
+			return 4;
+		}
+	}
+
+	/**
+	* ANZbTw肷钸_f[^擾
+	*
+	* @param accessor glTFANZbT
+	* @param bufferViews oCif[^𕪊Ǘ邽߂̃f[^z
+	* @param binFiles oCit@C̔z
+	* @param stream 擾_f[^̊i[
+	*
+	* @retval true 擾
+	* @retval false 擾s(ANZbT݂ȂA܂͖Ή̌^)
+	*
+	* obt@r[̃f[^ɂ炸AvfԂȂׂĊi[
+	*/
+	bool ReadVertexStream(const json11::Json& accessor, const json11::Json& bufferViews,
+		const std::vector<std::vector<char>>& binFiles, VertexStream* stream)
+	{
+		*stream = VertexStream();
+		if (accessor.is_null())
+		{
+			return false;
+		}
+		static const char* const typeNameList[] = { "SCALAR", "VEC2", "VEC3", "VEC4" };
+		const std::string& type = accessor["type"].string_value();
+		GLint size = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			if (type == typeNameList[i])
+			{
+				size = i + 1;
+				break;
+			}
+		}
+		if (size <= 0)
+		{
+			std::cerr << "[G[]" << __func__ << ":" << type << "͒_ɐݒł܂\n";
+			return false;
+		}
+
+		const void* p;
+		size_t byteLength;
+		int byteStride;
+		GetBuffer(accessor, bufferViews, binFiles, &p, &byteLength, &byteStride);
+		const GLenum componentType = accessor["componentType"].int_value();
+		const GLsizei elementSize = size * GetComponentByteSize(componentType);
+		const size_t srcStride = byteStride > 0 ? byteStride : elementSize;
+		const size_t count = accessor["count"].int_value();
+		const uint8_t* src = static_cast<const uint8_t*>(p) + accessor["byteOffset"].int_value();
+
+		stream->size = size;
+		stream->type = componentType;
+		stream->normalized = accessor["normalized"].bool_value() ? GL_TRUE : GL_FALSE;
+		stream->stride = elementSize;
+		stream->data.resize(count * elementSize);
+		for (size_t i = 0; i < count; ++i)
+		{
+			std::copy(src + i * srcStride, src + i * srcStride + elementSize,
+				stream->data.begin() + i * elementSize);
+		}
+		return true;
+	}
+
+	/**
+	* ANZbTw肷CfbNXf[^擾
+	*
+	* @param accessor glTFANZbT
+	* @param bufferViews oCif[^𕪊Ǘ邽߂̃f[^z
+	* @param binFiles oCit@C̔z
+	* @param indices 擾CfbNXf[^̊i[
+	*
+	* @retval true 擾
+	* @retval false 擾s
+	*/
+	bool ReadIndices(const json11::Json& accessor, const json11::Json& bufferViews,
+		const std::vector<std::vector<char>>& binFiles, std::vector<GLuint>* indices)
+	{
+		indices->clear();
+		VertexStream stream;
+		if (!ReadVertexStream(accessor, bufferViews, binFiles, &stream) || stream.size != 1)
+		{
+			return false;
+		}
+		const size_t count = stream.Count();
+		indices->resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint8_t* p = stream.data.data() + i * stream.stride;
+			switch (stream.type)
+			{
+			case GL_UNSIGNED_BYTE:
+				(*indices)[i] = *p;
+				break;
+			case GL_UNSIGNED_SHORT:
+				(*indices)[i] = *reinterpret_cast<const GLushort*>(p);
+				break;
+			default:
+				(*indices)[i] = *reinterpret_cast<const GLuint*>(p);
+				break;
+			}
+		}
+		return true;
+	}
+
+	/**
+	* _f[^̗vf𕂓_ƂĎ擾
+	*
+	* @param stream _f[^
+	* @param i      擾vf̔ԍ
+	*
+	* @return iԖڂ̗vf. ݂Ȃ(0, 0, 0, 1)ŕ₤
+	*/
+	glm::vec4 GetVertexStreamElement(const VertexStream& stream, size_t i)
+	{
+		glm::vec4 v(0, 0, 0, 1);
+		const uint8_t* p = stream.data.data() + i * stream.stride;
+		for (int n = 0; n < stream.size && n < 4; ++n)
+		{
+			switch (stream.type)
+			{
+			case GL_FLOAT:
+				v[n] = reinterpret_cast<const GLfloat*>(p)[n];
+				break;
+			case GL_UNSIGNED_BYTE:
+				v[n] = p[n];
+				if (stream.normalized)
+				{
+					v[n] /= 255.0f;
+				}
+				break;
+			case GL_UNSIGNED_SHORT:
+				v[n] = reinterpret_cast<const GLushort*>(p)[n];
+				if (stream.normalized)
+				{
+					v[n] /= 65535.0f;
+				}
+				break;
+			case GL_BYTE:
+				v[n] = reinterpret_cast<const GLbyte*>(p)[n];
+				if (stream.normalized)
+				{
+					v[n] = std::max(v[n] / 127.0f, -1.0f);
+				}
+				break;
+			case GL_SHORT:
+				v[n] = reinterpret_cast<const GLshort*>(p)[n];
+				if (stream.normalized)
+				{
+					v[n] = std::max(v[n] / 32767.0f, -1.0f);
+				}
+				break;
+			}
+		}
+		return v;
+	}
+
+	/**
+	* _f[^ʎq
+	*
+	* @param streams _f[^̔z(Y͒_̃CfbNX)
+	*                0=_W, 1=eNX`W, 2=@, 3=EFCg, 4=WCgԍ
+	* @param prim    _W̕p[^ݒ肷v~eBu
+	*
+	* _W̓v~eBu͈̔͂ɑ΂16bitKA
+	* eNX`W16bit_A@10_10_10_2`A
+	* EFCg8bitKɕϊ. _ȊȎ͂̂܂܎c
+	*/
+	void QuantizeVertexStreams(std::vector<VertexStream>& streams, Primitive* prim)
+	{
+		//_W
+		if (streams.size() > 0 && streams[0].type == GL_FLOAT && streams[0].Count() > 0)
+		{
+			const VertexStream& src = streams[0];
+			const size_t count = src.Count();
+			glm::vec3 vmin(FLT_MAX);
+			glm::vec3 vmax(-FLT_MAX);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const glm::vec3 v(GetVertexStreamElement(src, i));
+				vmin = glm::min(vmin, v);
+				vmax = glm::max(vmax, v);
+			}
+			const glm::vec3 extent = vmax - vmin;
+			VertexStream dst;
+			dst.size = 3;
+			dst.type = GL_UNSIGNED_SHORT;
+			dst.normalized = GL_TRUE;
+			dst.stride = sizeof(GLushort) * 4;//4oCgEɐ񂷂邽4ɂ
+			dst.data.resize(count * dst.stride);
+			GLushort* p = reinterpret_cast<GLushort*>(dst.data.data());
+			for (size_t i = 0; i < count; ++i)
+			{
+				const glm::vec3 v(GetVertexStreamElement(src, i));
+				for (int n = 0; n < 3; ++n)
+				{
+					const float t = extent[n] > 0 ? (v[n] - vmin[n]) / extent[n] : 0.0f;
+					p[i * 4 + n] = static_cast<GLushort>(glm::clamp(t, 0.0f, 1.0f) * 65535.0f + 0.5f);
+				}
+				p[i * 4 + 3] = 0;
+			}
+			streams[0] = std::move(dst);
+			prim->positionScale = extent;
+			prim->positionOffset = vmin;
+		}
+
+		//eNX`W
+		if (streams.size() > 1 && streams[1].type == GL_FLOAT && streams[1].size == 2)
+		{
+			const VertexStream& src = streams[1];
+			const size_t count = src.Count();
+			VertexStream dst;
+			dst.size = 2;
+			dst.type = GL_HALF_FLOAT;
+			dst.normalized = GL_FALSE;
+			dst.stride = sizeof(GLuint);
+			dst.data.resize(count * dst.stride);
+			GLuint* p = reinterpret_cast<GLuint*>(dst.data.data());
+			for (size_t i = 0; i < count; ++i)
+			{
+				p[i] = glm::packHalf2x16(glm::vec2(GetVertexStreamElement(src, i)));
+			}
+			streams[1] = std::move(dst);
+		}
+
+		//@
+		if (streams.size() > 2 && streams[2].type == GL_FLOAT && streams[2].size >= 3)
+		{
+			const VertexStream& src = streams[2];
+			const size_t count = src.Count();
+			VertexStream dst;
+			dst.size = 4;//GL_INT_2_10_10_10_REV4łȂ΂ȂȂ
+			dst.type = GL_INT_2_10_10_10_REV;
+			dst.normalized = GL_TRUE;
+			dst.stride = sizeof(GLuint);
+			dst.data.resize(count * dst.stride);
+			GLuint* p = reinterpret_cast<GLuint*>(dst.data.data());
+			for (size_t i = 0; i < count; ++i)
+			{
+				glm::vec3 n(GetVertexStreamElement(src, i));
+				const float len = glm::length(n);
+				if (len > 0)
+				{
+					n /= len;
+				}
+				GLuint packed = 0;
+				for (int c = 0; c < 3; ++c)
+				{
+					const int q = static_cast<int>(std::floor(glm::clamp(n[c], -1.0f, 1.0f) * 511.0f + 0.5f));
+					packed |= (static_cast<GLuint>(q) & 0x3ff) << (c * 10);
+				}
+				p[i] = packed;
+			}
+			streams[2] = std::move(dst);
+		}
+
+		//EFCg
+		if (streams.size() > 3 && streams[3].type == GL_FLOAT)
+		{
+			const VertexStream& src = streams[3];
+			const size_t count = src.Count();
+			VertexStream dst;
+			dst.size = 4;
+			dst.type = GL_UNSIGNED_BYTE;
+			dst.normalized = GL_TRUE;
+			dst.stride = 4;
+			dst.data.resize(count * dst.stride);
+			for (size_t i = 0; i < count; ++i)
+			{
+				glm::vec4 w = glm::max(GetVertexStreamElement(src, i), glm::vec4(0));
+				const float sum = w.x + w.y + w.z + w.w;
+				if (sum > 0)
+				{
+					w /= sum;
+				}
+				//v255ɂȂ悤ɁAۂߌ덷ő̃EFCgɉ
+				int q[4];
+				int total = 0;
+				int maxIndex = 0;
+				for (int n = 0; n < 4; ++n)
+				{
+					q[n] = static_cast<int>(w[n] * 255.0f + 0.5f);
+					total += q[n];
+					if (w[n] > w[maxIndex])
+					{
+						maxIndex = n;
+					}
+				}
+				if (sum > 0)
+				{
+					q[maxIndex] = glm::clamp(q[maxIndex] + 255 - total, 0, 255);
+				}
+				for (int n = 0; n < 4; ++n)
+				{
+					dst.data[i * 4 + n] = static_cast<uint8_t>(q[n]);
+				}
+			}
+			streams[3] = std::move(dst);
+		}
+	}
+
+	/**
+	* v~eBűE{[vZ
+	*
+	* @param prim      E{[ݒ肷v~eBu
+	* @param accessor  _WglTFANZbT
+	* @param positions _W̒_f[^(ʎqÔ)
+	*
+	* AABB̓ANZbTmin, maxgAȂΒ_f[^vZ
+	* AABB̒Sł_܂ł̋𔼌aƂ
+	*/
+	void CalcPrimitiveBounds(Primitive* prim, const json11::Json& accessor,
+		const VertexStream& positions)
+	{
+		const size_t count = positions.Count();
+		const std::vector<json11::Json>& accessorMin = accessor["min"].array_items();
+		const std::vector<json11::Json>& accessorMax = accessor["max"].array_items();
+		if (accessorMin.size() >= 3 && accessorMax.size() >= 3)
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				prim->aabb.min[i] = static_cast<float>(accessorMin[i].number_value());
+				prim->aabb.max[i] = static_cast<float>(accessorMax[i].number_value());
+			}
+		}
+		else if (count > 0)
+		{
+			prim->aabb.min = glm::vec3(FLT_MAX);
+			prim->aabb.max = glm::vec3(-FLT_MAX);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const glm::vec3 p(GetVertexStreamElement(positions, i));
+				prim->aabb.min = glm::min(prim->aabb.min, p);
+				prim->aabb.max = glm::max(prim->aabb.max, p);
+			}
+		}
+
+		prim->sphere.center = (prim->aabb.min + prim->aabb.max) * 0.5f;
+		float r2 = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const glm::vec3 v = glm::vec3(GetVertexStreamElement(positions, i)) - prim->sphere.center;
+			r2 = std::max(r2, glm::dot(v, v));
+		}
+		prim->sphere.r = count > 0 ? std::sqrt(r2) :
+			glm::length(prim->aabb.max - prim->aabb.min) * 0.5f;
+	}
+
+	/**
+	* _f[^v~eBűE{[vZ
+	*
+	* @param vertices _f[^̔z
+	* @param count    _
+	* @param prim     E{[ݒ肷v~eBu
+	*/
+	void CalcBounds(const Vertex* vertices, size_t count, Primitive* prim)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		prim->aabb.min = prim->aabb.max = vertices[0].position;
+		for (size_t i = 1; i < count; ++i)
+		{
+			prim->aabb.min = glm::min(prim->aabb.min, vertices[i].position);
+			prim->aabb.max = glm::max(prim->aabb.max, vertices[i].position);
+		}
+		prim->sphere.center = (prim->aabb.min + prim->aabb.max) * 0.5f;
+		float r2 = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const glm::vec3 v = vertices[i].position - prim->sphere.center;
+			r2 = std::max(r2, glm::dot(v, v));
+		}
+		prim->sphere.r = std::sqrt(r2);
+	}
+
+	/**
+	* E{[̔zSĈ͂ދE{[vZ
+	*
+	* @param list   aabbspherevf̔z
+	* @param aabb   vZAABB̊i[
+	* @param sphere vZ̊i[
+	*/
+	template<typename T>
+	void MergeBounds(const std::vector<T>& list, Collision::AABB* aabb, Collision::Sphere* sphere)
+	{
+		if (list.empty())
+		{
+			return;
+		}
+		*aabb = list[0].aabb;
+		for (const T& e : list)
+		{
+			aabb->min = glm::min(aabb->min, e.aabb.min);
+			aabb->max = glm::max(aabb->max, e.aabb.max);
+		}
+		sphere->center = (aabb->min + aabb->max) * 0.5f;
+		sphere->r = 0;
+		for (const T& e : list)
+		{
+			sphere->r = std::max(sphere->r,
+				glm::length(e.sphere.center - sphere->center) + e.sphere.r);
+		}
+		sphere->r = std::min(sphere->r, glm::length(aabb->max - aabb->min) * 0.5f);
+	}
+
+	/**
+	* bV̋E{[Sv~eBuvZ
+	*
+	* @param mesh E{[ݒ肷郁bV
+	*/
+	void SetupMeshBounds(Mesh& mesh)
+	{
+		MergeBounds(mesh.primitives, &mesh.aabb, &mesh.sphere);
+	}
+
+	/**
+	* t@C̋E{[SbVvZ
+	*
+	* @param meshes bV̔z
+	* @param aabb   vZAABB̊i[
+	* @param sphere vZ̊i[
+	*/
+	void SetupFileBounds(const std::vector<Mesh>& meshes,
+		Collision::AABB* aabb, Collision::Sphere* sphere)
+	{
+		MergeBounds(meshes, aabb, sphere);
+	}
+
+	/**
+	* bVLODƂ̌덷ݒ肷
+	*
+	* @param mesh ݒ肷郁bV
+	*
+	* LODȂv~eBu͍łeLODĝŁǍ덷܂߂čől
+	*/
+	void SetupLodParameters(Mesh& mesh)
+	{
+		size_t lodCount = 1;
+		for (const Primitive& e : mesh.primitives)
+		{
+			lodCount = std::max(lodCount, e.lods.size() + 1);
+		}
+		mesh.lodErrors.assign(lodCount, 0.0f);
+		for (size_t lod = 1; lod < lodCount; ++lod)
+		{
+			float error = mesh.lodErrors[lod - 1];
+			for (const Primitive& e : mesh.primitives)
+			{
+				if (!e.lods.empty())
+				{
+					error = std::max(error, e.lods[std::min(lod, e.lods.size()) - 1].error);
+				}
+			}
+			mesh.lodErrors[lod] = error;
+		}
+	}
+
+	/**
+	* w肵LOD̃CfbNXf[^擾
+	*
+	* @param prim    v~eBu
+	* @param lod     LODԍ(0Ȃ猳̃v~eBu)
+	* @param count   CfbNX̊i[
+	* @param indices CfbNXf[^̈ʒůi[
+	*
+	* v~eBuĂȂLODw肳ꂽꍇ́AłeLODԂ
+	*/
+	void GetLodIndices(const Primitive& prim, int lod, GLsizei* count, const GLvoid** indices)
+	{
+		if (lod <= 0 || prim.lods.empty())
+		{
+			*count = prim.count;
+			*indices = prim.indices;
+			return;
+		}
+		const PrimitiveLod& e = prim.lods[std::min(static_cast<size_t>(lod), prim.lods.size()) - 1];
+		*count = e.count;
+		*indices = e.indices;
+	}
+
+	/**
+	* }eÃeNX`ƃ}eA萔GLReLXgɊ蓖Ă
+	*
+	* @param m 蓖Ă}eA
+	*
+	* eNX`鎞́ÃeNX`IDݒ肷BȂ0ɂ
+	* eNX`UBO͈̔͂蓖čς݂̏ꍇAGLStateoChȗ
+	*/
+	void BindMaterial(const Material& m)
+	{
+		if (m.ubo)
+		{
+			m.ubo->BindBufferRange(m.uboOffset, sizeof(MaterialUniformBlock));
+		}
+		for (int i = 0; i < sizeof(m.texture) / sizeof(m.texture[0]); i++)
+		{
+			if (m.texture[i])
+			{
+				GLState::BindTexture(i, m.texture[i]->Target(), m.texture[i]->Get());
+				m.texture[i]->Touch();
+			}
+			else
+			{
+				GLState::BindTexture(i, GL_TEXTURE_2D, 0);
+			}
+		}
+	}
+
+	/**
+	* 󂫗̈惊Xg̈mۂ
+	*
+	* @param freeList 󂫗̈惊Xg
+	* @param end      gp̗̈̏I[
+	* @param capacity obt@̃oCg
+	* @param size     mۂoCg
+	*
+	* @return mۂ̈̊Jnʒu
+	*         󂫗̈悪Ȃꍇ-1
+	*
+	* ǂ̃f[^^łvȂ悤ɁÄ̃oCg4oCgEɐ񂷂
+	*/
+	GLintptr AllocateRange(std::vector<BufferRange>& freeList, GLintptr& end,
+		GLsizeiptr capacity, size_t size)
+	{
+		const GLsizeiptr alignedSize = static_cast<GLsizeiptr>(((size + 3) / 4) * 4);
+		for (auto itr = freeList.begin(); itr != freeList.end(); ++itr)
+		{
+			if (itr->size >= alignedSize)
+			{
+				const GLintptr offset = itr->offset;
+				itr->offset += alignedSize;
+				itr->size -= alignedSize;
+				if (itr->size <= 0)
+				{
+					freeList.erase(itr);
+				}
+				return offset;
+			}
+		}
+		if (end + alignedSize > capacity)
+		{
+			return -1;
+		}
+		const GLintptr offset = end;
+		end += alignedSize;
+		return offset;
+	}
+
+	/**
+	* ̈󂫗̈惊Xgɖ߂
+	*
+	* @param freeList 󂫗̈惊Xg
+	* @param end      gp̗̈̏I[
+	* @param range    ̈
+	*/
+	void FreeRange(std::vector<BufferRange>& freeList, GLintptr& end, const BufferRange& range)
+	{
+		//JnʒȕɂȂ悤ɑ}Aאڂ̈ƌ
+		auto itr = std::lower_bound(freeList.begin(), freeList.end(), range,
+			[](const BufferRange& a, const BufferRange& b) { return a.offset < b.offset; });
+		itr = freeList.insert(itr, range);
+		const auto next = itr + 1;
+		if (next != freeList.end() && itr->offset + itr->size == next->offset)
+		{
+			itr->size += next->size;
+			freeList.erase(next);
+		}
+		if (itr != freeList.begin())
+		{
+			const auto prev = itr - 1;
+			if (prev->offset + prev->size == itr->offset)
+			{
+				prev->size += itr->size;
+				freeList.erase(itr);
+			}
+		}
+
+		//I[ɐڂĂ󂫗͖̈gp̈ɖ߂
+		if (!freeList.empty() && freeList.back().offset + freeList.back().size == end)
+		{
+			end = freeList.back().offset;
+			freeList.pop_back();
+		}
+	}
+
+	/**
+	* fXgN^
+	*/
+	Buffer::~Buffer()
+	{
+		//ޔ̃IuWFNgQƂȂ悤ɁA풓Ǘ̓o^
+		Residency::Manager& residency = Residency::Manager::Instance();
+		for (int id : residencyIds)
+		{
+			residency.Unregister(id);
+		}
+	}
+
+	const GLsizeiptr instanceBufferSize = 1024 * 1024;//1t[ŎgCX^Xf[^̍őoCg
+	const GLsizeiptr indirectBufferSize = 256 * 1024;//1t[ŎgԐڕ`R}h̍őoCg
+	const size_t maxMaterialSlotCount = 1024;//}eA萔pUBOɊi[ł萔̐
+
 	/**
 	* bVobt@
 	*
@@ -184,7 +814,7 @@ namespace Mesh
 	*/
 	bool Buffer::Init(GLsizeiptr vboSize, GLsizeiptr iboSize)
 	{
-		if (!vbo.Create(GL_ARRAY_BUFFER, iboSize))
+		if (!vbo.Create(GL_ARRAY_BUFFER, vboSize))
 		{
 			return false;
 		}
@@ -192,15 +822,43 @@ namespace Mesh
 		{
 			return false;
 		}
-		progStaticMesh = Shader::Program::Create("Res/staticMesh.vert", "Res/StaticMesh.frag");
+		if (!instanceBuffer.Create(GL_ARRAY_BUFFER, instanceBufferSize, "InstanceBuffer"))
+		{
+			return false;
+		}
+		if (!indirectBuffer.Create(GL_DRAW_INDIRECT_BUFFER, indirectBufferSize, "IndirectBuffer"))
+		{
+			return false;
+		}
+		GLint uboOffsetAlignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboOffsetAlignment);
+		materialSlotSize = ((sizeof(MaterialUniformBlock) + uboOffsetAlignment - 1) /
+			uboOffsetAlignment) * uboOffsetAlignment;
+		materialUbo = UniformBuffer::Create(materialSlotSize * maxMaterialSlotCount,
+			Shader::Program::materialUniformBindingPoint, "MaterialUniformBlock");
+		if (!materialUbo)
+		{
+			return false;
+		}
+		materialSlots.clear();
+		//bVpVF[_[̔hłǗIuWFNg쐬
+		//hł̓CX^X`ȂǂɉĕKvɂȂƂɍ쐬
+		//XP^bVpSKINNED`hłɂȂ
+		meshShaders = Shader::ProgramVariants::Create("Res/StaticMesh.vert", "Res/StaticMesh.frag");
+		shadowShaders = Shader::ProgramVariants::Create(
+			"Res/StaticMesh.vert", "Res/StaticMesh.frag", { { "SHADOW_PASS", 1 } });
+		meshShaders->SetCreateCallback(
+			[this](Shader::Program& p) { ApplyFrameUniforms(p, false); });
+		shadowShaders->SetCreateCallback(
+			[this](Shader::Program& p) { ApplyFrameUniforms(p, true); });
+		progStaticMesh = meshShaders->Get();
 		if (progStaticMesh->IsNull())
 		{
 			return false;
 		}
 
 		//XP^bVp̃VF[_[ǂݍ
-		progSkeletalMesh = Shader::Program::Create(
-			"Res/SkeletalMesh.vert", "Res/SkeletalMesh.frag");
+		progSkeletalMesh = meshShaders->Get({ { "SKINNED", 1 } });
 		if (progSkeletalMesh->IsNull())
 		{
 			return false;
@@ -218,60 +876,306 @@ namespace Mesh
 			return false;
 		}
 
-		//e`p̃VF[_[vO쐬
-		progShadow = Shader::Program::Create("Res/StaticMesh.vert","Res/Shadow.frag");
-		progNonTexturedShadow = Shader::Program::Create(
-			"Res/StaticMesh.vert", "Res/NonTexturedShadow.frag");
-		progSkeletalShadow = Shader::Program::Create(
-			"Res/SkeletalMesh.vert", "Res/Shadow.frag");
-		if (progShadow->IsNull() ||
-			progNonTexturedShadow->IsNull() ||
-			progSkeletalShadow->IsNull())
+		//e`pƃCX^X`p̔hł́Aŏ̕`ō쐬Ȃ悤ɐɍĂ
+		if (shadowShaders->Get()->IsNull() ||
+			shadowShaders->Get({ { "NON_TEXTURED", 1 } })->IsNull() ||
+			shadowShaders->Get({ { "SKINNED", 1 } })->IsNull() ||
+			shadowShaders->Get({ { "INSTANCED", 1 } })->IsNull() ||
+			meshShaders->Get({ { "INSTANCED", 1 } })->IsNull())
 		{
 			return false;
 		}
 
 		vboEnd = 0;
 		iboEnd = 0;
+		vboCapacity = vboSize;
+		iboCapacity = iboSize;
 		files.reserve(100);
 
 		AddCude("Cube");
 
-		return true;
+		return true;
+	}
+
+	/**
+	* _f[^ǉ
+	*
+	* @param data ǉf[^̃|C^
+	* @param size ǉf[^̃oCg
+	*
+	* @return f[^ǉʒu
+	*			CreateprimitivevOffsetp[^ƂĎgp
+	*			VBŐ󂫗̈悪Ȃꍇ-1
+	*/
+	GLintptr Buffer::AddVertexData(const void* data, size_t size)
+	{
+		const GLintptr offset = AllocateVertexData(size);
+		if (offset >= 0)
+		{
+			vbo.BufferSubData(offset, size, data);
+		}
+		return offset;
+	}
+
+	/**
+	* CfbNXf[^ǉ
+	*
+	* @param data ǉf[^̃|C^
+	* @param size ǉf[^̃oCg
+	*
+	* @return f[^ǉʒu
+	*			v~eBuindicesp[^ƂĎgƂo
+	*			IBŐ󂫗̈悪Ȃꍇ-1
+	*/
+	GLintptr Buffer::AddIndexData(const void* data, size_t size)
+	{
+		const GLintptr offset = AllocateIndexData(size);
+		if (offset >= 0)
+		{
+			ibo.BufferSubData(offset, size, data);
+		}
+		return offset;
+	}
+
+	/**
+	* CfbNXf[^w肵^ɕϊĒǉ
+	*
+	* @param indices ǉCfbNXf[^
+	* @param type i[^
+	*			(GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT̂ꂩ)
+	*
+	* @return f[^ǉʒu
+	*			IBŐ󂫗̈悪Ȃꍇ-1
+	*/
+	GLintptr Buffer::AddIndexData(const std::vector<GLuint>& indices, GLenum type)
+	{
+		switch (type)
+		{
+		case GL_UNSIGNED_BYTE:
+		{
+			const std::vector<GLubyte> tmp(indices.begin(), indices.end());
+			return AddIndexData(tmp.data(), tmp.size() * sizeof(GLubyte));
+		}
+		case GL_UNSIGNED_SHORT:
+		{
+			const std::vector<GLushort> tmp(indices.begin(), indices.end());
+			return AddIndexData(tmp.data(), tmp.size() * sizeof(GLushort));
+		}
+		default:
+			return AddIndexData(indices.data(), indices.size() * sizeof(GLuint));
+		}
+	}
+
+	/**
+	* VBÖ̗mۂ
+	*
+	* @param size mۂoCg
+	*
+	* @return mۂ̈̊Jnʒu
+	*         󂫗̈悪Ȃꍇ-1
+	*
+	* t@C̓ǂݍݒ́Amۂ̈t@CɋL^
+	* mۂɎsꍇisOutOfSpacetrueɂ
+	*/
+	GLintptr Buffer::AllocateVertexData(size_t size)
+	{
+		const GLintptr offset = AllocateRange(vboFreeList, vboEnd, vboCapacity, size);
+		if (offset < 0)
+		{
+			std::cerr << "[G[]" << __func__ << ":VBŐ󂫗̈悪܂(" <<
+				size << "oCg)\n";
+			isOutOfSpace = true;
+			return offset;
+		}
+		if (vboRangeLog)
+		{
+			vboRangeLog->push_back({ offset, static_cast<GLsizeiptr>(((size + 3) / 4) * 4) });
+		}
+		return offset;
+	}
+
+	/**
+	* IBÖ̗mۂ
+	*
+	* @param size mۂoCg
+	*
+	* @return mۂ̈̊Jnʒu
+	*         󂫗̈悪Ȃꍇ-1
+	*
+	* t@C̓ǂݍݒ́Amۂ̈t@CɋL^
+	* mۂɎsꍇisOutOfSpacetrueɂ
+	*/
+	GLintptr Buffer::AllocateIndexData(size_t size)
+	{
+		const GLintptr offset = AllocateRange(iboFreeList, iboEnd, iboCapacity, size);
+		if (offset < 0)
+		{
+			std::cerr << "[G[]" << __func__ << ":IBŐ󂫗̈悪܂(" <<
+				size << "oCg)\n";
+			isOutOfSpace = true;
+			return offset;
+		}
+		if (iboRangeLog)
+		{
+			iboRangeLog->push_back({ offset, static_cast<GLsizeiptr>(((size + 3) / 4) * 4) });
+		}
+		return offset;
+	}
+
+	/**
+	* VBOIBÖ̗
+	*
+	* @param vboRanges VBÖ̗
+	* @param iboRanges IBÖ̗
+	*/
+	void Buffer::FreeRanges(const std::vector<BufferRange>& vboRanges,
+		const std::vector<BufferRange>& iboRanges)
+	{
+		for (const BufferRange& e : vboRanges)
+		{
+			FreeRange(vboFreeList, vboEnd, e);
+		}
+		for (const BufferRange& e : iboRanges)
+		{
+			FreeRange(iboFreeList, iboEnd, e);
+		}
+	}
+
+	/**
+	* v~eBȕڍדx(LOD)𐶐IBOɒǉ
+	*
+	* @param prim      LODǉv~eBu
+	* @param indices   ̃v~eBũCfbNXf[^
+	* @param positions _W̒_f[^(ʎqÔ)
+	* @param option    ǂݍ݃IvV
+	*
+	* eLOD͌̃v~eBu̒_f[^LACfbNXf[^
+	*/
+	void Buffer::AddLods(Primitive* prim, const std::vector<GLuint>& indices,
+		const VertexStream& positions, const ImportOption& option)
+	{
+		if (option.lodCount <= 1 || prim->mode != GL_TRIANGLES)
+		{
+			return;
+		}
+		const size_t vertexCount = positions.Count();
+		std::vector<glm::vec3> points(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			points[i] = glm::vec3(GetVertexStreamElement(positions, i));
+		}
+		std::vector<MeshSimplifier::Level> levels =
+			MeshSimplifier::GenerateLods(indices, points, option.lodCount - 1, option.lodReduction);
+		prim->lods.reserve(levels.size());
+		for (MeshSimplifier::Level& e : levels)
+		{
+			MeshOptimizer::OptimizeVertexCache(e.indices, vertexCount);
+			PrimitiveLod lod;
+			lod.count = static_cast<GLsizei>(e.indices.size());
+			lod.indices = reinterpret_cast<const GLvoid*>(AddIndexData(e.indices, prim->type));
+			lod.error = e.error;
+			prim->lods.push_back(lod);
+			std::cout << "[]" << __func__ << ":LOD" << prim->lods.size() <<
+				" Op`=" << indices.size() / 3 << "->" << e.indices.size() / 3 <<
+				" 덷=" << e.error << "\n";
+		}
+	}
+
+	/**
+	* t@C풓Ǘɓo^
+	*
+	* @param file o^t@C
+	*
+	* t@CQƂȂȂA\Z𒴂Ƃɑޔ悤ɂȂ
+	* ޔt@CGetFileŗvꂽƂɓǂݍݒ
+	*/
+	void Buffer::RegisterResidency(const FilePtr& file)
+	{
+		size_t cpuBytes = sizeof(File) + file->materials.size() * sizeof(Material);
+		for (const Mesh& mesh : file->meshes)
+		{
+			cpuBytes += sizeof(Mesh) +
+				mesh.primitives.size() * (sizeof(Primitive) + sizeof(VertexArrayObject));
+		}
+		size_t gpuBytes = 0;
+		for (const BufferRange& e : file->vboRanges)
+		{
+			gpuBytes += e.size;
+		}
+		for (const BufferRange& e : file->iboRanges)
+		{
+			gpuBytes += e.size;
+		}
+
+		const std::string name = file->name;
+		const int id = Residency::Manager::Instance().Register(
+			Residency::Type::mesh, name, cpuBytes, gpuBytes, &file->usage,
+			[this, name]() {
+				const auto itr = files.find(name);
+				return itr != files.end() && itr->second.use_count() > 1;
+			},
+			[this, name]() {
+				const auto itr = files.find(name);
+				if (itr != files.end())
+				{
+					FreeRanges(itr->second->vboRanges, itr->second->iboRanges);
+					files.erase(itr);
+					evictedFiles.insert(name);
+				}
+			});
+		residencyIds.push_back(id);
 	}
 
 	/**
-	* _f[^ǉ
+	* CX^Xf[^ǉ
 	*
 	* @param data ǉf[^̃|C^
 	* @param size ǉf[^̃oCg
 	*
-	* @return f[^ǉʒu
-	*			CreateprimitivevOffsetp[^ƂĎgp
+	* @return f[^ǉʒu. ǉłȂꍇ-1
 	*/
-	GLintptr Buffer::AddVertexData(const void* data, size_t size)
+	GLintptr Buffer::AddInstanceData(const void* data, size_t size)
 	{
-		vbo.BufferSubData(vboEnd, size, data);
-		const GLintptr tmp = vboEnd;
-		vboEnd += ((size + 3) / 4) * 4;
-		return tmp;
+		return instanceBuffer.Push(data, size, sizeof(glm::vec4));
 	}
 
 	/**
-	* CfbNXf[^ǉ
+	* Ԑڕ`R}hǉ
 	*
-	* @param data ǉf[^̃|C^
-	* @param size ǉf[^̃oCg
+	* @param data ǉR}hz̃|C^
+	* @param size ǉR}hz̃oCg
 	*
-	* @return f[^ǉʒu
-	*			v~eBuindicesp[^ƂĎgƂo
+	* @return R}hǉʒu. ǉłȂꍇ-1
 	*/
-	GLintptr Buffer::AddIndexData(const void* data, size_t size)
+	GLintptr Buffer::AddIndirectCommandData(const void* data, size_t size)
+	{
+		return indirectBuffer.Push(data, size, sizeof(GLuint));
+	}
+
+	/**
+	* VAOɃCX^Xf[^̒_ݒ肷
+	*
+	* @param vao ݒ肷VAO
+	*
+	* _8`11oCfBOԍinstanceBindingIndexɊ蓖Ă
+	* `掞glBindVertexBufferŃCX^Xf[^̈ʒuw肷邱
+	*/
+	void Buffer::SetupInstanceAttributes(const VertexArrayObject& vao) const
 	{
-		ibo.BufferSubData(iboEnd, size, data);
-		const GLintptr tmp = iboEnd;
-		iboEnd += ((size + 3) / 4) * 4;
-		return tmp;
+		vao.Bind();
+		for (GLuint i = 0; i < 4; ++i)
+		{
+			const GLuint index = 8 + i;
+			glEnableVertexAttribArray(index);
+			glVertexAttribFormat(index, 4, GL_FLOAT, GL_FALSE,
+				static_cast<GLuint>(offsetof(InstanceData, matModel) + sizeof(glm::vec4) * i));
+			glVertexAttribBinding(index, instanceBindingIndex);
+		}
+		glVertexBindingDivisor(instanceBindingIndex, 1);
+
+		//LȒ_Ƀobt@蓖ĂĂȂԂȂ悤ɁA擪蓖ĂĂ
+		glBindVertexBuffer(instanceBindingIndex, instanceBuffer.Id(), 0, sizeof(InstanceData));
+		vao.Unbind();
 	}
 
 	/**
@@ -299,6 +1203,7 @@ namespace Mesh
 		vao->VertexAttribPointer(
 			2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), vOffset + offsetof(Vertex, normal));
 		vao->Unbind();
+		SetupInstanceAttributes(*vao);
 
 		//v~eBũoϐݒ
 		Primitive p;
@@ -322,17 +1227,63 @@ namespace Mesh
 	* @return 쐬Material\
 	*/
 	Material Buffer::CreateMaterial(
-		const glm::vec4& color, Texture::Image2DPtr texture) const
+		const glm::vec4& color, Texture::Image2DPtr texture)
 	{
 		Material m;
 		m.baseColor = color;
 		m.texture[0] = texture;
+		const GLintptr uboOffset = AllocateMaterialUniform(color);
+		if (uboOffset >= 0)
+		{
+			m.ubo = materialUbo;
+			m.uboOffset = uboOffset;
+		}
 		m.program = progStaticMesh;
 		m.progSkeletalMesh = progSkeletalMesh;
-		m.progShadow = progShadow;
+		m.progShadow = shadowShaders->Get();
+		m.progInstanced = meshShaders->Get({ { "INSTANCED", 1 } });
+		m.progShadowInstanced = shadowShaders->Get({ { "INSTANCED", 1 } });
 		return m;
 	}
 
+	/**
+	* }eA萔UBOɊi[
+	*
+	* @param color }eÅ{F
+	*
+	* @return 萔i[ʒu. i[łȂꍇ-1
+	*
+	* l̒萔1̗̈L
+	* 풓Ǘōēǂݍ݂ꂽ}eÄ̗ĝŁÄ͉Ȃ
+	*/
+	GLintptr Buffer::AllocateMaterialUniform(const glm::vec4& color)
+	{
+		if (!materialUbo)
+		{
+			return -1;
+		}
+		for (const auto& e : materialSlots)
+		{
+			if (e.first == color)
+			{
+				return e.second;
+			}
+		}
+		const GLintptr offset = static_cast<GLintptr>(materialSlots.size() * materialSlotSize);
+		if (offset + materialSlotSize > materialUbo->Size())
+		{
+			std::cerr << "[x]" << __func__ << ":}eA萔̍ő吔𒴂Ă܂\n";
+			return -1;
+		}
+		const MaterialUniformBlock data = { color };
+		if (!materialUbo->BufferSubData(&data, offset, sizeof(data)))
+		{
+			return -1;
+		}
+		materialSlots.emplace_back(color, offset);
+		return offset;
+	}
+
 	/**
 	* bVǉ
 	*
@@ -358,6 +1309,8 @@ namespace Mesh
 		p->meshes.resize(1);
 		p->meshes[0].name = name;
 		p->meshes[0].primitives.push_back(primitive);
+		SetupMeshBounds(p->meshes[0]);
+		SetupFileBounds(p->meshes, &p->aabb, &p->sphere);
 
 		files.insert(std::make_pair(p->name, p));
 		std::cout << "[]" << __func__ << ":bV" << name << "ǉ\n";
@@ -406,12 +1359,45 @@ namespace Mesh
 		int byteStride;
 		GetBuffer(accessor, bufferViews, binFiles, &p, &byteLength, &byteStride);
 		const GLenum componentType = accessor["componentType"].int_value();
+		const GLintptr offset = AllocateVertexData(byteLength);//4oCgEɐ
+		if (offset < 0)
+		{
+			return false;
+		}
 		prim->vao->Bind();
-		prim->vao->VertexAttribPointer(index, size, componentType, GL_FALSE, byteStride, vboEnd);
+		prim->vao->VertexAttribPointer(index, size, componentType, GL_FALSE, byteStride, offset);
 		prim->vao->Unbind();
 
-		vbo.BufferSubData(vboEnd, byteLength, p);
-		vboEnd += ((byteLength + 3) / 4) * 4;//4oCgEɐ
+		vbo.BufferSubData(offset, byteLength, p);
+		return true;
+	}
+
+	/**
+	* _f[^VBOɓ]A_ݒ肷
+	*
+	* @param prim _f[^ݒ肷v~eBu
+	* @param index ݒ肷钸_̃CfbNX
+	* @param stream ]钸_f[^
+	*
+	* @retval true ݒ萬
+	* @retval false _f[^A܂VBŐ󂫗̈悪Ȃ̂Őݒ肵Ȃ
+	*/
+	bool Buffer::SetVertexStream(Primitive* prim, GLuint index, const VertexStream& stream)
+	{
+		if (stream.data.empty())
+		{
+			return false;
+		}
+		const GLintptr offset = AllocateVertexData(stream.data.size());//4oCgEɐ
+		if (offset < 0)
+		{
+			return false;
+		}
+		vbo.BufferSubData(offset, stream.data.size(), stream.data.data());
+		prim->vao->Bind();
+		prim->vao->VertexAttribPointer(
+			index, stream.size, stream.type, stream.normalized, stream.stride, offset);
+		prim->vao->Unbind();
 		return true;
 	}
 
@@ -419,12 +1405,18 @@ namespace Mesh
 	* glTFt@Cǂݍ
 	*
 	* @param path glTFt@C
+	* @param option ǂݍ݃IvV
 	*
 	* @retval true ǂݍݐ
 	* retval false ǂݍݎs
 	*/
-	bool Buffer::LoadMesh(const char* path)
+	bool Buffer::LoadMesh(const char* path, const ImportOption& option)
 	{
+		if (files.find(path) != files.end())
+		{
+			return true;
+		}
+
 		//glTFt@Cǂݍ
 		std::vector<char> gltfFile = ReadFile(path);
 		if (gltfFile.empty())
@@ -463,8 +1455,14 @@ namespace Mesh
 		File& file = *pFile;
 
 		//_f[^ƃCfbNXf[^GPU֓]
+		//ޔɉł悤ɁAmۂ̈t@CɋL^
 		const json11::Json& accessors = json["accessors"];
 		const json11::Json& bufferViews = json["bufferViews"];
+		vboRangeLog = &file.vboRanges;
+		iboRangeLog = &file.iboRanges;
+		isOutOfSpace = false;
+		size_t rawVertexBytes = 0;
+		size_t vertexBytes = 0;
 		file.meshes.reserve(json["meshes"].array_items().size());
 		for (const auto& currentMesh : json["meshes"].array_items())
 		{
@@ -477,6 +1475,7 @@ namespace Mesh
 				const json11::Json& primitive = currentMesh["primitives"][primId];
 
 				//_CfbNX
+				std::vector<GLuint> indices;
 				{
 					const int accessorId_index = primitive["indices"].int_value();
 					const json11::Json& accessor = accessors[accessorId_index];
@@ -484,19 +1483,15 @@ namespace Mesh
 					{
 						std::cerr << "ERROR:CfbNXf[^ ^CvSCALARłȂĂ͂Ȃ܂\n";
 						std::cerr << "type =" << accessor["type"].string_value() << "\n";
+						vboRangeLog = nullptr;
+						iboRangeLog = nullptr;
+						FreeRanges(file.vboRanges, file.iboRanges);
 						return false;
 					}
+					ReadIndices(accessor, bufferViews, binFiles, &indices);
 					mesh.primitives[primId].mode =
 						primitive["mode"].is_null() ? GL_TRIANGLES : primitive["mode"].int_value();
-					mesh.primitives[primId].count = accessor["count"].int_value();
 					mesh.primitives[primId].type = accessor["componentType"].int_value();
-					mesh.primitives[primId].indices = reinterpret_cast<const GLvoid*>(iboEnd);
-
-					const void* p;
-					size_t byteLength;
-					GetBuffer(accessor, bufferViews, binFiles, &p, &byteLength);
-					ibo.BufferSubData(iboEnd, byteLength, p);
-					iboEnd += ((byteLength + 3) / 4) * 4;//ɗ̂ǂ̃f[^^łvȂ悤4oCgEɐ
 				}
 				//_
 				const json11::Json& attributes = primitive["attributes"];
@@ -507,17 +1502,57 @@ namespace Mesh
 					attributes["TEXCOORD_0"].is_null() ? -1 : attributes["TEXCOORD_0"].int_value();
 				mesh.primitives[primId].vao = std::make_shared<VertexArrayObject>();
 				mesh.primitives[primId].vao->Create(vbo.Id(), ibo.Id());
-				SetAttribute(&mesh.primitives[primId], 0,
-					accessors[accessorId_position], bufferViews, binFiles);
-				SetAttribute(&mesh.primitives[primId], 1,
-					accessors[accessorId_texcoord], bufferViews, binFiles);
-				SetAttribute(&mesh.primitives[primId], 2,
-					accessors[accessorId_normal], bufferViews, binFiles);
+				SetupInstanceAttributes(*mesh.primitives[primId].vao);
+				std::vector<VertexStream> streams(3);
+				ReadVertexStream(accessors[accessorId_position], bufferViews, binFiles, &streams[0]);
+				ReadVertexStream(accessors[accessorId_texcoord], bufferViews, binFiles, &streams[1]);
+				ReadVertexStream(accessors[accessorId_normal], bufferViews, binFiles, &streams[2]);
+				for (const VertexStream& e : streams)
+				{
+					rawVertexBytes += e.data.size();
+				}
+				if (option.optimize && mesh.primitives[primId].mode == GL_TRIANGLES)
+				{
+					MeshOptimizer::Optimize(indices, streams, mesh.name);
+				}
+				CalcPrimitiveBounds(&mesh.primitives[primId], accessors[accessorId_position], streams[0]);
+				AddLods(&mesh.primitives[primId], indices, streams[0], option);
+				if (option.quantize)
+				{
+					QuantizeVertexStreams(streams, &mesh.primitives[primId]);
+				}
+				for (size_t i = 0; i < streams.size(); ++i)
+				{
+					SetVertexStream(&mesh.primitives[primId], static_cast<GLuint>(i), streams[i]);
+					vertexBytes += streams[i].data.size();
+				}
+
+				//ɗ̂ǂ̃f[^^łvȂ悤4oCgEɐ񂵂ē]
+				mesh.primitives[primId].count = static_cast<GLsizei>(indices.size());
+				mesh.primitives[primId].indices = reinterpret_cast<const GLvoid*>(
+					AddIndexData(indices, mesh.primitives[primId].type));
 
 				mesh.primitives[primId].material = primitive["material"].int_value();
+
+				//obt@tȂA܂łɊmۂ̈ēǂݍ݂𒆎~
+				if (isOutOfSpace)
+				{
+					std::cerr << "[G[]" << __func__ << ":" << path <<
+						"i[󂫗̈悪܂\n";
+					vboRangeLog = nullptr;
+					iboRangeLog = nullptr;
+					FreeRanges(file.vboRanges, file.iboRanges);
+					return false;
+				}
 			}
+			SetupMeshBounds(mesh);
+			SetupLodParameters(mesh);
 			file.meshes.push_back(mesh);
 		}
+		vboRangeLog = nullptr;
+		iboRangeLog = nullptr;
+		SetupFileBounds(file.meshes, &file.aabb, &file.sphere);
+
 		//}eA擾
 		{
 			const std::vector<json11::Json> materials = json["materials"].array_items();
@@ -557,8 +1592,20 @@ namespace Mesh
 		}
 		file.name = path;
 		files.insert(std::make_pair(file.name, pFile));
+		const bool isReload = evictedFiles.erase(file.name) > 0;
+		importOptions[file.name] = option;
+		RegisterResidency(pFile);
 
+		//ޔt@C̓ǂݍݒ͕pɂɋN̂ŕ\Ȃ
+		if (isReload)
+		{
+			return true;
+		}
 		std::cout << "[INFO]" << __func__ << ":" << path << "ǂݍ݂܂\n";
+		if (option.quantize)
+		{
+			std::cout << "_f[^ʎq:" << rawVertexBytes << "->" << vertexBytes << "oCg\n";
+		}
 		for (size_t i = 0; i < file.meshes.size(); i++)
 		{
 			std::cout << "mesh[" << i << "] =" << file.meshes[i].name << "\n";
@@ -572,10 +1619,20 @@ namespace Mesh
 	* @param name 擾t@C̖O
 	*
 	* @param nameƓObVt@C
+	*
+	* 풓Ǘɂđޔꂽt@ĆAǂݍݒĂԂ
 	*/
-	FilePtr Buffer::GetFile(const char* name) const
+	FilePtr Buffer::GetFile(const char* name)
 	{
-		const auto itr = files.find(name);
+		auto itr = files.find(name);
+		if (itr == files.end() && evictedFiles.count(name))
+		{
+			Residency::Manager::Instance().CountReload();
+			if (LoadMesh(name, importOptions[name]))
+			{
+				itr = files.find(name);
+			}
+		}
 		if (itr == files.end())
 		{
 			std::cerr << "[x]" << __func__ << ":" << name <<
@@ -638,12 +1695,17 @@ namespace Mesh
 			}
 		}
 		//bVǉ
-		const size_t vOffset =
+		const GLintptr vOffset =
 			AddVertexData(vertices.data(), vertices.size() * sizeof(Vertex));
-		const size_t iOffset =
+		const GLintptr iOffset =
 			AddIndexData(indices.data(), indices.size() * sizeof(GLubyte));
-		const Primitive p =
+		if (vOffset < 0 || iOffset < 0)
+		{
+			return;
+		}
+		Primitive p =
 			CreatePrimitive(indices.size(), GL_UNSIGNED_BYTE, iOffset, vOffset);
+		CalcBounds(vertices.data(), vertices.size(), &p);
 		const Material m = CreateMaterial(glm::vec4(1), nullptr);
 		AddMesh(name, p, m);
 	}
@@ -664,8 +1726,12 @@ namespace Mesh
 		};
 		const GLubyte i[] = { 0,1,2,2,3,0 };
 
-		const size_t vOffset = AddVertexData(v, sizeof(v));
-		const size_t iOffset = AddIndexData(i, sizeof(i));
+		const GLintptr vOffset = AddVertexData(v, sizeof(v));
+		const GLintptr iOffset = AddIndexData(i, sizeof(i));
+		if (vOffset < 0 || iOffset < 0)
+		{
+			return nullptr;
+		}
 		const Primitive p = CreatePrimitive(6, GL_UNSIGNED_BYTE, iOffset, vOffset);
 		const Material m = CreateMaterial(glm::vec4(1), nullptr);
 		AddMesh(name, p, m);
@@ -678,43 +1744,45 @@ namespace Mesh
 	*
 	* @param matVP r[ vWFNVs
 	*/
-	void Buffer::SetViewProjectionMatrix(const glm::mat4& matVP) const
+	void Buffer::SetViewProjectionMatrix(const glm::mat4& matVP)
 	{
-		progStaticMesh->Use();
-		progStaticMesh->SetViewProjectionMatrix(matVP);
-		progSkeletalMesh->Use();
-		progSkeletalMesh->SetViewProjectionMatrix(matVP);
-		progTerrain->Use();
+		matViewProjection = matVP;
+		const auto f = [&matVP](Shader::Program& p) { p.SetViewProjectionMatrix(matVP); };
+		meshShaders->ForEach(f);
 		progTerrain->SetViewProjectionMatrix(matVP);
-		progWater->Use();
 		progWater->SetViewProjectionMatrix(matVP);
-		glUseProgram(0);
 	}
 
 	/**
-	* VF[_ɉep̃r[vWFNVsݒ肷
+	* epVF[_[ɉe`悷Ƃ̃r[vWFNVsݒ肷
 	*
 	* @param matVP epr[vWFNVs
+	*
+	* JXP[hVhE}bvł́AJXP[h`悷邽тɌĂяo
 	*/
-	void Buffer::SetShadowViewProjectionMatrix(const glm::mat4& matVP) const
+	void Buffer::SetShadowViewProjectionMatrix(const glm::mat4& matVP)
 	{
-		progStaticMesh->Use();
-		progStaticMesh->SetShadowViewProjectionMatrix(matVP);
-		progSkeletalMesh->Use();
-		progSkeletalMesh->SetShadowViewProjectionMatrix(matVP);
-		progTerrain->Use();
-		progTerrain->SetShadowViewProjectionMatrix(matVP);
-		progWater->Use();
-		progWater->SetShadowViewProjectionMatrix(matVP);
+		matShadowViewProjection = matVP;
+
+		//epVF[_[ɂ͒ʏ̃r[vWFNVsƂĐݒ肷
+		shadowShaders->ForEach([&matVP](Shader::Program& p) { p.SetViewProjectionMatrix(matVP); });
+	}
 
-		//epVF[_[ɂ͒ʏ̃r[vWFNVsݒ肷
-		progShadow->Use();
-		progShadow->SetViewProjectionMatrix(matVP);
-		progNonTexturedShadow->Use();
-		progNonTexturedShadow->SetShadowViewProjectionMatrix(matVP);
-		progSkeletalShadow->Use();
-		progSkeletalShadow->SetShadowViewProjectionMatrix(matVP);
-		glUseProgram(0);
+	/**
+	* VF[_[ɉepeNX`QƂ邽߂̍sݒ肷
+	*
+	* @param count s̐(shadowCascadeCountȉ)
+	* @param m     [hWeJXP[h̃eNX`W(0`1)ɕϊs̔z
+	*/
+	void Buffer::SetShadowMatrices(int count, const glm::mat4* m)
+	{
+		shadowMatrixCount = std::min(count, shadowCascadeCount);
+		std::copy(m, m + shadowMatrixCount, matShadowTexture);
+		const auto f = [this](Shader::Program& p) {
+			p.SetShadowViewProjectionMatrix(shadowMatrixCount, matShadowTexture); };
+		meshShaders->ForEach(f);
+		f(*progTerrain);
+		f(*progWater);
 	}
 
 
@@ -723,17 +1791,13 @@ namespace Mesh
 	*
 	* @param pos J̃[hW
 	*/
-	void Buffer::SetCameraPosition(const glm::vec3& pos) const
+	void Buffer::SetCameraPosition(const glm::vec3& pos)
 	{
-		progStaticMesh->Use();
-		progStaticMesh->SetCameraPostion(pos);
-		progSkeletalMesh->Use();
-		progSkeletalMesh->SetCameraPostion(pos);
-		progTerrain->Use();
+		cameraPosition = pos;
+		const auto f = [&pos](Shader::Program& p) { p.SetCameraPostion(pos); };
+		meshShaders->ForEach(f);
 		progTerrain->SetCameraPostion(pos);
-		progWater->Use();
 		progWater->SetCameraPostion(pos);
-		glUseProgram(0);
 	}
 
 	/**
@@ -741,19 +1805,45 @@ namespace Mesh
 	*
 	* @param time AvNĂ̌oߎ(b)
 	*/
-	void Buffer::SetTime(double time) const
+	void Buffer::SetTime(double time)
 	{
 		const float ftime = static_cast<float>(std::fmod(time, 24 * 60 * 60));
-		progStaticMesh->Use();
-		progStaticMesh->SetTime(ftime);
-		progSkeletalMesh->Use();
-		progSkeletalMesh->SetTime(ftime);
-		progTerrain->Use();
+		this->time = ftime;
+		const auto f = [ftime](Shader::Program& p) { p.SetTime(ftime); };
+		meshShaders->ForEach(f);
 		progTerrain->SetTime(ftime);
-		progWater->Use();
 		progWater->SetTime(ftime);
-		glUseProgram(0);
+	}
+
+	/**
+	* L^Ăt[Ƃuniformϐݒ肷
+	*
+	* @param program    ݒ̃VF[_[
+	* @param shadowPass epVF[_[Ȃtrue
+	*
+	* t[̓rō쐬ꂽVF[_[̔hłɂlݒ肳悤ɂ
+	*/
+	void Buffer::ApplyFrameUniforms(Shader::Program& program, bool shadowPass) const
+	{
+		if (shadowPass)
+		{
+			program.SetViewProjectionMatrix(matShadowViewProjection);
+			return;
+		}
+		program.SetViewProjectionMatrix(matViewProjection);
+		program.SetShadowViewProjectionMatrix(shadowMatrixCount, matShadowTexture);
+		program.SetCameraPostion(cameraPosition);
+		program.SetTime(time);
+	}
 
+	/**
+	* 쐬ς݂̃VF[_[̔hł̐擾
+	*
+	* @return hł̐
+	*/
+	size_t Buffer::GetShaderVariantCount() const
+	{
+		return meshShaders->Size() + shadowShaders->Size();
 	}
 
 	/**
@@ -764,8 +1854,8 @@ namespace Mesh
 	void Buffer::BindShadowTexture(const Texture::InterfacePtr& texture)
 	{
 		shadowTextureTarget = texture->Target();
-		glActiveTexture(GL_TEXTURE0 + Shader::Program::shadowTextureBindingPoint);
-		glBindTexture(shadowTextureTarget, texture->Get());
+		GLState::BindTexture(Shader::Program::shadowTextureBindingPoint,
+			shadowTextureTarget, texture->Get());
 	}
 
 	/**
@@ -775,27 +1865,291 @@ namespace Mesh
 	{
 		if (shadowTextureTarget != GL_NONE)
 		{
-			glActiveTexture(GL_TEXTURE0 + Shader::Program::shadowTextureBindingPoint);
-			glBindTexture(shadowTextureTarget, 0);
+			GLState::BindTexture(Shader::Program::shadowTextureBindingPoint,
+				shadowTextureTarget, 0);
 			shadowTextureTarget = GL_NONE;
 		}
 	}
 
+	namespace /* unnamed */
+	{
+		/**
+		* LODIɎg_̏
+		*/
+		struct LodView
+		{
+			glm::vec3 position = glm::vec3(0);//_̍W
+			float projectionScale = 1;//1̈ʒuɂ钷1̂̉̕ʏ̃sNZ
+			float errorThreshold = 1;//e덷̃sNZ
+			float hysteresis = 0.25f;//eLOD֐؂ւƂɁAe덷䗦
+		};
+		LodView lodView;
+
+		/**
+		* JȌ
+		*/
+		struct CullingState
+		{
+			bool enabled = false;
+			Collision::Frustum frustum;
+			CullingStatistics statistics[2];//DrawTypeƂ̌
+			OcclusionCuller* occlusion = nullptr;//ՕJOɎg[xobt@
+		};
+		CullingState culling;
+
+	} // unnamed namespace
+
+	/**
+	* JOLɂ
+	*
+	* @param frustum `͈͂\[hWn̎
+	*
+	* DisableCullingĂԂ܂ŁADraw֐͎̊Oɂ郁bV`悵Ȃ
+	*/
+	void EnableCulling(const Collision::Frustum& frustum)
+	{
+		culling.enabled = true;
+		culling.frustum = frustum;
+	}
+
+	/**
+	* JO𖳌ɂ
+	*/
+	void DisableCulling()
+	{
+		culling.enabled = false;
+	}
+
+	/**
+	* `͈͂ɂ邩ׂ
+	*
+	* @param s [hWn̋
+	*
+	* @retval true  `͈͂ɂA܂̓JO
+	* @retval false `͈͂̊Oɂ
+	*/
+	bool IsVisible(const Collision::Sphere& s)
+	{
+		return !culling.enabled || Collision::TestFrustumSphere(culling.frustum, s);
+	}
+
+	/**
+	* AABB`͈͂ɂ邩ׂ
+	*
+	* @param box [hWnAABB
+	*
+	* @retval true  `͈͂ɂA܂̓JO
+	* @retval false `͈͂̊Oɂ
+	*/
+	bool IsVisible(const Collision::AABB& box)
+	{
+		return !culling.enabled || Collision::TestFrustumAABB(culling.frustum, box);
+	}
+
+	/**
+	* t@C`͈͂ɂAՕɉBĂȂׂ
+	*
+	* @param file ׂt@C
+	* @param matM t@C̕`Ɏgp郂fs
+	*
+	* @retval true  `悷Kv(E{[Ȃꍇ܂)
+	* @retval false ̊Oɂ邩AՕɊSɉBĂ
+	*/
+	bool IsVisible(const File& file, const glm::mat4& matM)
+	{
+		if (file.sphere.r <= 0)
+		{
+			return true;
+		}
+		if (!IsVisible(Collision::TransformSphere(file.sphere, matM)))
+		{
+			return false;
+		}
+		const Collision::AABB box = Collision::TransformAABB(file.aabb, matM);
+		return IsVisible(box) && (!culling.occlusion || culling.occlusion->IsVisible(box));
+	}
+
+	/**
+	* ՕɊSɉBĂ邩ׂ
+	*
+	* @param s [hWn̋
+	*
+	* @retval true  ՕɊSɉBĂ
+	* @retval false Ă\A܂͎ՕJO
+	*
+	* Օ̐[xobt@AABBŔ肷̂ŁA͂AABBŒׂ
+	*/
+	bool IsOccluded(const Collision::Sphere& s)
+	{
+		if (!culling.occlusion)
+		{
+			return false;
+		}
+		Collision::AABB box;
+		box.min = s.center - glm::vec3(s.r);
+		box.max = s.center + glm::vec3(s.r);
+		return !culling.occlusion->IsVisible(box);
+	}
+
+	/**
+	* ՕJOLɂ
+	*
+	* @param culler Օ`ς݂̐[xobt@
+	*
+	* DisableOcclusionCullingĂԂ܂ŁA`L[Draw֐͎ՕɉBꂽt@C`悵Ȃ
+	*/
+	void EnableOcclusionCulling(OcclusionCuller* culler)
+	{
+		culling.occlusion = culler;
+	}
+
+	/**
+	* ՕJO𖳌ɂ
+	*/
+	void DisableOcclusionCulling()
+	{
+		culling.occlusion = nullptr;
+	}
+
+	/**
+	* JǑʂL^
+	*
+	* @param drawType `悷f[^̎
+	* @param drawn    `悵v~eBu̐
+	* @param culled   `悵Ȃv~eBu̐
+	*/
+	void AddCullingStatistics(DrawType drawType, size_t drawn, size_t culled)
+	{
+		CullingStatistics& e = culling.statistics[static_cast<int>(drawType)];
+		e.drawn += drawn;
+		e.culled += culled;
+	}
+
+	/**
+	* JǑʂ0ɖ߂
+	*
+	* 1t[1A`n߂OɌĂяo
+	*/
+	void ResetCullingStatistics()
+	{
+		for (CullingStatistics& e : culling.statistics)
+		{
+			e = CullingStatistics();
+		}
+	}
+
+	/**
+	* JǑʂ擾
+	*
+	* @param drawType `悷f[^̎
+	*
+	* @return OResetCullingStatisticsĂł̌
+	*/
+	const CullingStatistics& GetCullingStatistics(DrawType drawType)
+	{
+		return culling.statistics[static_cast<int>(drawType)];
+	}
+
+	/**
+	* LODIɎg_ݒ肷
+	*
+	* @param viewPosition _̍W
+	* @param fovY         ̎p(WA)
+	* @param screenHeight `̍(sNZ)
+	*
+	* `ɎgvWFNVsƓlݒ肷邱
+	*/
+	void SetLodView(const glm::vec3& viewPosition, float fovY, float screenHeight)
+	{
+		lodView.position = viewPosition;
+		lodView.projectionScale = screenHeight * 0.5f / std::tan(fovY * 0.5f);
+	}
+
+	/**
+	* LODIŋe덷ݒ肷
+	*
+	* @param pixels e덷̃sNZ
+	*/
+	void SetLodErrorThreshold(float pixels)
+	{
+		lodView.errorThreshold = pixels;
+	}
+
+	/**
+	* ʏ̌덷LODI
+	*
+	* @param mesh       LODI郁bV
+	* @param matM       bṼfs
+	* @param currentLod ݂LOD
+	*
+	* @return ILOD
+	*
+	* E̍ł߂_ł̌덷̃sNZelȉɂȂAłeLODI
+	* Et߂Ŗt[LOD؂ւȂ悤ɁAeLOD֐؂ւƂ
+	* el
+	*/
+	int SelectLod(const Mesh& mesh, const glm::mat4& matM, int currentLod)
+	{
+		if (mesh.lodErrors.size() <= 1)
+		{
+			return 0;
+		}
+		const glm::vec3 center(matM * glm::vec4(mesh.sphere.center, 1));
+		const float scale = std::max(std::max(
+			glm::length(glm::vec3(matM[0])), glm::length(glm::vec3(matM[1]))),
+			glm::length(glm::vec3(matM[2])));
+		const float distance = std::max(
+			glm::length(center - lodView.position) - mesh.sphere.r * scale, 0.1f);
+		const float pixelsPerUnit = lodView.projectionScale * scale / distance;
+
+		const int lodCount = static_cast<int>(mesh.lodErrors.size());
+		int lod = 0;
+		while (lod + 1 < lodCount &&
+			mesh.lodErrors[lod + 1] * pixelsPerUnit <= lodView.errorThreshold)
+		{
+			++lod;
+		}
+		const float coarserThreshold = lodView.errorThreshold * (1.0f - lodView.hysteresis);
+		while (lod > currentLod && mesh.lodErrors[lod] * pixelsPerUnit > coarserThreshold)
+		{
+			--lod;
+		}
+		return lod;
+	}
+
 	/**
 	* bV`悷
 	*
 	* @param file `悷t@C
 	* @param matM `Ɏgp郂fs
+	* @param drawType `悷f[^̎
+	* @param lod `悷ڍדx(LOD)
 	*/
-	void Draw(const FilePtr& file, const glm::mat4& matM,DrawType drawType)
+	void Draw(const FilePtr& file, const glm::mat4& matM, DrawType drawType, int lod)
 	{
 		if (!file || file->meshes.empty() || file->materials.empty())
 		{
 			return;
 		}
+		file->usage.Touch();
 		const Mesh& mesh = file->meshes[0];
+
+		//̊Oɂ邩ՕɉBĂΕ`悵Ȃ(E{[ȂbV͏ɕ`悷)
+		const bool hasBounds = file->sphere.r > 0;
+		if (!IsVisible(*file, matM))
+		{
+			AddCullingStatistics(drawType, 0, mesh.primitives.size());
+			return;
+		}
+		const bool testPrimitives = hasBounds && mesh.primitives.size() > 1;
+
 		for (const Primitive& p : mesh.primitives)
 		{
+			if (testPrimitives && !IsVisible(Collision::TransformAABB(p.aabb, matM)))
+			{
+				AddCullingStatistics(drawType, 0, 1);
+				continue;
+			}
 			if (p.material < file->materials.size())
 			{
 				p.vao->Bind();
@@ -807,26 +2161,17 @@ namespace Mesh
 				}
 				program->Use();
 				program->SetModelMatrix(matM);
+				program->SetPositionQuantization(p.positionScale, p.positionOffset);
 
-				//eNX`鎞́ÃeNX`IDݒ肷BȂ0ɂ
-				for (int i = 0; i < sizeof(m.texture) / sizeof(m.texture[0]); i++)
-				{
-					glActiveTexture(GL_TEXTURE0 + i);
-					if (m.texture[i])
-					{
-						glBindTexture(m.texture[i]->Target(),m.texture[i]->Get());
-					}
-					else
-					{
-						glBindTexture(GL_TEXTURE_2D, 0);
-					}
-				}
-				glDrawElementsBaseVertex(p.mode, p.count, p.type, p.indices, p.baseVertex);
-				p.vao->Unbind();
+				BindMaterial(m);
+				GLsizei count;
+				const GLvoid* indices;
+				GetLodIndices(p, lod, &count, &indices);
+				glDrawElementsBaseVertex(p.mode, count, p.type, indices, p.baseVertex);
+				RenderStats::AddDrawCall();
+				RenderStats::AddPrimitives(p.mode, count);
+				AddCullingStatistics(drawType, 1, 0);
 			}
 		}
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, 0);
-		glUseProgram(0);
 	}
 }//namespae Mesh
\ No newline at end of file
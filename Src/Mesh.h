@@ -5,14 +5,21 @@
 #define MESH_H_INCLUDED
 #include <GL/glew.h>
 #include "BufferObject.h"
+#include "StreamingBuffer.h"
+#include "UniformBuffer.h"
 #include "Texture.h"
 #include "Shader.h"
+#include "Residency.h"
+#include "Collision.h"
+#include "OcclusionCuller.h"
 #include "json11/json11.hpp"
 #include <glm/glm.hpp>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <memory>
+#include <cstdint>
 
 namespace Mesh
 {
@@ -38,6 +45,14 @@ namespace Mesh
 		glm::vec2 texCoord;
 		glm::vec3 normal;
 	};
+	/**
+	* }eA萔(VF[_[MaterialUniformBlockɑΉ)
+	*/
+	struct MaterialUniformBlock
+	{
+		glm::vec4 baseColor;
+	};
+
 	/**
 	* v~eBu̍ގ
 	*/
@@ -45,9 +60,30 @@ namespace Mesh
 	{
 		glm::vec4 baseColor = glm::vec4(1);
 		Texture::InterfacePtr texture[16];
+
+		//}eA萔i[UBOƁÄʒu(ubonullptrȂ}eA萔gȂ)
+		UniformBufferPtr ubo;
+		GLintptr uboOffset = 0;
 		Shader::ProgramPtr program;
 		Shader::ProgramPtr progSkeletalMesh;//XP^bVp̃VF[_[
 		Shader::ProgramPtr progShadow;
+
+		//CX^X`p̃VF[_[(nullptrȂCX^X`悵Ȃ)
+		//epƃCX^X`ṕACreateMaterialBuffer̔hłIŐݒ肷
+		//(`̂тɔhłTȂ悤ɁA}eAɕێĂ)
+		Shader::ProgramPtr progInstanced;
+		Shader::ProgramPtr progShadowInstanced;
+	};
+	/**
+	* ȗv~eBu̕`p[^
+	*
+	* _f[^͌̃v~eBuƋL
+	*/
+	struct PrimitiveLod
+	{
+		GLsizei count = 0;
+		const GLvoid* indices = nullptr;
+		float error = 0;//̃v~eBǔ덷(IuWFNgWn̋)
 	};
 	/**
 	* _f[^̕`p[^
@@ -61,7 +97,62 @@ namespace Mesh
 		GLint baseVertex = 0;
 		std::shared_ptr<VertexArrayObject> vao;
 		int material = 0;
+
+		//ʎqꂽ_W𕜌邽߂̃p[^
+		glm::vec3 positionScale = glm::vec3(1);
+		glm::vec3 positionOffset = glm::vec3(0);
+
+		std::vector<PrimitiveLod> lods;//ڍדx(LOD)1ȍ~̕`p[^(ڍׂȏ)
+
+		//E{[(IuWFNgWn)
+		Collision::AABB aabb;
+		Collision::Sphere sphere;
+	};
+	/**
+	* _f[^
+	*
+	* vfstrideoCgƂɌԂȂ
+	*/
+	struct VertexStream
+	{
+		GLint size = 0;//VF[_[ɓn
+		GLenum type = GL_FLOAT;//̌^
+		GLboolean normalized = GL_FALSE;//^̐𐳋KȂGL_TRUE
+		GLsizei stride = 0;//1vf̃oCg
+		std::vector<uint8_t> data;//vff[^
+
+		size_t Count() const { return stride ? data.size() / stride : 0; }
+	};
+
+	/**
+	* bVǂݍ݃IvV
+	*/
+	struct ImportOption
+	{
+		//_f[^ʎq
+		//_W16bitKAeNX`W16bit_A
+		//@10_10_10_2`AEFCg8bitKŊi[
+		bool quantize = false;
+
+		//d_̓A_LbVEI[o[h[E_ǂݍݏ̍œKs
+		bool optimize = true;
+
+		//ڍדx(LOD)̐(̃bV܂. 1ȂLOD𐶐Ȃ)
+		int lodCount = 1;
+
+		//LOD1iK邲Ƃ̃CfbNX̔䗦
+		float lodReduction = 0.5f;
+	};
+
+	/**
+	* obt@IuWFNg̗̈
+	*/
+	struct BufferRange
+	{
+		GLintptr offset = 0;//̈̊Jnʒu
+		GLsizeiptr size = 0;//̈̃oCg
 	};
+
 	/**
 	* bV
 	*/
@@ -69,6 +160,13 @@ namespace Mesh
 	{
 		std::string name;//bV
 		std::vector<Primitive> primitives;
+
+		//Sv~eBu͂ދE{[(IuWFNgWn)
+		Collision::AABB aabb;
+		Collision::Sphere sphere;
+
+		//eLOĎ̃bV̌덷(IuWFNgWn̋. [0]͌̃bV)
+		std::vector<float> lodErrors;
 	};
 	/**
 	*t@C
@@ -78,9 +176,30 @@ namespace Mesh
 		std::string name;//t@C
 		std::vector<Mesh> meshes;
 		std::vector<Material> materials;
+
+		//SbV͂ދE{[(IuWFNgWn)
+		Collision::AABB aabb;
+		Collision::Sphere sphere;
+
+		//풓Ǘp̏
+		std::vector<BufferRange> vboRanges;//gpĂVBÖ̗
+		std::vector<BufferRange> iboRanges;//gpĂIBÖ̗
+		Residency::Usage usage;//Ōɕ`悳ꂽt[
 	};
 	using FilePtr = std::shared_ptr<File>;
 
+	/**
+	* CX^X`1CX^XƂɓnf[^
+	*
+	* INSTANCED`StaticMesh.vert͕̓ϐ(location=8`11)ƑΉ
+	*/
+	struct InstanceData
+	{
+		glm::mat4 matModel;
+	};
+	const GLuint instanceBindingIndex = 15;//CX^Xf[^蓖ĂoCfBOԍ
+	const int shadowCascadeCount = 4;//JXP[hVhE}bv̕(VF[_[matShadow̗vfƈv邱)
+
 	/**
 	*bVǗNX
 	*/
@@ -88,23 +207,30 @@ namespace Mesh
 	{
 	public:
 		Buffer() = default;
-		~Buffer() = default;
+		~Buffer();
 
 		bool Init(GLsizeiptr vboSize, GLsizeiptr iboSize);
 		GLintptr AddVertexData(const void* data, size_t size);
 		GLintptr AddIndexData(const void* data, size_t size);
+		GLintptr AddIndexData(const std::vector<GLuint>& indices, GLenum type);
+		GLintptr AddInstanceData(const void* data, size_t size);
+		GLuint GetInstanceBuffer() const { return instanceBuffer.Id(); }
+		GLintptr AddIndirectCommandData(const void* data, size_t size);
+		GLuint GetIndirectBuffer() const { return indirectBuffer.Id(); }
 		Primitive CreatePrimitive(
 			size_t count, GLenum type, size_t iOffset, size_t vOffset) const;
-		Material CreateMaterial(const glm::vec4& color, Texture::Image2DPtr texture) const;
+		Material CreateMaterial(const glm::vec4& color, Texture::Image2DPtr texture);
 		bool AddMesh(const char* name, const Primitive& primitive, const Material& material);
 		bool SetAttribute(Primitive*, int, const json11::Json&, const json11::Json&,
 			const std::vector<std::vector<char>>&);
-		bool LoadMesh(const char* path);
-		FilePtr GetFile(const char* name) const;
-		void SetViewProjectionMatrix(const glm::mat4&) const;
-		void SetShadowViewProjectionMatrix(const glm::mat4&) const;
-		void SetCameraPosition(const glm::vec3&) const;
-		void SetTime(double) const;
+		bool SetVertexStream(Primitive*, GLuint index, const VertexStream&);
+		bool LoadMesh(const char* path, const ImportOption& option = ImportOption());
+		FilePtr GetFile(const char* name);
+		void SetViewProjectionMatrix(const glm::mat4&);
+		void SetShadowViewProjectionMatrix(const glm::mat4&);
+		void SetShadowMatrices(int count, const glm::mat4* m);
+		void SetCameraPosition(const glm::vec3&);
+		void SetTime(double);
 		void BindShadowTexture(const Texture::InterfacePtr&);
 		void UnbindShadowTexture();
 
@@ -112,34 +238,73 @@ namespace Mesh
 		FilePtr AddPlane(const char* name);
 
 		//XP^Aj[VɑΉbV̓ǂݍ݂Ǝ擾
-		bool LoadSkeletalMesh(const char* path);
-		SkeletalMeshPtr GetSkeletalMesh(const char* meshName) const;
+		bool LoadSkeletalMesh(const char* path, const ImportOption& option = ImportOption());
+		SkeletalMeshPtr GetSkeletalMesh(const char* meshName);
 
 		const Shader::ProgramPtr& GetStaticMeshShader() const { return progStaticMesh; }
 		const Shader::ProgramPtr& GetTerrainShader() const { return progTerrain; }
 		const Shader::ProgramPtr& GetWaterShader() const { return progWater; }
 		const Shader::ProgramPtr& GetSkeletalMeshShader() const { return progSkeletalMesh; }
-		const Shader::ProgramPtr& GetShadowShader() const { return progShadow; }
-		const Shader::ProgramPtr& GetNonTexturedShadowShader() const {
-			return progNonTexturedShadow; }
-		const Shader::ProgramPtr& GetSkeletalShadowShader() const {
-			return progSkeletalShadow; }
+		const Shader::ProgramVariantsPtr& GetMeshShaders() const { return meshShaders; }
+		const Shader::ProgramVariantsPtr& GetShadowShaders() const { return shadowShaders; }
+		size_t GetShaderVariantCount() const;
 
 	private:
+		GLintptr AllocateVertexData(size_t size);
+		GLintptr AllocateIndexData(size_t size);
+		void FreeRanges(const std::vector<BufferRange>& vboRanges,
+			const std::vector<BufferRange>& iboRanges);
+		void RegisterResidency(const FilePtr& file);
+		void RegisterResidency(const ExtendedFilePtr& file);
+		void AddLods(Primitive* prim, const std::vector<GLuint>& indices,
+			const VertexStream& positions, const ImportOption& option);
+		void SetupInstanceAttributes(const VertexArrayObject& vao) const;
+		GLintptr AllocateMaterialUniform(const glm::vec4& color);
+		void ApplyFrameUniforms(Shader::Program& program, bool shadowPass) const;
+
 		BufferObject vbo;
 		BufferObject ibo;
 		GLintptr vboEnd = 0;
 		GLintptr iboEnd = 0;
+		GLsizeiptr vboCapacity = 0;//VBÕoCg
+		GLsizeiptr iboCapacity = 0;//IBÕoCg
+		bool isOutOfSpace = false;//VBOIBÖ̗mۂłȂtrue
+
+		//t[CX^Xf[^ƊԐڕ`R}hp̃obt@
+		StreamingBuffer instanceBuffer;
+		StreamingBuffer indirectBuffer;
+
+		//}eA萔pUBO
+		UniformBufferPtr materialUbo;
+		GLsizeiptr materialSlotSize = 0;//}eA1̗̈̃oCg(ς)
+		std::vector<std::pair<glm::vec4, GLintptr>> materialSlots;//蓖čς݂̒萔ƈʒu
 		std::unordered_map<std::string, FilePtr> files;
+
+		//풓Ǘp̕ϐ
+		std::vector<BufferRange> vboFreeList;//ꂽVBÖ̗(Jnʒȕ)
+		std::vector<BufferRange> iboFreeList;//ꂽIBÖ̗(Jnʒȕ)
+		std::vector<BufferRange>* vboRangeLog = nullptr;//ǂݍݒ̃t@CgVBÖ̋L^
+		std::vector<BufferRange>* iboRangeLog = nullptr;//ǂݍݒ̃t@CgIBÖ̋L^
+		std::vector<int> residencyIds;//풓Ǘ̓o^ID
+		std::unordered_map<std::string, ImportOption> importOptions;//ēǂݍݗp̓ǂݍ݃IvV
+		std::unordered_set<std::string> evictedFiles;//ޔt@C
+		std::unordered_map<std::string, std::string> evictedSkeletalMeshes;//ޔbVƓǂݍ݌t@C
+		//StaticMesh.vert/.fragɃ}N`}čVF[_[̔h
+		Shader::ProgramVariantsPtr meshShaders;//ʏ̕`p(XP^bVSKINNED`)
+		Shader::ProgramVariantsPtr shadowShaders;//e̕`p
+
+		//hł쐬Ƃɐݒ肷邽߁At[Ƃuniformϐ̒lL^Ă
+		glm::mat4 matViewProjection = glm::mat4(1);
+		glm::mat4 matShadowViewProjection = glm::mat4(1);
+		glm::mat4 matShadowTexture[shadowCascadeCount];
+		int shadowMatrixCount = 0;
+		glm::vec3 cameraPosition = glm::vec3(0);
+		float time = 0;
+
 		Shader::ProgramPtr progStaticMesh;
 		Shader::ProgramPtr progTerrain;
 		Shader::ProgramPtr progWater;
 
-		//ep̃VF[_[
-		Shader::ProgramPtr progShadow;
-		Shader::ProgramPtr progNonTexturedShadow;
-		Shader::ProgramPtr progSkeletalShadow;
-
 		//^Aj[VɑΉbVێ郁oϐ
 		Shader::ProgramPtr progSkeletalMesh;
 		struct MeshIndex
@@ -162,6 +327,35 @@ namespace Mesh
 		shadow,//e̕`
 	};
 	void Draw(const FilePtr&, const glm::mat4& matM,
-		DrawType drowType = DrawType::color);
+		DrawType drowType = DrawType::color, int lod = 0);
+	void CalcBounds(const Vertex* vertices, size_t count, Primitive* prim);
+
+	//ڍדx(LOD)̑I
+	void SetLodView(const glm::vec3& viewPosition, float fovY, float screenHeight);
+	void SetLodErrorThreshold(float pixels);
+	int SelectLod(const Mesh& mesh, const glm::mat4& matM, int currentLod);
+
+	/**
+	* JǑ
+	*/
+	struct CullingStatistics
+	{
+		size_t drawn = 0;//`悵v~eBu̐
+		size_t culled = 0;//̊Oɂ邩AՕɉBĂ邽ߕ`悵Ȃv~eBu̐
+	};
+
+	//JO
+	void EnableCulling(const Collision::Frustum&);
+	void DisableCulling();
+	bool IsVisible(const Collision::Sphere&);
+	bool IsVisible(const Collision::AABB&);
+	bool IsVisible(const File&, const glm::mat4& matM);
+	void ResetCullingStatistics();
+
+	//ՕJO
+	void EnableOcclusionCulling(OcclusionCuller*);
+	void DisableOcclusionCulling();
+	bool IsOccluded(const Collision::Sphere&);
+	const CullingStatistics& GetCullingStatistics(DrawType);
 }//namespace Mesh
 #endif //MESH_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,654 @@
+/**
+* @file MeshOptimizer.cpp
+*/
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <unordered_map>
+#include <iostream>
+#include <cmath>
+
+namespace Mesh
+{
+	// Implemented in Mesh.cpp
+	glm::vec4 GetVertexStreamElement(const VertexStream& stream, size_t i);
+}
+
+namespace MeshOptimizer
+{
+	namespace /* unnamed */
+	{
+		const int vertexCacheSize = 32;//_LbVœKőz肷LbVTCY
+		const int overdrawCacheSize = 16;//I[o[h[œKőz肷LbVTCY
+
+		/**
+		* _LbVœKŎg_̃XRAvZ
+		*
+		* @param cachePosition LbV̈ʒu(LbVɂȂꍇ-1)
+		* @param remainingValence _gOp`̂A܂o͂ĂȂ̂̐
+		*
+		* @return _̃XRA
+		*
+		* Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"̕]
+		*/
+		float CalcVertexScore(int cachePosition, int remainingValence)
+		{
+			if (remainingValence <= 0)
+			{
+				return -1.0f;//gȂ_
+			}
+			float score = 0;
+			if (cachePosition >= 0)
+			{
+				if (cachePosition < 3)
+				{
+					//O̎Op`Ŏg_́AOp`Ȃ悤ɌŒlɂ
+					score = 0.75f;
+				}
+				else
+				{
+					const float scaler = 1.0f / (vertexCacheSize - 3);
+					score = std::pow(1.0f - (cachePosition - 3) * scaler, 1.5f);
+				}
+			}
+			//c肪Ȃ_D悵āAǗOp`cȂ悤ɂ
+			score += 2.0f * std::pow(static_cast<float>(remainingValence), -0.5f);
+			return score;
+		}
+
+		/**
+		* FIFOLbVɒ_ǉ
+		*
+		* @param cache      _LbVɒǉꂽ
+		* @param time       ݎ(LbVɒǉ_̐)
+		* @param v          ǉ钸_
+		* @param cacheSize  LbVTCY
+		*
+		* @retval true  LbV~X
+		* @retval false LbVqbg
+		*/
+		bool TouchFifoCache(std::vector<size_t>& cache, size_t& time, GLuint v, size_t cacheSize)
+		{
+			if (time - cache[v] <= cacheSize)
+			{
+				return false;
+			}
+			cache[v] = time;
+			++time;
+			return true;
+		}
+
+		/**
+		* _f[^̗vfr
+		*
+		* @param streams _f[^̔z
+		* @param a       r钸_ԍ
+		* @param b       r钸_ԍ
+		*
+		* @retval true  SĂ̒_v
+		* @retval false vȂ_
+		*/
+		bool IsSameVertex(const std::vector<Mesh::VertexStream>& streams, GLuint a, GLuint b)
+		{
+			for (const Mesh::VertexStream& e : streams)
+			{
+				if (e.data.empty())
+				{
+					continue;
+				}
+				if (!std::equal(e.data.begin() + a * e.stride, e.data.begin() + (a + 1) * e.stride,
+					e.data.begin() + b * e.stride))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		* _f[^̒_בւ
+		*
+		* @param streams _f[^̔z
+		* @param newIndex e_̈ړ(-1Ȃ폜)
+		* @param newCount בւ̒_
+		*/
+		void RemapVertexStreams(std::vector<Mesh::VertexStream>& streams,
+			const std::vector<GLuint>& newIndex, size_t newCount)
+		{
+			for (Mesh::VertexStream& e : streams)
+			{
+				if (e.data.empty())
+				{
+					continue;
+				}
+				std::vector<uint8_t> data(newCount * e.stride);
+				for (size_t i = 0; i < newIndex.size(); ++i)
+				{
+					if (newIndex[i] != static_cast<GLuint>(-1))
+					{
+						std::copy(e.data.begin() + i * e.stride, e.data.begin() + (i + 1) * e.stride,
+							data.begin() + newIndex[i] * e.stride);
+					}
+				}
+				e.data.swap(data);
+			}
+		}
+
+		/**
+		* _f[^̒_擾
+		*
+		* @param streams _f[^̔z
+		*
+		* @return _(łȂ_f[^̂ŏ̂)
+		*/
+		size_t GetVertexCount(const std::vector<Mesh::VertexStream>& streams)
+		{
+			size_t count = 0;
+			bool found = false;
+			for (const Mesh::VertexStream& e : streams)
+			{
+				if (e.data.empty())
+				{
+					continue;
+				}
+				count = found ? std::min(count, e.Count()) : e.Count();
+				found = true;
+			}
+			return count;
+		}
+
+	} // unnamed namespace
+
+	/**
+	* _LbV̌vZ
+	*
+	* @param indices     CfbNXf[^(Op`Xg)
+	* @param vertexCount _
+	* @param cacheSize   z肷FIFOLbṼTCY
+	*
+	* @return _LbV̌
+	*/
+	Statistics AnalyzeVertexCache(const std::vector<GLuint>& indices,
+		size_t vertexCount, size_t cacheSize)
+	{
+		Statistics stats;
+		if (indices.size() < 3 || vertexCount == 0)
+		{
+			return stats;
+		}
+		std::vector<size_t> cache(vertexCount, 0);
+		std::vector<bool> isUsed(vertexCount, false);
+		size_t time = cacheSize + 1;
+		size_t misses = 0;
+		size_t usedCount = 0;
+		for (GLuint v : indices)
+		{
+			if (TouchFifoCache(cache, time, v, cacheSize))
+			{
+				++misses;
+			}
+			if (!isUsed[v])
+			{
+				isUsed[v] = true;
+				++usedCount;
+			}
+		}
+		stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+		stats.atvr = static_cast<float>(misses) / static_cast<float>(usedCount);
+		return stats;
+	}
+
+	/**
+	* d钸_𓝍
+	*
+	* @param indices CfbNXf[^
+	* @param streams _f[^̔z
+	*
+	* @return ̒_
+	*
+	* SĂ̒_oCgPʂňv钸_1ɂ܂Ƃ߂
+	*/
+	size_t RemoveDuplicateVertices(std::vector<GLuint>& indices,
+		std::vector<Mesh::VertexStream>& streams)
+	{
+		const size_t vertexCount = GetVertexCount(streams);
+
+		//SĂ̒_̃oCg񂩂nbVlvZAnbVl̒_r
+		std::unordered_multimap<uint64_t, GLuint> table;
+		table.reserve(vertexCount);
+		std::vector<GLuint> newIndex(vertexCount, static_cast<GLuint>(-1));
+		std::vector<GLuint> remap(vertexCount);
+		GLuint uniqueCount = 0;
+		for (GLuint v = 0; v < vertexCount; ++v)
+		{
+			uint64_t hash = 14695981039346656037ull;//FNV-1a
+			for (const Mesh::VertexStream& e : streams)
+			{
+				const uint8_t* p = e.data.data() + v * e.stride;
+				for (GLsizei i = 0; i < e.stride && !e.data.empty(); ++i)
+				{
+					hash = (hash ^ p[i]) * 1099511628211ull;
+				}
+			}
+			GLuint found = static_cast<GLuint>(-1);
+			const auto range = table.equal_range(hash);
+			for (auto itr = range.first; itr != range.second; ++itr)
+			{
+				if (IsSameVertex(streams, itr->second, v))
+				{
+					found = itr->second;
+					break;
+				}
+			}
+			if (found == static_cast<GLuint>(-1))
+			{
+				table.insert(std::make_pair(hash, v));
+				newIndex[v] = uniqueCount++;
+				remap[v] = newIndex[v];
+			}
+			else
+			{
+				remap[v] = newIndex[found];
+			}
+		}
+		if (uniqueCount == vertexCount)
+		{
+			return vertexCount;
+		}
+
+		for (GLuint& i : indices)
+		{
+			i = remap[i];
+		}
+		RemapVertexStreams(streams, newIndex, uniqueCount);
+		return uniqueCount;
+	}
+
+	/**
+	* _LbV悤ɎOp`בւ
+	*
+	* @param indices     CfbNXf[^(Op`Xg)
+	* @param vertexCount _
+	*
+	* Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"̃ASYg
+	*/
+	void OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0 || vertexCount == 0)
+		{
+			return;
+		}
+
+		//_ƂɁA̒_gOp`̃Xg
+		std::vector<int> valence(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+		{
+			++valence[indices[i]];
+		}
+		std::vector<size_t> adjacencyOffset(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			adjacencyOffset[v + 1] = adjacencyOffset[v] + valence[v];
+		}
+		std::vector<GLuint> adjacency(triangleCount * 3);
+		{
+			std::vector<size_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+			for (size_t t = 0; t < triangleCount; ++t)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					adjacency[fill[indices[t * 3 + k]]++] = static_cast<GLuint>(t);
+				}
+			}
+		}
+
+		std::vector<int> cachePosition(vertexCount, -1);
+		std::vector<float> vertexScore(vertexCount);
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			vertexScore[v] = CalcVertexScore(-1, valence[v]);
+		}
+		std::vector<float> triangleScore(triangleCount);
+		std::vector<bool> isEmitted(triangleCount, false);
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			triangleScore[t] = vertexScore[indices[t * 3]] +
+				vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+		}
+
+		std::vector<GLuint> result;
+		result.reserve(triangleCount * 3);
+		std::vector<GLuint> cache;
+		cache.reserve(vertexCacheSize + 3);
+		std::vector<GLuint> newCache;
+		newCache.reserve(vertexCacheSize + 3);
+		size_t scanPosition = 0;//₪ȂƂɖo͂̎Op`Tʒu
+		size_t bestTriangle = static_cast<size_t>(-1);
+		for (size_t emitted = 0; emitted < triangleCount; ++emitted)
+		{
+			if (bestTriangle == static_cast<size_t>(-1))
+			{
+				//LbV̒_ɐڂOp`Ȃ΁Ao͂̎Op`ōXRÂ̂I
+				while (isEmitted[scanPosition])
+				{
+					++scanPosition;
+				}
+				bestTriangle = scanPosition;
+				for (size_t t = scanPosition; t < triangleCount; ++t)
+				{
+					if (!isEmitted[t] && triangleScore[t] > triangleScore[bestTriangle])
+					{
+						bestTriangle = t;
+					}
+				}
+			}
+
+			//Op`o͂Ae_̖o͎Op`Xg菜
+			const size_t tri = bestTriangle;
+			isEmitted[tri] = true;
+			for (int k = 0; k < 3; ++k)
+			{
+				const GLuint v = indices[tri * 3 + k];
+				result.push_back(v);
+				GLuint* begin = &adjacency[adjacencyOffset[v]];
+				GLuint* end = begin + valence[v];
+				GLuint* itr = std::find(begin, end, static_cast<GLuint>(tri));
+				if (itr != end)
+				{
+					std::swap(*itr, *(end - 1));
+					--valence[v];
+				}
+			}
+
+			//o͂Op`̒_LbV̐擪Ɉړ(LRULbV)
+			newCache.clear();
+			for (int k = 0; k < 3; ++k)
+			{
+				newCache.push_back(indices[tri * 3 + k]);
+			}
+			for (GLuint v : cache)
+			{
+				if (v != newCache[0] && v != newCache[1] && v != newCache[2])
+				{
+					newCache.push_back(v);
+				}
+			}
+			if (newCache.size() > static_cast<size_t>(vertexCacheSize))
+			{
+				for (size_t i = vertexCacheSize; i < newCache.size(); ++i)
+				{
+					//LbVǂoꂽ_ƁAgOp`̃XRAXV
+					const GLuint v = newCache[i];
+					cachePosition[v] = -1;
+					vertexScore[v] = CalcVertexScore(-1, valence[v]);
+					for (int n = 0; n < valence[v]; ++n)
+					{
+						const GLuint t = adjacency[adjacencyOffset[v] + n];
+						triangleScore[t] = vertexScore[indices[t * 3]] +
+							vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+					}
+				}
+				newCache.resize(vertexCacheSize);
+			}
+			cache.swap(newCache);
+
+			//LbV̒_̃XRAXVAɐڂOp`玟̌I
+			for (size_t i = 0; i < cache.size(); ++i)
+			{
+				cachePosition[cache[i]] = static_cast<int>(i);
+				vertexScore[cache[i]] = CalcVertexScore(static_cast<int>(i), valence[cache[i]]);
+			}
+			bestTriangle = static_cast<size_t>(-1);
+			float bestScore = -1;
+			for (GLuint v : cache)
+			{
+				for (int n = 0; n < valence[v]; ++n)
+				{
+					const GLuint t = adjacency[adjacencyOffset[v] + n];
+					triangleScore[t] = vertexScore[indices[t * 3]] +
+						vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+					if (triangleScore[t] > bestScore)
+					{
+						bestScore = triangleScore[t];
+						bestTriangle = t;
+					}
+				}
+			}
+		}
+		result.insert(result.end(), indices.begin() + triangleCount * 3, indices.end());
+		indices.swap(result);
+	}
+
+	/**
+	* I[o[h[悤ɎOp`בւ
+	*
+	* @param indices   _LbVœKς݂̃CfbNXf[^(Op`Xg)
+	* @param positions _W̔z
+	* @param threshold e钸_LbV̈(1.05Ȃ5%܂ňe)
+	*
+	* _LbV̌ۂĂ͈͂ŎOp`܂Ƃ܂(NX^)ɕA
+	* bV̊OĂNX^ɕ`悤ɕבւ
+	* O̖ʂɕ`قǁA̖ʂ[xeXgŎ̂Ă\Ȃ
+	*/
+	void OptimizeOverdraw(std::vector<GLuint>& indices,
+		const std::vector<glm::vec3>& positions, float threshold)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		const size_t vertexCount = positions.size();
+		if (triangleCount < 2 || vertexCount == 0)
+		{
+			return;
+		}
+
+		//3_ƂLbV~XOp`́AבւĂLbVɉeȂEƂ
+		std::vector<size_t> hardBoundaries;
+		{
+			std::vector<size_t> cache(vertexCount, 0);
+			size_t time = overdrawCacheSize + 1;
+			for (size_t t = 0; t < triangleCount; ++t)
+			{
+				int misses = 0;
+				for (int k = 0; k < 3; ++k)
+				{
+					misses += TouchFifoCache(cache, time, indices[t * 3 + k], overdrawCacheSize);
+				}
+				if (t == 0 || misses == 3)
+				{
+					hardBoundaries.push_back(t);
+				}
+			}
+			hardBoundaries.push_back(triangleCount);
+		}
+
+		//ẼLbVthreshold{܂ň邱ƂeāAɍׂ
+		std::vector<size_t> boundaries;
+		{
+			std::vector<size_t> cache(vertexCount, 0);
+			size_t time = overdrawCacheSize + 1;
+			for (size_t i = 0; i + 1 < hardBoundaries.size(); ++i)
+			{
+				const size_t begin = hardBoundaries[i];
+				const size_t end = hardBoundaries[i + 1];
+
+				time += overdrawCacheSize + 1;//LbVɂ
+				size_t clusterMisses = 0;
+				for (size_t t = begin; t < end; ++t)
+				{
+					for (int k = 0; k < 3; ++k)
+					{
+						clusterMisses += TouchFifoCache(cache, time, indices[t * 3 + k], overdrawCacheSize);
+					}
+				}
+				const float targetAcmr =
+					static_cast<float>(clusterMisses) / static_cast<float>(end - begin) * threshold;
+
+				time += overdrawCacheSize + 1;
+				size_t start = begin;
+				size_t misses = 0;
+				boundaries.push_back(begin);
+				for (size_t t = begin; t < end; ++t)
+				{
+					for (int k = 0; k < 3; ++k)
+					{
+						misses += TouchFifoCache(cache, time, indices[t * 3 + k], overdrawCacheSize);
+					}
+					const size_t count = t + 1 - start;
+					if (t + 1 < end && count >= 8 &&
+						static_cast<float>(misses) / static_cast<float>(count) <= targetAcmr)
+					{
+						boundaries.push_back(t + 1);
+						start = t + 1;
+						misses = 0;
+						time += overdrawCacheSize + 1;
+					}
+				}
+			}
+			boundaries.push_back(triangleCount);
+		}
+
+		//bVŜ̒S߂
+		glm::vec3 meshCenter(0);
+		float meshArea = 0;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const glm::vec3& p0 = positions[indices[t * 3]];
+			const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+			const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+			const float area = glm::length(glm::cross(p1 - p0, p2 - p0));
+			meshCenter += (p0 + p1 + p2) * (area / 3.0f);
+			meshArea += area;
+		}
+		if (meshArea <= 0)
+		{
+			return;
+		}
+		meshCenter /= meshArea;
+
+		//NX^̒SƖ@AOĂxvZ
+		const size_t clusterCount = boundaries.size() - 1;
+		std::vector<float> sortKey(clusterCount);
+		for (size_t c = 0; c < clusterCount; ++c)
+		{
+			glm::vec3 center(0);
+			glm::vec3 normal(0);
+			float area = 0;
+			for (size_t t = boundaries[c]; t < boundaries[c + 1]; ++t)
+			{
+				const glm::vec3& p0 = positions[indices[t * 3]];
+				const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+				const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+				const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+				const float a = glm::length(n);
+				center += (p0 + p1 + p2) * (a / 3.0f);
+				normal += n;
+				area += a;
+			}
+			const float normalLength = glm::length(normal);
+			if (area > 0 && normalLength > 0)
+			{
+				sortKey[c] = glm::dot(center / area - meshCenter, normal / normalLength);
+			}
+			else
+			{
+				sortKey[c] = 0;
+			}
+		}
+
+		//OĂNX^قǐɕ`悷
+		std::vector<size_t> order(clusterCount);
+		for (size_t c = 0; c < clusterCount; ++c)
+		{
+			order[c] = c;
+		}
+		std::stable_sort(order.begin(), order.end(),
+			[&sortKey](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+		std::vector<GLuint> result;
+		result.reserve(indices.size());
+		for (size_t c : order)
+		{
+			result.insert(result.end(),
+				indices.begin() + boundaries[c] * 3, indices.begin() + boundaries[c + 1] * 3);
+		}
+		result.insert(result.end(), indices.begin() + triangleCount * 3, indices.end());
+		indices.swap(result);
+	}
+
+	/**
+	* _̓ǂݍ݂A悤ɒ_בւ
+	*
+	* @param indices CfbNXf[^
+	* @param streams _f[^̔z
+	*
+	* @return בւ̒_
+	*
+	* _CfbNXf[^ōŏɎg鏇ɕׂ. gĂȂ_͍폜
+	*/
+	size_t OptimizeVertexFetch(std::vector<GLuint>& indices,
+		std::vector<Mesh::VertexStream>& streams)
+	{
+		const size_t vertexCount = GetVertexCount(streams);
+		std::vector<GLuint> newIndex(vertexCount, static_cast<GLuint>(-1));
+		GLuint nextIndex = 0;
+		for (GLuint& i : indices)
+		{
+			if (newIndex[i] == static_cast<GLuint>(-1))
+			{
+				newIndex[i] = nextIndex++;
+			}
+			i = newIndex[i];
+		}
+		RemapVertexStreams(streams, newIndex, nextIndex);
+		return nextIndex;
+	}
+
+	/**
+	* bVœK
+	*
+	* @param indices CfbNXf[^(Op`Xg)
+	* @param streams _f[^̔z(0Ԃ͒_Wł邱)
+	* @param name    bV(|[g̕\p)
+	*
+	* @retval true  œK
+	* @retval false œKłȂf[^Ȃ̂ŉȂ
+	*/
+	bool Optimize(std::vector<GLuint>& indices,
+		std::vector<Mesh::VertexStream>& streams, const std::string& name)
+	{
+		size_t vertexCount = GetVertexCount(streams);
+		if (streams.empty() || streams[0].data.empty() || indices.size() < 3 || vertexCount == 0)
+		{
+			return false;
+		}
+		for (GLuint i : indices)
+		{
+			if (i >= vertexCount)
+			{
+				std::cerr << "[x]" << __func__ << ":" << name <<
+					"̃CfbNX_𒴂Ă邽ߍœKł܂\n";
+				return false;
+			}
+		}
+		const size_t originalVertexCount = vertexCount;
+		const Statistics before = AnalyzeVertexCache(indices, vertexCount);
+
+		vertexCount = RemoveDuplicateVertices(indices, streams);
+		OptimizeVertexCache(indices, vertexCount);
+
+		std::vector<glm::vec3> positions(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			positions[i] = glm::vec3(Mesh::GetVertexStreamElement(streams[0], i));
+		}
+		OptimizeOverdraw(indices, positions);
+		vertexCount = OptimizeVertexFetch(indices, streams);
+
+		const Statistics after = AnalyzeVertexCache(indices, vertexCount);
+		std::cout << "[]" << __func__ << ":" << name <<
+			" _=" << originalVertexCount << "->" << vertexCount <<
+			" ACMR=" << before.acmr << "->" << after.acmr <<
+			" ATVR=" << before.atvr << "->" << after.atvr << "\n";
+		return true;
+	}
+
+} //namespace MeshOptimizer
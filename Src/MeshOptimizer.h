@@ -0,0 +1,45 @@
+/**
+* @file MeshOptimizer.h
+*/
+#ifndef MESHOPTIMIZER_H_INCLUDED
+#define MESHOPTIMIZER_H_INCLUDED
+#include <GL/glew.h>
+#include "Mesh.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+* bV̍œKɊւ@\i[閼O
+*
+* ǂݍݎɈȉ̏ōœK
+* 1. d_𓝍
+* 2. _LbV悤ɎOp`בւ
+* 3. I[o[h[悤ɁAOp`̂܂Ƃ܂O`鏇ɕבւ
+* 4. _̓ǂݍ݂A悤ɁA_ŏɎg鏇ɕבւ
+*/
+namespace MeshOptimizer
+{
+	/**
+	* _LbV̌
+	*/
+	struct Statistics
+	{
+		float acmr = 0;//Op`̃LbV~X(0.5`3.0. قǂ悢)
+		float atvr = 0;//_̃LbV~X(1.0ȏ. 1.0ɋ߂قǂ悢)
+	};
+
+	Statistics AnalyzeVertexCache(const std::vector<GLuint>& indices,
+		size_t vertexCount, size_t cacheSize = 16);
+	size_t RemoveDuplicateVertices(std::vector<GLuint>& indices,
+		std::vector<Mesh::VertexStream>& streams);
+	void OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount);
+	void OptimizeOverdraw(std::vector<GLuint>& indices,
+		const std::vector<glm::vec3>& positions, float threshold = 1.05f);
+	size_t OptimizeVertexFetch(std::vector<GLuint>& indices,
+		std::vector<Mesh::VertexStream>& streams);
+	bool Optimize(std::vector<GLuint>& indices,
+		std::vector<Mesh::VertexStream>& streams, const std::string& name);
+
+} //namespace MeshOptimizer
+
+#endif //MESHOPTIMIZER_H_INCLUDED
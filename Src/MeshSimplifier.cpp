@@ -0,0 +1,370 @@
+/**
+* @file MeshSimplifier.cpp
+*/
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstring>
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
+
+namespace MeshSimplifier
+{
+	namespace /* unnamed */
+	{
+		/**
+		* 񎟌덷s
+		*
+		* ʂ̋2a x^T*A*x + 2*bEx + c ̌`ŕێ
+		* A͑Ώ̍sȂ̂6vf
+		*/
+		struct Quadric
+		{
+			double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+			double b0 = 0, b1 = 0, b2 = 0;
+			double c = 0;
+
+			/**
+			*  nEx + d = 0 ̋2\sZ
+			*/
+			void AddPlane(const glm::vec3& n, float d)
+			{
+				a00 += n.x * n.x; a01 += n.x * n.y; a02 += n.x * n.z;
+				a11 += n.y * n.y; a12 += n.y * n.z; a22 += n.z * n.z;
+				b0 += n.x * d; b1 += n.y * d; b2 += n.z * d;
+				c += static_cast<double>(d) * d;
+			}
+
+			Quadric& operator+=(const Quadric& q)
+			{
+				a00 += q.a00; a01 += q.a01; a02 += q.a02;
+				a11 += q.a11; a12 += q.a12; a22 += q.a22;
+				b0 += q.b0; b1 += q.b1; b2 += q.b2;
+				c += q.c;
+				return *this;
+			}
+
+			/**
+			* _pɂ덷vZ
+			*/
+			double Evaluate(const glm::vec3& p) const
+			{
+				const double x = p.x, y = p.y, z = p.z;
+				const double e = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z +
+					a11 * y * y + 2 * a12 * y * z + a22 * z * z +
+					2 * (b0 * x + b1 * y + b2 * z) + c;
+				return std::max(e, 0.0);
+			}
+		};
+
+		/**
+		* kނ̌
+		*/
+		struct Collapse
+		{
+			GLuint from;//钸_
+			GLuint to;//c钸_
+			double error;//kނƂ̌덷
+		};
+
+		/**
+		* Op`̖@(KȂ)vZ
+		*/
+		glm::vec3 CalcTriangleNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+		{
+			return glm::cross(b - a, c - a);
+		}
+
+		/**
+		* ړĂ͂Ȃ_𒲂ׂ
+		*
+		* @param indices   CfbNXf[^
+		* @param positions _W̔z
+		*
+		* @return _Ƃ̌ŒtO
+		*
+		* ̉(Ό̕ӂOp`Ȃ)̒_ƁA
+		* Wɕʂ̒_pڂ̒_Œ肷
+		*/
+		std::vector<bool> FindLockedVertices(const std::vector<GLuint>& indices,
+			const std::vector<glm::vec3>& positions)
+		{
+			std::vector<bool> locked(positions.size(), false);
+
+			std::unordered_set<uint64_t> edges;
+			edges.reserve(indices.size());
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					const uint64_t a = indices[i + k];
+					const uint64_t b = indices[i + (k + 1) % 3];
+					edges.insert((a << 32) | b);
+				}
+			}
+			for (const uint64_t e : edges)
+			{
+				const uint64_t reverse = (e << 32) | (e >> 32);
+				if (edges.find(reverse) == edges.end())
+				{
+					locked[static_cast<size_t>(e >> 32)] = true;
+					locked[static_cast<size_t>(e & 0xffffffff)] = true;
+				}
+			}
+
+			std::unordered_multimap<uint64_t, GLuint> table;
+			table.reserve(positions.size());
+			for (GLuint v = 0; v < positions.size(); ++v)
+			{
+				uint32_t bits[3];
+				std::memcpy(bits, &positions[v], sizeof(bits));
+				const uint64_t hash = (static_cast<uint64_t>(bits[0]) * 73856093) ^
+					(static_cast<uint64_t>(bits[1]) * 19349663) ^
+					(static_cast<uint64_t>(bits[2]) * 83492791);
+				const auto range = table.equal_range(hash);
+				for (auto itr = range.first; itr != range.second; ++itr)
+				{
+					if (positions[itr->second] == positions[v])
+					{
+						locked[v] = true;
+						locked[itr->second] = true;
+					}
+				}
+				table.insert(std::make_pair(hash, v));
+			}
+			return locked;
+		}
+
+		/**
+		* kނɂėԂOp`邩ׂ
+		*
+		* @param indices   CfbNXf[^
+		* @param triangles _fromgOp`̔ԍ
+		* @param positions _W̔z
+		* @param from      钸_
+		* @param to        c钸_
+		*
+		* @retval true  ԂOp`
+		* @retval false ԂOp`͂Ȃ
+		*/
+		bool HasFlippedTriangle(const std::vector<GLuint>& indices,
+			const std::vector<GLuint>& triangles, const std::vector<glm::vec3>& positions,
+			GLuint from, GLuint to)
+		{
+			for (const GLuint t : triangles)
+			{
+				const GLuint* tri = &indices[t * 3];
+				if (tri[0] == to || tri[1] == to || tri[2] == to)
+				{
+					continue;//kނďOp`
+				}
+				glm::vec3 p[3];
+				glm::vec3 q[3];
+				for (int k = 0; k < 3; ++k)
+				{
+					p[k] = positions[tri[k]];
+					q[k] = positions[tri[k] == from ? to : tri[k]];
+				}
+				const glm::vec3 n0 = CalcTriangleNormal(p[0], p[1], p[2]);
+				const glm::vec3 n1 = CalcTriangleNormal(q[0], q[1], q[2]);
+				if (glm::dot(n0, n1) <= 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+	} // unnamed namespace
+
+	/**
+	* bVȗ
+	*
+	* @param indices          CfbNXf[^(Op`Xg)
+	* @param positions        _W̔z
+	* @param targetIndexCount ڕW̃CfbNX
+	* @param maxError         e덷(IuWFNgWn̋)
+	* @param resultError      ȗɂ덷̊i[(svȂnullptr)
+	*
+	* @return ȗCfbNXf[^
+	*
+	* ڕW̃CfbNXɒB邩Ae덷ȉŏkނłӂȂȂ܂Ŋȗ
+	*/
+	std::vector<GLuint> Simplify(const std::vector<GLuint>& indices,
+		const std::vector<glm::vec3>& positions, size_t targetIndexCount,
+		float maxError, float* resultError)
+	{
+		std::vector<GLuint> result(indices.begin(), indices.end() - indices.size() % 3);
+		const size_t vertexCount = positions.size();
+		double errorSq = 0;
+
+		//e_ɁA̎Op`̕ʂ̋\񎟌덷ݒ肷
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			const glm::vec3& a = positions[result[i + 0]];
+			const glm::vec3& b = positions[result[i + 1]];
+			const glm::vec3& c = positions[result[i + 2]];
+			const glm::vec3 n = CalcTriangleNormal(a, b, c);
+			const float len = glm::length(n);
+			if (len <= 0)
+			{
+				continue;
+			}
+			const glm::vec3 normal = n / len;
+			const float d = -glm::dot(normal, a);
+			for (int k = 0; k < 3; ++k)
+			{
+				quadrics[result[i + k]].AddPlane(normal, d);
+			}
+		}
+		const std::vector<bool> locked = FindLockedVertices(result, positions);
+		const double maxErrorSq = static_cast<double>(maxError) * maxError;
+
+		std::vector<GLuint> remap(vertexCount);
+		std::vector<bool> dirty(vertexCount);
+		std::vector<std::vector<GLuint>> adjacency(vertexCount);
+		std::vector<Collapse> collapses;
+		while (result.size() > targetIndexCount)
+		{
+			//_gOp`̈ꗗ
+			for (std::vector<GLuint>& e : adjacency)
+			{
+				e.clear();
+			}
+			for (size_t i = 0; i < result.size(); ++i)
+			{
+				adjacency[result[i]].push_back(static_cast<GLuint>(i / 3));
+			}
+
+			//SĂ̕ӂɂāȀkނ̌덷vZďɕׂ
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					const GLuint a = result[i + k];
+					const GLuint b = result[i + (k + 1) % 3];
+					Quadric q = quadrics[a];
+					q += quadrics[b];
+					if (!locked[a])
+					{
+						collapses.push_back({ a, b, q.Evaluate(positions[b]) });
+					}
+					if (!locked[b])
+					{
+						collapses.push_back({ b, a, q.Evaluate(positions[a]) });
+					}
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(),
+				[](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+			//1̏kނł悻2̎Op`
+			const size_t collapseLimit = (result.size() - targetIndexCount) / 6 + 1;
+			size_t collapseCount = 0;
+			for (GLuint v = 0; v < vertexCount; ++v)
+			{
+				remap[v] = v;
+			}
+			std::fill(dirty.begin(), dirty.end(), false);
+			for (const Collapse& e : collapses)
+			{
+				if (e.error > maxErrorSq || collapseCount >= collapseLimit)
+				{
+					break;
+				}
+				if (dirty[e.from] || dirty[e.to])
+				{
+					continue;
+				}
+				if (HasFlippedTriangle(result, adjacency[e.from], positions, e.from, e.to))
+				{
+					continue;
+				}
+				remap[e.from] = e.to;
+				quadrics[e.to] += quadrics[e.from];
+				errorSq = std::max(errorSq, e.error);
+				++collapseCount;
+
+				//Ԃ̔肪s悤ɁA̒_͂̉ł͓Ȃ
+				for (const GLuint t : adjacency[e.from])
+				{
+					for (int k = 0; k < 3; ++k)
+					{
+						dirty[result[t * 3 + k]] = true;
+					}
+				}
+			}
+			if (collapseCount == 0)
+			{
+				break;
+			}
+
+			//_uāAʐςȂȂOp`菜
+			size_t n = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				const GLuint a = remap[result[i + 0]];
+				const GLuint b = remap[result[i + 1]];
+				const GLuint c = remap[result[i + 2]];
+				if (a == b || b == c || c == a)
+				{
+					continue;
+				}
+				result[n++] = a;
+				result[n++] = b;
+				result[n++] = c;
+			}
+			result.resize(n);
+		}
+
+		if (resultError)
+		{
+			*resultError = static_cast<float>(std::sqrt(errorSq));
+		}
+		return result;
+	}
+
+	/**
+	* ڍדx(LOD)𐶐
+	*
+	* @param indices    ̃bṼCfbNXf[^(Op`Xg)
+	* @param positions  _W̔z
+	* @param levelCount LOD̐(̃bV͊܂܂Ȃ)
+	* @param reduction  1iKƂ̃CfbNX̔䗦
+	*
+	* @return ڍׂȏɕLOD̔z
+	*
+	* 1OLODȗĎLOD
+	* 덷͊eiǨ덷̍vƂÃbV̌덷ςȂ悤ɂ
+	* Op`\ɌȂȂ_Őł؂
+	*/
+	std::vector<Level> GenerateLods(const std::vector<GLuint>& indices,
+		const std::vector<glm::vec3>& positions, int levelCount, float reduction)
+	{
+		std::vector<Level> levels;
+		levels.reserve(levelCount);
+		const std::vector<GLuint>* source = &indices;
+		float error = 0;
+		for (int i = 0; i < levelCount; ++i)
+		{
+			const size_t target = static_cast<size_t>(source->size() * reduction) / 3 * 3;
+			float levelError = 0;
+			Level level;
+			level.indices = Simplify(*source, positions, target, FLT_MAX, &levelError);
+			if (level.indices.size() < 3 || level.indices.size() > source->size() * 0.95f)
+			{
+				break;
+			}
+			error += levelError;
+			level.error = error;
+			levels.push_back(std::move(level));
+			source = &levels.back().indices;
+		}
+		return levels;
+	}
+
+} //namespace MeshSimplifier
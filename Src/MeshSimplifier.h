@@ -0,0 +1,36 @@
+/**
+* @file MeshSimplifier.h
+*/
+#ifndef MESHSIMPLIFIER_H_INCLUDED
+#define MESHSIMPLIFIER_H_INCLUDED
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+* bV̊ȗɊւ@\i[閼O
+*
+* 񎟌덷(QEM)wWɂāA덷̏ӂ珇ɕБ̒_֏kނ
+* _͈ړǉȂ̂ŁAȗCfbNXf[^͌̒_f[^Lł
+* ̉̒_ƁAeNX`WȂǂ̌pڂɂ钸_͌`Ȃ悤ɌŒ肷
+*/
+namespace MeshSimplifier
+{
+	/**
+	* ȗڍדx(LOD)
+	*/
+	struct Level
+	{
+		std::vector<GLuint> indices;//CfbNXf[^(Op`Xg)
+		float error = 0;//̃bV̌덷(IuWFNgWn̋)
+	};
+
+	std::vector<GLuint> Simplify(const std::vector<GLuint>& indices,
+		const std::vector<glm::vec3>& positions, size_t targetIndexCount,
+		float maxError, float* resultError = nullptr);
+	std::vector<Level> GenerateLods(const std::vector<GLuint>& indices,
+		const std::vector<glm::vec3>& positions, int levelCount, float reduction = 0.5f);
+
+} //namespace MeshSimplifier
+
+#endif //MESHSIMPLIFIER_H_INCLUDED
@@ -0,0 +1,380 @@
+/**
+* @file OcclusionCuller.cpp
+*/
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//SSEgł́Aɕ4sNZ܂Ƃ߂ĕ`悷
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define OCCLUSION_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace /* unnamed */
+{
+	const int testTexelCount = 4;//IsVisibleŒׂ͈͂̏c̍őeNZ
+
+	/**
+	* NbvWXN[Wɕϊ
+	*
+	* @param c NbvW
+	*
+	* @return xy̓sNZPʂ̃XN[WAz0`1̐[xl
+	*/
+	glm::vec3 ToScreen(const glm::vec4& c)
+	{
+		const glm::vec3 ndc = glm::vec3(c) / c.w;
+		return glm::vec3(
+			(ndc.x * 0.5f + 0.5f) * OcclusionCuller::width,
+			(ndc.y * 0.5f + 0.5f) * OcclusionCuller::height,
+			ndc.z * 0.5f + 0.5f);
+	}
+
+} // unnamed namespace
+
+/**
+* RXgN^
+*/
+OcclusionCuller::OcclusionCuller()
+{
+	for (int i = 0; i < levelCount; ++i)
+	{
+		levels[i].resize((width >> i) * (height >> i), 1.0f);
+	}
+}
+
+/**
+* Օ̕`Jn
+*
+* @param matVP `Ɏgr[vWFNVs
+*/
+void OcclusionCuller::Begin(const glm::mat4& matVP)
+{
+	this->matVP = matVP;
+	frustum = Collision::CreateFrustum(matVP);
+	std::fill(levels[0].begin(), levels[0].end(), 1.0f);
+	ready = false;
+	stats = Statistics();
+}
+
+/**
+* Op`bV̎Օ`悷
+*
+* @param mesh Օ̃bV
+*
+* ̊OɂՕ͕`悵Ȃ
+*/
+void OcclusionCuller::AddOccluder(const OccluderMesh& mesh)
+{
+	if (mesh.indices.empty() || !Collision::TestFrustumAABB(frustum, mesh.aabb))
+	{
+		return;
+	}
+	AddTriangles(mesh.vertices.data(), mesh.indices.data(), mesh.indices.size());
+}
+
+/**
+* ̂̎Օ`悷
+*
+* @param box Օ̗LE{bNX
+*/
+void OcclusionCuller::AddOccluder(const Collision::OrientedBoundingBox& box)
+{
+	glm::vec3 corners[8];
+	for (int i = 0; i < 8; ++i)
+	{
+		corners[i] = box.center +
+			box.axis[0] * ((i & 1) ? box.e.x : -box.e.x) +
+			box.axis[1] * ((i & 2) ? box.e.y : -box.e.y) +
+			box.axis[2] * ((i & 4) ? box.e.z : -box.e.z);
+	}
+	static const uint32_t indices[] = {
+		0, 2, 3, 3, 1, 0, //-Z
+		4, 5, 7, 7, 6, 4, //+Z
+		0, 1, 5, 5, 4, 0, //-Y
+		2, 6, 7, 7, 3, 2, //+Y
+		0, 4, 6, 6, 2, 0, //-X
+		1, 3, 7, 7, 5, 1, //+X
+	};
+	AddTriangles(corners, indices, sizeof(indices) / sizeof(indices[0]));
+}
+
+/**
+* Օ̕`IAHi-Z쐬
+*/
+void OcclusionCuller::End()
+{
+	for (int i = 1; i < levelCount; ++i)
+	{
+		const int srcWidth = width >> (i - 1);
+		const int w = width >> i;
+		const int h = height >> i;
+		const float* src = levels[i - 1].data();
+		float* dst = levels[i].data();
+		for (int y = 0; y < h; ++y)
+		{
+			const float* row0 = src + (y * 2) * srcWidth;
+			const float* row1 = row0 + srcWidth;
+			for (int x = 0; x < w; ++x)
+			{
+				dst[y * w + x] = std::max(std::max(row0[x * 2], row0[x * 2 + 1]),
+					std::max(row1[x * 2], row1[x * 2 + 1]));
+			}
+		}
+	}
+	ready = true;
+}
+
+/**
+* ̂邩肷
+*
+* @param box ̂̃[hWnAABB
+*
+* @retval true  \
+* @retval false ՕɊSɉBĂ
+*/
+bool OcclusionCuller::IsVisible(const Collision::AABB& box)
+{
+	if (!ready)
+	{
+		return true;
+	}
+	++stats.testedCount;
+
+	//AABB8_𓊉eāAʏ͈̔͂ƍł߂[xl߂
+	glm::vec2 rectMin(std::numeric_limits<float>::max());
+	glm::vec2 rectMax(std::numeric_limits<float>::lowest());
+	float nearestZ = 1.0f;
+	for (int i = 0; i < 8; ++i)
+	{
+		const glm::vec4 c = matVP * glm::vec4(
+			(i & 1) ? box.max.x : box.min.x,
+			(i & 2) ? box.max.y : box.min.y,
+			(i & 4) ? box.max.z : box.min.z, 1);
+		if (c.z < -c.w)
+		{
+			return true;//߃NbvʂOɂ͂ݏoĂ̂ŁAB邱Ƃ͂Ȃ
+		}
+		const glm::vec3 s = ToScreen(c);
+		rectMin = glm::min(rectMin, glm::vec2(s));
+		rectMax = glm::max(rectMax, glm::vec2(s));
+		nearestZ = std::min(nearestZ, s.z);
+	}
+	rectMin = glm::max(rectMin, glm::vec2(0));
+	rectMax = glm::min(rectMax, glm::vec2(width, height) - 1.0f);
+	if (rectMin.x > rectMax.x || rectMin.y > rectMax.y)
+	{
+		return true;//ʊO͎̔JOɔC
+	}
+
+	//͈͂testTexelCountȉ̃eNZɎ܂KwI
+	int level = 0;
+	glm::ivec2 texelMin = glm::ivec2(rectMin);
+	glm::ivec2 texelMax = glm::ivec2(rectMax);
+	while (level < levelCount - 1 && (texelMax.x - texelMin.x >= testTexelCount ||
+		texelMax.y - texelMin.y >= testTexelCount))
+	{
+		++level;
+		texelMin /= 2;
+		texelMax /= 2;
+	}
+	const int w = width >> level;
+	const int h = height >> level;
+	texelMax = glm::min(texelMax, glm::ivec2(w, h) - 1);
+
+	//͈͓ōłՕ蕨̂Oɂ΁A\
+	const float* depth = levels[level].data();
+	for (int y = texelMin.y; y <= texelMax.y; ++y)
+	{
+		for (int x = texelMin.x; x <= texelMax.x; ++x)
+		{
+			if (nearestZ <= depth[y * w + x])
+			{
+				return true;
+			}
+		}
+	}
+	++stats.occludedCount;
+	return false;
+}
+
+/**
+* Op`Xg`悷
+*
+* @param vertices   [hWn̒_W̔z
+* @param indices    _CfbNX̔z
+* @param indexCount _CfbNX̐
+*/
+void OcclusionCuller::AddTriangles(
+	const glm::vec3* vertices, const uint32_t* indices, size_t indexCount)
+{
+	++stats.occluderCount;
+	uint32_t vertexCount = 0;
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		vertexCount = std::max(vertexCount, indices[i] + 1);
+	}
+	clipVertices.resize(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		clipVertices[i] = matVP * glm::vec4(vertices[i], 1);
+	}
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		ClipAndRasterize(clipVertices[indices[i]],
+			clipVertices[indices[i + 1]], clipVertices[indices[i + 2]]);
+	}
+}
+
+/**
+* Op`߃NbvʂŐ؂Ă`悷
+*
+* @param c0 Op`̒_0̃NbvW
+* @param c1 Op`̒_1̃NbvW
+* @param c2 Op`̒_2̃NbvW
+*/
+void OcclusionCuller::ClipAndRasterize(
+	const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2)
+{
+	const glm::vec4 in[3] = { c0, c1, c2 };
+	const float d[3] = { c0.z + c0.w, c1.z + c1.w, c2.z + c2.w };//߃Nbvʂ̋
+	if (d[0] >= 0 && d[1] >= 0 && d[2] >= 0)
+	{
+		RasterizeTriangle(ToScreen(c0), ToScreen(c1), ToScreen(c2));
+		return;
+	}
+	if (d[0] < 0 && d[1] < 0 && d[2] < 0)
+	{
+		return;
+	}
+
+	//؂ƒ_͍ő4ɂȂ
+	glm::vec3 out[4];
+	int n = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const int j = (i + 1) % 3;
+		if (d[i] >= 0)
+		{
+			out[n++] = ToScreen(in[i]);
+		}
+		if ((d[i] >= 0) != (d[j] >= 0))
+		{
+			const float t = d[i] / (d[i] - d[j]);
+			out[n++] = ToScreen(in[i] + (in[j] - in[i]) * t);
+		}
+	}
+	for (int i = 1; i + 1 < n; ++i)
+	{
+		RasterizeTriangle(out[0], out[i], out[i + 1]);
+	}
+}
+
+/**
+* XN[Wn̎Op`[xobt@ɕ`悷
+*
+* @param v0 Op`̒_0̃XN[W
+* @param v1 Op`̒_1̃XN[W
+* @param v2 Op`̒_2̃XN[W
+*
+* sNZ̒SOp`̓ɂ΁A߂[xl.
+* Օ̕\͋ʂȂ
+*/
+void OcclusionCuller::RasterizeTriangle(
+	const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+{
+	const float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+	if (std::abs(area) < 0.000001f)
+	{
+		return;
+	}
+
+	//Op`͂ރsNZ͈(SSEŏł悤ɁA[4̔{ɂ낦)
+	const int minX = std::max(0, static_cast<int>(std::floor(std::min({ v0.x, v1.x, v2.x })))) & ~3;
+	const int maxX = std::min(width - 1, static_cast<int>(std::ceil(std::max({ v0.x, v1.x, v2.x }))));
+	const int minY = std::max(0, static_cast<int>(std::floor(std::min({ v0.y, v1.y, v2.y }))));
+	const int maxY = std::min(height - 1, static_cast<int>(std::ceil(std::max({ v0.y, v1.y, v2.y }))));
+	if (minX > maxX || minY > maxY)
+	{
+		return;
+	}
+
+	//ӂ̕ E(x, y) = a * x + b * y + c. Op`̓ŐɂȂ悤ɕ낦
+	//i͒_ȋΕӂŁAE/ʐ _ȉdSWɂȂ
+	const float sign = area > 0 ? 1.0f : -1.0f;
+	const glm::vec3* v[3] = { &v0, &v1, &v2 };
+	float a[3], b[3], c[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		const glm::vec3& p = *v[(i + 1) % 3];
+		const glm::vec3& q = *v[(i + 2) % 3];
+		a[i] = (p.y - q.y) * sign;
+		b[i] = (q.x - p.x) * sign;
+		c[i] = (p.x * q.y - p.y * q.x) * sign;
+	}
+
+	//[xl̕ z(x, y) = za * x + zb * y + zc
+	const float invArea = 1.0f / std::abs(area);
+	const float za = (a[0] * v0.z + a[1] * v1.z + a[2] * v2.z) * invArea;
+	const float zb = (b[0] * v0.z + b[1] * v1.z + b[2] * v2.z) * invArea;
+	const float zc = (c[0] * v0.z + c[1] * v1.z + c[2] * v2.z) * invArea;
+
+	float* depth = levels[0].data();
+#ifdef OCCLUSION_USE_SSE
+	const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 za4 = _mm_set1_ps(za * 4);
+	__m128 step[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		step[i] = _mm_set1_ps(a[i] * 4);
+	}
+	for (int y = minY; y <= maxY; ++y)
+	{
+		const float py = static_cast<float>(y) + 0.5f;
+		const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(minX)), laneOffset);
+		__m128 e[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			e[i] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[i]), px), _mm_set1_ps(b[i] * py + c[i]));
+		}
+		__m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(za), px), _mm_set1_ps(zb * py + zc));
+		float* row = depth + y * width;
+		for (int x = minX; x <= maxX; x += 4)
+		{
+			const __m128 inside = _mm_and_ps(_mm_and_ps(
+				_mm_cmpge_ps(e[0], zero), _mm_cmpge_ps(e[1], zero)), _mm_cmpge_ps(e[2], zero));
+			if (_mm_movemask_ps(inside))
+			{
+				const __m128 old = _mm_loadu_ps(row + x);
+				const __m128 nearer = _mm_min_ps(old, z);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+			}
+			for (int i = 0; i < 3; ++i)
+			{
+				e[i] = _mm_add_ps(e[i], step[i]);
+			}
+			z = _mm_add_ps(z, za4);
+		}
+	}
+#else
+	for (int y = minY; y <= maxY; ++y)
+	{
+		const float py = static_cast<float>(y) + 0.5f;
+		float* row = depth + y * width;
+		for (int x = minX; x <= maxX; ++x)
+		{
+			const float px = static_cast<float>(x) + 0.5f;
+			if (a[0] * px + b[0] * py + c[0] >= 0 &&
+				a[1] * px + b[1] * py + c[1] >= 0 &&
+				a[2] * px + b[2] * py + c[2] >= 0)
+			{
+				row[x] = std::min(row[x], za * px + zb * py + zc);
+			}
+		}
+	}
+#endif
+	++stats.triangleCount;
+}
@@ -0,0 +1,78 @@
+/**
+* @file OcclusionCuller.h
+*/
+#ifndef OCCLUSIONCULLER_H_INCLUDED
+#define OCCLUSIONCULLER_H_INCLUDED
+#include "Collision.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+/**
+* CPUŎՕ𑜓x̐[xobt@ɕ`悵ABĂ镨̂𔻒肷
+*
+* n`ǂ̂悤ȑ傫ȎՕ`悵A[xobt@2x2Ƃ
+* ł[xlI񂾊Kw(Hi-Z). ̂AABB̍ł߂[xlA
+* AABB͈͂̍ł[xl艓΁Â͉̕BĂ.
+* OpenGLgȂ̂ŁAGPUȂĂ삷
+*
+* g:
+* 1. BeginɃr[vWFNVsn
+* 2. AddOccluderŎՕ`悷
+* 3. EndŊKw
+* 4. IsVisibleŕ̂邩肷
+*/
+class OcclusionCuller
+{
+public:
+	static const int width = 256;//[xobt@̕(4̔{)
+	static const int height = 144;//[xobt@̍
+	static const int levelCount = 5;//Hi-Z̊Kw(ŏʂ16x9)
+
+	/**
+	* Օp̎Op`bV
+	*/
+	struct OccluderMesh
+	{
+		std::vector<glm::vec3> vertices;//[hWn̒_W
+		std::vector<uint32_t> indices;//Op`̒_CfbNX
+		Collision::AABB aabb;//JOpAABB
+	};
+
+	/**
+	* Օ̓v
+	*/
+	struct Statistics
+	{
+		size_t occluderCount = 0;//`悵Օ̐
+		size_t triangleCount = 0;//`悵Op`̐
+		size_t testedCount = 0;//肵̂̐
+		size_t occludedCount = 0;//BĂƔ肵̂̐
+	};
+
+	OcclusionCuller();
+	~OcclusionCuller() = default;
+	OcclusionCuller(const OcclusionCuller&) = delete;
+	OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+	void Begin(const glm::mat4& matVP);
+	void AddOccluder(const OccluderMesh& mesh);
+	void AddOccluder(const Collision::OrientedBoundingBox& box);
+	void End();
+	bool IsVisible(const Collision::AABB& box);
+	const Statistics& GetStatistics() const { return stats; }
+
+private:
+	void AddTriangles(const glm::vec3* vertices, const uint32_t* indices, size_t indexCount);
+	void ClipAndRasterize(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2);
+	void RasterizeTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2);
+
+	glm::mat4 matVP = glm::mat4(1);
+	Collision::Frustum frustum;//Օ̎䔻p(AddOccludeřĂяo܂Ŏg)
+	std::vector<float> levels[levelCount];//Hi-Z̊eKw(0Ԗڂ[xobt@)
+	std::vector<glm::vec4> clipVertices;//NbvWnɕϊ_(Ɨp)
+	bool ready = false;//EndĂŔłԂȂtrue
+	Statistics stats;
+};
+
+#endif // OCCLUSIONCULLER_H_INCLUDED
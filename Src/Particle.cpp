@@ -2,6 +2,8 @@
 * @file Particle.cpp
 */
 #include "Particle.h"
+#include "GLState.h"
+#include "RenderStats.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 #include <algorithm>
@@ -181,10 +183,12 @@ void ParticleEmitter::Draw()
 {
 	if (count)
 	{
-		glBlendFunc(ep.srcFactor, ep.dstFactor);
-		glBindTexture(GL_TEXTURE_2D, texture->Get());
+		GLState::BlendFunc(ep.srcFactor, ep.dstFactor);
+		GLState::BindTexture(0, GL_TEXTURE_2D, texture->Get());
 		glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_SHORT,
 			reinterpret_cast<const GLvoid*>(0), baseVertex);
+		RenderStats::AddDrawCall();
+		RenderStats::AddPrimitives(GL_TRIANGLES, count);
 	}
 }
 
@@ -195,8 +199,7 @@ void ParticleEmitter::Draw()
 */
 bool ParticleSystem::Init(size_t maxParticleCount)
 {
-	if (!vbo.Create(GL_ARRAY_BUFFER, sizeof(Vertex) * maxParticleCount * 4,
-		nullptr, GL_STREAM_DRAW))
+	if (!vbo.Create(GL_ARRAY_BUFFER, sizeof(Vertex) * maxParticleCount * 4, "ParticleSystem"))
 	{
 		std::cerr << "[G[]p[eBNVXȅɎs\n";
 		return false;
@@ -361,7 +364,38 @@ void ParticleSystem::Update(float deltaTime)
 			e->count += 6;
 		}
 	}
-	vbo.BufferSubData(0, vertices.size() * sizeof(Vertex), vertices.data());
+	if (vertices.empty())
+	{
+		return;
+	}
+
+	//_Pʂŕ`ʒuwł悤ɁA_̃TCYŐ񂳂
+	const GLintptr offset =
+		vbo.Push(vertices.data(), vertices.size() * sizeof(Vertex), sizeof(Vertex));
+	const size_t frameBaseVertex = offset >= 0 ? offset / sizeof(Vertex) : 0;
+	for (auto& e : emitters)
+	{
+		if (offset >= 0)
+		{
+			e->baseVertex += frameBaseVertex;
+		}
+		else
+		{
+			e->count = 0;//]łȂ̂ŕ`悵Ȃ
+		}
+	}
+}
+
+/**
+* p[eBNp̗̎ݒ肷
+*
+* @param seed ̎
+*
+* ͂L^EĐƂɁAp[eBN̓𖈉񓯂ɂ邽߂Ɏg
+*/
+void ParticleSystem::SetRandomSeed(uint32_t seed)
+{
+	randamEngine.seed(seed);
 }
 
 /**
@@ -375,17 +409,16 @@ void ParticleSystem::Draw(const glm::mat4& matProj, const glm::mat4& matView)
 	vao.Bind();
 
 	//`ݒ
-	glEnable(GL_DEPTH_TEST);
-	glDepthMask(false);//[xobt@ւ݂̏~߂
-	glDisable(GL_CULL_FACE);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLState::Enable(GL_DEPTH_TEST);
+	GLState::DepthMask(GL_FALSE);//[xobt@ւ݂̏~߂
+	GLState::Disable(GL_CULL_FACE);
+	GLState::Enable(GL_BLEND);
+	GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	//VF[_[Ƀp[^[ݒ
 	program->Use();
 	program->SetInverseViewRotationMatrix(matView);
 	program->SetViewProjectionMatrix(matProj * matView);
-	glActiveTexture(GL_TEXTURE0);
 
 	//G~b^[J牓ɕׂ
 	struct A
@@ -410,9 +443,7 @@ void ParticleSystem::Draw(const glm::mat4& matProj, const glm::mat4& matView)
 	}
 
 	//`ݒ̌n
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glUseProgram(0);
-	glDepthMask(true);//[xobt@ւ݂̏
+	GLState::DepthMask(GL_TRUE);//[xobt@ւ݂̏
 
 	vao.Unbind();
 }
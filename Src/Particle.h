@@ -6,11 +6,13 @@
 #include <GL/glew.h>
 #include "Texture.h"
 #include "BufferObject.h"
+#include "StreamingBuffer.h"
 #include "Shader.h"
 #include "Sprite.h"
 #include <glm/glm.hpp>
 #include <list>
 #include <memory>
+#include <cstdint>
 
 //s錾
 class Particle;
@@ -136,8 +138,10 @@ public:
 	void Update(float deltatime);
 	void Draw(const glm::mat4& matProj, const glm::mat4& matView);
 
+	static void SetRandomSeed(uint32_t seed);
+
 private:
-	BufferObject vbo;
+	StreamingBuffer vbo;
 	BufferObject ibo;
 	VertexArrayObject vao;
 	Shader::ProgramPtr program;
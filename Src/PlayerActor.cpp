@@ -13,7 +13,7 @@
 * @param pos vC[̏W
 * @param rot vC[̏
 */
-PlayerActor::PlayerActor(const Terrain::HeightMap* hm, const Mesh::Buffer& buffer,
+PlayerActor::PlayerActor(const Terrain::HeightMap* hm, Mesh::Buffer& buffer,
 	const glm::vec3& pos, const glm::vec3& rot)
 	:SkeletalMeshActor(buffer.GetSkeletalMesh("Bikuni"), "Player", 13, pos, rot),
 	heightMap(hm)
@@ -14,7 +14,7 @@
 class PlayerActor : public SkeletalMeshActor
 {
 public:
-	PlayerActor(const Terrain::HeightMap* hm, const Mesh::Buffer& buffer,
+	PlayerActor(const Terrain::HeightMap* hm, Mesh::Buffer& buffer,
 		const glm::vec3& pos, const glm::vec3& rot = glm::vec3(0));
 	virtual ~PlayerActor() = default;
 
@@ -0,0 +1,385 @@
+/**
+* @file Profiler.cpp
+*/
+#include "Profiler.h"
+#include "json11/json11.hpp"
+#include <chrono>
+#include <deque>
+#include <algorithm>
+#include <unordered_map>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+
+namespace Profiler
+{
+	namespace /* unnamed */
+	{
+		using Clock = std::chrono::steady_clock;
+		const int gpuFrameCount = 2;//GPUԂ̌vʂǂݏo܂ł̃t[
+		const size_t maxTraceEventCount = 100000;//Chromeg[XpɕێԂ̍ő吔
+		const float averageWeight = 0.05f;//ړςɐVvl銄
+
+		/**
+		* v
+		*/
+		struct Event
+		{
+			int name;//Ԗ̔ԍ
+			int depth;//q̐[
+			double start;//Jn(}CNb)
+			double duration;//oߎ(}CNb)
+			uint64_t frame;//vt[̔ԍ
+			bool gpu;//GPUԂȂtrue
+		};
+
+		/**
+		* v̋
+		*/
+		struct OpenScope
+		{
+			int name;//Ԗ̔ԍ
+			double start;//Jn(}CNb)
+			bool hasQuery;//GPUԂ̃NG𔭍sĂtrue
+		};
+
+		/**
+		* GPUԂ̃NG
+		*/
+		struct GpuQuery
+		{
+			GLuint id;//NGIuWFNgID
+			int name;//Ԗ̔ԍ
+			int depth;//q̐[
+			double cpuStart;//CPŮJn(g[XGPUԂuʒuɎg)
+		};
+
+		/**
+		* 1t[GPUԂ̃NG
+		*/
+		struct GpuFrame
+		{
+			std::vector<GpuQuery> queries;//쐬NG(usedڈȍ~͖gp)
+			size_t used = 0;//̃t[ŎgNG̐
+			uint64_t frame = 0;//NGgt[̔ԍ
+		};
+
+		const Clock::time_point origin = Clock::now();//̊
+		bool enabled = true;//vLȂtrue
+		bool nextEnabled = true;//̃t[Kpenabled̒l
+		uint64_t frameNumber = 0;//݂̃t[̔ԍ
+		std::vector<OpenScope> stack;//v̋
+		bool isQueryActive = false;//GPUԂ̃NGvȂtrue
+		GpuFrame gpuFrames[gpuFrameCount];
+		std::unordered_map<std::string, int> nameIds;//ԖƔԍ̑Ή\
+		std::vector<SummaryItem> summary;//ԖƂ̕ώ
+		std::vector<double> frameCpuTime;//ԖƂ́Ãt[CPUԂ̍v(~b)
+		std::vector<double> frameGpuTime;//ԖƂ́AWṽt[GPUԂ̍v(~b)
+		std::deque<Event> trace;//Chromeg[Xp̋
+
+		/**
+		* ݎ擾
+		*
+		* @return ̌oߎ(}CNb)
+		*/
+		double Now()
+		{
+			return std::chrono::duration<double, std::micro>(Clock::now() - origin).count();
+		}
+
+		/**
+		* Ԗ̔ԍ擾
+		*
+		* @param name  Ԗ
+		* @param depth q̐[(߂ČԖ̏ꍇɋL^)
+		*
+		* @return Ԗ̔ԍ
+		*/
+		int GetNameId(const char* name, int depth)
+		{
+			const auto itr = nameIds.find(name);
+			if (itr != nameIds.end())
+			{
+				return itr->second;
+			}
+			const int id = static_cast<int>(summary.size());
+			nameIds.emplace(name, id);
+			SummaryItem item;
+			item.name = name;
+			item.depth = depth;
+			summary.push_back(item);
+			frameCpuTime.push_back(-1);
+			frameGpuTime.push_back(-1);
+			return id;
+		}
+
+		/**
+		* g[XɋԂǉ
+		*
+		* @param e ǉ
+		*
+		* ő吔𒴂ÂԂ̂Ă
+		*/
+		void AddEvent(const Event& e)
+		{
+			trace.push_back(e);
+			if (trace.size() > maxTraceEventCount)
+			{
+				trace.pop_front();
+			}
+		}
+
+		/**
+		* ړςXV
+		*
+		* @param average ړ
+		* @param value   Vvl
+		*/
+		void UpdateAverage(float& average, double value)
+		{
+			if (average <= 0)
+			{
+				average = static_cast<float>(value);
+			}
+			else
+			{
+				average += (static_cast<float>(value) - average) * averageWeight;
+			}
+		}
+
+		/**
+		* GPUԂ̌vʂǂݏo
+		*
+		* @param f ǂݏot[
+		*
+		* ʂoĂȂNG͑҂Ɏ̂Ă
+		*/
+		void CollectGpuResults(GpuFrame& f)
+		{
+			for (size_t i = 0; i < f.used; ++i)
+			{
+				const GpuQuery& q = f.queries[i];
+				GLint available = 0;
+				glGetQueryObjectiv(q.id, GL_QUERY_RESULT_AVAILABLE, &available);
+				if (!available)
+				{
+					continue;
+				}
+				GLuint64 elapsed = 0;
+				glGetQueryObjectui64v(q.id, GL_QUERY_RESULT, &elapsed);
+				AddEvent({ q.name, q.depth, q.cpuStart, elapsed / 1000.0, f.frame, true });
+				double& total = frameGpuTime[q.name];
+				total = std::max(total, 0.0) + elapsed / 1000000.0;
+			}
+			for (size_t i = 0; i < summary.size(); ++i)
+			{
+				if (frameGpuTime[i] >= 0)
+				{
+					UpdateAverage(summary[i].gpuTime, frameGpuTime[i]);
+					summary[i].hasGpuTime = true;
+					frameGpuTime[i] = -1;
+				}
+			}
+			f.used = 0;
+		}
+
+	} // unnamed namespace
+
+	/**
+	* t[̌vJn
+	*
+	* 2t[OGPUԂǂݏoĂA"Frame"Ԃ̌vn߂
+	*/
+	void BeginFrame()
+	{
+		enabled = nextEnabled;
+		if (!enabled)
+		{
+			return;
+		}
+		GpuFrame& f = gpuFrames[frameNumber % gpuFrameCount];
+		CollectGpuResults(f);
+		f.frame = frameNumber;
+		BeginCpu("Frame");
+	}
+
+	/**
+	* t[̌vI
+	*
+	* ̃t[CPUԂ𕽋ςɔf
+	*/
+	void EndFrame()
+	{
+		if (!enabled)
+		{
+			return;
+		}
+		while (!stack.empty())
+		{
+			EndCpu();
+		}
+		for (size_t i = 0; i < summary.size(); ++i)
+		{
+			if (frameCpuTime[i] >= 0)
+			{
+				UpdateAverage(summary[i].cpuTime, frameCpuTime[i]);
+				frameCpuTime[i] = -1;
+			}
+		}
+		++frameNumber;
+	}
+
+	/**
+	* CPUԂ̌vJn
+	*
+	* @param name Ԗ
+	*/
+	void BeginCpu(const char* name)
+	{
+		if (!enabled)
+		{
+			return;
+		}
+		const int id = GetNameId(name, static_cast<int>(stack.size()));
+		stack.push_back({ id, Now(), false });
+	}
+
+	/**
+	* ŌɊJnCPUԂ̌vI
+	*/
+	void EndCpu()
+	{
+		if (stack.empty())
+		{
+			return;
+		}
+		const OpenScope s = stack.back();
+		stack.pop_back();
+		const double duration = Now() - s.start;
+		AddEvent({ s.name, static_cast<int>(stack.size()), s.start, duration, frameNumber, false });
+		double& total = frameCpuTime[s.name];
+		total = std::max(total, 0.0) + duration / 1000.0;
+	}
+
+	/**
+	* CPUԂGPUԂ̌vJn
+	*
+	* @param name Ԗ
+	*
+	* GPUԂ̓łCPUԂv
+	*/
+	void BeginGpu(const char* name)
+	{
+		BeginCpu(name);
+		if (!enabled || isQueryActive)
+		{
+			return;
+		}
+		GpuFrame& f = gpuFrames[frameNumber % gpuFrameCount];
+		if (f.used >= f.queries.size())
+		{
+			GpuQuery q = {};
+			glGenQueries(1, &q.id);
+			f.queries.push_back(q);
+		}
+		GpuQuery& q = f.queries[f.used++];
+		q.name = stack.back().name;
+		q.depth = static_cast<int>(stack.size()) - 1;
+		q.cpuStart = stack.back().start;
+		glBeginQuery(GL_TIME_ELAPSED, q.id);
+		stack.back().hasQuery = true;
+		isQueryActive = true;
+	}
+
+	/**
+	* ŌɊJnCPUԂGPUԂ̌vI
+	*/
+	void EndGpu()
+	{
+		if (!stack.empty() && stack.back().hasQuery)
+		{
+			glEndQuery(GL_TIME_ELAPSED);
+			isQueryActive = false;
+		}
+		EndCpu();
+	}
+
+	/**
+	* v̗LE؂ւ
+	*
+	* @param enabled trueȂLAfalseȂ疳
+	*
+	* v̋ԂƐHȂ悤ɁABeginFrameKp
+	*/
+	void SetEnabled(bool enabled)
+	{
+		nextEnabled = enabled;
+	}
+
+	/**
+	* vLׂ
+	*
+	* @retval true  L
+	* @retval false 
+	*/
+	bool IsEnabled()
+	{
+		return enabled;
+	}
+
+	/**
+	* ԖƂ̕ώԂ擾
+	*
+	* @return ԖƂ̕ώ(߂Čvɕ)
+	*/
+	const std::vector<SummaryItem>& GetSummary()
+	{
+		return summary;
+	}
+
+	/**
+	* ێĂԂChromẽg[X`(JSON)ŏo
+	*
+	* @param path ot@C
+	*
+	* @retval true  o
+	* @retval false os
+	*
+	* CPUԂtid=1AGPUԂtid=2ɏo͂
+	* GPUԂ̊Jn͕Ȃ̂ŁAΉCPUԂ̊Jnɒu
+	*/
+	bool ExportChromeTrace(const char* path)
+	{
+		std::vector<json11::Json> events;
+		events.reserve(trace.size() + 2);
+		events.push_back(json11::Json::object{ { "name", "thread_name" }, { "ph", "M" },
+			{ "pid", 1 }, { "tid", 1 }, { "args", json11::Json::object{ { "name", "CPU" } } } });
+		events.push_back(json11::Json::object{ { "name", "thread_name" }, { "ph", "M" },
+			{ "pid", 1 }, { "tid", 2 }, { "args", json11::Json::object{ { "name", "GPU" } } } });
+		for (const Event& e : trace)
+		{
+			events.push_back(json11::Json::object{
+				{ "name", summary[e.name].name },
+				{ "cat", e.gpu ? "gpu" : "cpu" },
+				{ "ph", "X" },
+				{ "ts", e.start },
+				{ "dur", e.duration },
+				{ "pid", 1 },
+				{ "tid", e.gpu ? 2 : 1 },
+				{ "args", json11::Json::object{ { "frame", static_cast<double>(e.frame) },
+					{ "depth", e.depth } } } });
+		}
+		const json11::Json json = json11::Json::object{
+			{ "traceEvents", events }, { "displayTimeUnit", "ms" } };
+
+		std::ofstream ofs(path);
+		if (!ofs)
+		{
+			std::cerr << "[G[]" << __func__ << ":" << path << "J܂\n";
+			return false;
+		}
+		ofs << json.dump();
+		return static_cast<bool>(ofs);
+	}
+
+} // namespace Profiler
@@ -0,0 +1,96 @@
+/**
+* @file Profiler.h
+*/
+#ifndef PROFILER_H_INCLUDED
+#define PROFILER_H_INCLUDED
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+/**
+* CPUGPȔԂԂƂɌv@\i[閼O
+*
+* CPU̎Ԃstd::chrono::steady_clockAGPU̎ԂGL_TIME_ELAPSEDNGŌv
+* GPǓʂ2t[̃NG݂ɎgA2t[ɓǂݏôGPŮ҂Ȃ
+* (̎_ŌʂoĂȂ΁Ǎv͎̂Ă)
+* GL_TIME_ELAPSEDNG͓qɂłȂ߁AGPUԂ̓GPUԂCPU̎Ԃv
+*
+* vʂ͎2̌`Ŏo
+* - GetSummary: ԖƂ̕ώ(ʕ\p)
+* - ExportChromeTrace: ŋ߂̃t[̑S(chrome://tracingœǂݍ߂JSON)
+*
+* Ԃ͉PROFILE_SCOPEAPROFILE_GPU_SCOPE}NŎw肷
+* PROFILER_DISABLED`ărhƁA}N͉ȂȂ
+*/
+namespace Profiler
+{
+	/**
+	* ԖƂ̕ώ
+	*/
+	struct SummaryItem
+	{
+		std::string name;//Ԗ
+		int depth = 0;//Ԃ̓q̐[(0łO)
+		float cpuTime = 0;//CPUԂ̕(~b)
+		float gpuTime = 0;//GPUԂ̕(~b)
+		bool hasGpuTime = false;//GPUԂvԂȂtrue
+	};
+
+	void BeginFrame();
+	void EndFrame();
+	void BeginCpu(const char* name);
+	void EndCpu();
+	void BeginGpu(const char* name);
+	void EndGpu();
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled();
+	const std::vector<SummaryItem>& GetSummary();
+	bool ExportChromeTrace(const char* path);
+
+	/**
+	* CPUԂv
+	*
+	* RXgN^fXgN^܂ł̎Ԃv
+	*/
+	class CpuScope
+	{
+	public:
+		explicit CpuScope(const char* name) { BeginCpu(name); }
+		~CpuScope() { EndCpu(); }
+		CpuScope(const CpuScope&) = delete;
+		CpuScope& operator=(const CpuScope&) = delete;
+	};
+
+	/**
+	* CPUԂGPUԂv
+	*
+	* RXgN^fXgN^܂ł̎Ԃv
+	*/
+	class GpuScope
+	{
+	public:
+		explicit GpuScope(const char* name) { BeginGpu(name); }
+		~GpuScope() { EndGpu(); }
+		GpuScope(const GpuScope&) = delete;
+		GpuScope& operator=(const GpuScope&) = delete;
+	};
+
+} // namespace Profiler
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+#ifndef PROFILER_DISABLED
+//̃}NsAubN̏I܂łCPUԂv
+#define PROFILE_SCOPE(name) \
+	Profiler::CpuScope PROFILER_CONCAT(profilerScope, __LINE__)(name)
+//̃}NsAubN̏I܂łCPUԂGPUԂv
+#define PROFILE_GPU_SCOPE(name) \
+	Profiler::GpuScope PROFILER_CONCAT(profilerScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_GPU_SCOPE(name) ((void)0)
+#endif
+
+#endif // PROFILER_H_INCLUDED
@@ -0,0 +1,535 @@
+/**
+* @file RenderQueue.cpp
+*/
+#include "RenderQueue.h"
+#include "SkeletalMesh.h"
+#include "GLState.h"
+#include "RenderStats.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Mesh
+{
+	// Implemented in Mesh.cpp
+	void GetLodIndices(const Primitive& prim, int lod, GLsizei* count, const GLvoid** indices);
+	void BindMaterial(const Material& m);
+	void AddCullingStatistics(DrawType drawType, size_t drawn, size_t culled);
+
+	namespace /* unnamed */
+	{
+		//בւL[̊evf̃rbg
+		const int programBits = 10;
+		const int materialBits = 12;
+		const int vaoBits = 16;
+		const int lodBits = 2;
+		const int depthBits = 22;
+		const int blendedDepthBits = 24;
+		const uint64_t blendedPass = 1ull << 62;//`rbg
+
+		/**
+		* lw肵rbgɐ؂l߂
+		*/
+		uint64_t Mask(uint64_t value, int bits)
+		{
+			return value & ((1ull << bits) - 1);
+		}
+
+		/**
+		* J̋בւp̐ɕϊ
+		*
+		* @param distance J̋
+		*
+		* @param bits     ʎq̃rbg
+		*
+		* @return bitsrbg̐
+		*
+		* ̕_̓rbg𐮐ƂĔrĂ召֌WςȂ̂ŁA
+		* ʃrbgoΔ͈͂߂ɋʎqł
+		*/
+		uint64_t QuantizeDepth(float distance, int bits)
+		{
+			distance = std::max(distance, 0.0f);
+			uint32_t value;
+			std::memcpy(&value, &distance, sizeof(value));
+			return value >> (31 - bits);
+		}
+
+		/**
+		* CfbNX̌^̃oCg擾
+		*/
+		GLuint GetIndexSize(GLenum type)
+		{
+			switch (type)
+			{
+			case GL_UNSIGNED_BYTE: return 1;
+			case GL_UNSIGNED_SHORT: return 2;
+			default: return 4;
+			}
+		}
+
+		/**
+		* `PʂԐڕ`ł邩ׂ
+		*
+		* @retval true  Ԑڕ`ł
+		* @retval false Ԑڕ`łȂ
+		*/
+		bool CanDrawIndirect(const DrawItem& item)
+		{
+			return item.instancedProgram && !item.blended && item.uboSize == 0;
+		}
+
+		/**
+		* 2̕`Pʂ1̊Ԑڕ`ɂ܂Ƃ߂邩ׂ
+		*
+		* @retval true  ܂Ƃ߂
+		* @retval false ܂Ƃ߂Ȃ
+		*
+		* LODقȂĂĂAʂ̊Ԑڕ`R}hɂ΂܂Ƃ߂
+		*/
+		bool CanBatch(const DrawItem& a, const DrawItem& b)
+		{
+			return a.primitive == b.primitive && a.material == b.material &&
+				a.program == b.program && CanDrawIndirect(b);
+		}
+
+		/**
+		* `Pʂ̃CX^Xf[^쐬
+		*/
+		InstanceData MakeInstanceData(const DrawItem& item)
+		{
+			InstanceData data = {};
+			data.matModel = item.matModel;
+			return data;
+		}
+
+		/**
+		* בւL[\[gŏɕׂ
+		*
+		* @param keys בւL[̔z
+		* @param work Ɨp̔z
+		*
+		* 8bit8̈ȕzグ\[gs
+		* SẴL[œlɂȂ錅͕בւȗ
+		*/
+		template<typename T>
+		void RadixSort(std::vector<T>& keys, std::vector<T>& work)
+		{
+			if (keys.size() < 2)
+			{
+				return;
+			}
+			work.resize(keys.size());
+			for (int shift = 0; shift < 64; shift += 8)
+			{
+				size_t count[256] = {};
+				for (const T& e : keys)
+				{
+					++count[(e.key >> shift) & 0xff];
+				}
+				if (count[(keys[0].key >> shift) & 0xff] == keys.size())
+				{
+					continue;
+				}
+				size_t offset = 0;
+				for (size_t& e : count)
+				{
+					const size_t n = e;
+					e = offset;
+					offset += n;
+				}
+				for (const T& e : keys)
+				{
+					work[count[(e.key >> shift) & 0xff]++] = e;
+				}
+				keys.swap(work);
+			}
+		}
+
+	} // unnamed namespace
+
+	/**
+	* `v̎󂯕tJn
+	*
+	* @param type `悷f[^̎
+	* @param matV `Ɏgpr[s
+	*/
+	void RenderQueue::Begin(DrawType type, const glm::mat4& matV)
+	{
+		drawType = type;
+		matView = matV;
+		items.clear();
+		keys.clear();
+		materialIds.clear();
+		statistics = Statistics();
+	}
+
+	/**
+	* Ԑڕ`Lɂ
+	*
+	* @param buffer CX^Xf[^ƊԐڕ`R}h̓]ɂȂ郁bVobt@
+	*
+	* ̊֐Ă΂ȂꍇASĂ̕`Pʂʂɕ`悷
+	*/
+	void RenderQueue::Init(Buffer& buffer)
+	{
+		this->buffer = &buffer;
+		multiDrawIndirectSupported = GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+		multiDrawIndirect = multiDrawIndirectSupported;
+	}
+
+	/**
+	* glMultiDrawElementsIndirectgǂݒ肷
+	*
+	* @param enable trueȂgAfalseȂԐڕ`R}hCPU1`悷
+	*
+	* ΉĂȂłtruew肵ĂgȂ
+	*/
+	void RenderQueue::EnableMultiDrawIndirect(bool enable)
+	{
+		multiDrawIndirect = enable && multiDrawIndirectSupported;
+	}
+
+	/**
+	* sȃbV̕`v
+	*
+	* @param file   `悷t@C
+	* @param matM   `Ɏgp郂fs
+	* @param lod    `悷ڍדx(LOD)
+	*/
+	void RenderQueue::Submit(const FilePtr& file, const glm::mat4& matM, int lod)
+	{
+		DrawItem base;
+		base.lod = lod;
+		SubmitFile(file, matM, base);
+	}
+
+	/**
+	* ȃbV̕`v
+	*
+	* @param file      `悷t@C
+	* @param matM      `Ɏgp郂fs
+	* @param srcFactor `悷FɊ|W
+	* @param dstFactor `̐FɊ|W
+	*/
+	void RenderQueue::SubmitBlended(const FilePtr& file, const glm::mat4& matM,
+		GLenum srcFactor, GLenum dstFactor)
+	{
+		DrawItem base;
+		base.blended = true;
+		base.srcFactor = srcFactor;
+		base.dstFactor = dstFactor;
+		SubmitFile(file, matM, base);
+	}
+
+	/**
+	* t@C̃v~eBu`L[ɒǉ
+	*
+	* @param file `悷t@C
+	* @param matM `Ɏgp郂fs
+	* @param base v~eBuȊO̕`p[^
+	*
+	* ̊Oɂv~eBuƁAՕɉBĂt@C͒ǉȂ
+	*/
+	void RenderQueue::SubmitFile(const FilePtr& file, const glm::mat4& matM, const DrawItem& base)
+	{
+		if (!file || file->meshes.empty() || file->materials.empty())
+		{
+			return;
+		}
+		file->usage.Touch();
+		const Mesh& mesh = file->meshes[0];
+
+		//̊Oɂ邩ՕɉBĂΕ`悵Ȃ(E{[ȂbV͏ɕ`悷)
+		const bool hasBounds = file->sphere.r > 0;
+		if (!IsVisible(*file, matM))
+		{
+			AddCullingStatistics(drawType, 0, mesh.primitives.size());
+			return;
+		}
+		const bool testPrimitives = hasBounds && mesh.primitives.size() > 1;
+
+		DrawItem item = base;
+		item.matModel = matM;
+		for (const Primitive& p : mesh.primitives)
+		{
+			if (testPrimitives && !IsVisible(Collision::TransformAABB(p.aabb, matM)))
+			{
+				AddCullingStatistics(drawType, 0, 1);
+				continue;
+			}
+			if (p.material < 0 || p.material >= static_cast<int>(file->materials.size()))
+			{
+				continue;
+			}
+			const Material& m = file->materials[p.material];
+			item.primitive = &p;
+			item.material = &m;
+			item.program = (drawType == DrawType::shadow ? m.progShadow : m.program).get();
+			item.instancedProgram = (drawType == DrawType::shadow ?
+				m.progShadowInstanced : m.progInstanced).get();
+			Add(item, glm::vec3(matM * glm::vec4(p.sphere.center, 1)));
+		}
+	}
+
+	/**
+	* `Pʂ`L[ɒǉ
+	*
+	* @param item        ǉ`P
+	* @param worldCenter בւɎgv~eBu̒S([hWn)
+	*
+	* בւL[͏ʂ玟̏ɕ
+	* s:   pX(2bit) VF[_[(10bit) }eA(12bit) VAO(16bit) LOD(2bit) (22bit)
+	* :   pX(2bit) ̔](24bit) VF[_[(10bit) }eA(12bit) VAO(16bit)
+	*/
+	void RenderQueue::Add(const DrawItem& item, const glm::vec3& worldCenter)
+	{
+		if (!item.primitive || !item.material || !item.program || !item.primitive->vao)
+		{
+			return;
+		}
+		const float distance = -(matView * glm::vec4(worldCenter, 1)).z;
+		const uint64_t program = Mask(item.program->Get(), programBits);
+		const uint64_t material = Mask(GetMaterialId(item.material), materialBits);
+		const uint64_t vao = Mask(item.primitive->vao->Id(), vaoBits);
+
+		uint64_t key;
+		if (item.blended)
+		{
+			const uint64_t depth = QuantizeDepth(distance, blendedDepthBits);
+			const uint64_t farToNear = Mask(~depth, blendedDepthBits);
+			key = blendedPass | (farToNear << (programBits + materialBits + vaoBits)) |
+				(program << (materialBits + vaoBits)) | (material << vaoBits) | vao;
+		}
+		else
+		{
+			//v~eBuLODׂ荇悤ɁALODʂɒu
+			const uint64_t lod = Mask(std::max(item.lod, 0), lodBits);
+			const uint64_t depth = QuantizeDepth(distance, depthBits);
+			key = (program << (materialBits + vaoBits + lodBits + depthBits)) |
+				(material << (vaoBits + lodBits + depthBits)) |
+				(vao << (lodBits + depthBits)) | (lod << depthBits) | depth;
+		}
+		keys.push_back({ key, static_cast<uint32_t>(items.size()) });
+		items.push_back(item);
+	}
+
+	/**
+	* }eA̕בւpԍ擾
+	*
+	* @param material }eA
+	*
+	* @return בւpԍ(̃t[ōŏɒǉꂽ0, 1, 2...)
+	*/
+	uint32_t RenderQueue::GetMaterialId(const Material* material)
+	{
+		const auto result = materialIds.emplace(material,
+			static_cast<uint32_t>(materialIds.size()));
+		return result.first->second;
+	}
+
+	/**
+	* בւL[1̕`ł܂Ƃ߂͈͂
+	*
+	* A`PʂCanBatch̏𖞂Ԃ1͈̔͂ƂA
+	* ͈͓LODƂɊԐڕ`R}h1
+	* Ԑڕ`łȂ`Pʂ́A1͈̔͂ɂ
+	*/
+	void RenderQueue::BuildBatches()
+	{
+		batches.clear();
+		instanceData.clear();
+		commands.clear();
+		for (size_t i = 0; i < keys.size(); )
+		{
+			const DrawItem& first = items[keys[i].index];
+			const Primitive& p = *first.primitive;
+			const GLuint indexSize = GetIndexSize(p.type);
+			if (!buffer || !CanDrawIndirect(first))
+			{
+				batches.push_back({ i, 1, 0, 0 });
+				++i;
+				continue;
+			}
+			size_t n = 1;
+			while (i + n < keys.size() && CanBatch(first, items[keys[i + n].index]))
+			{
+				++n;
+			}
+
+			//בւL[LOD͋ʂɂ̂ŁALOD͘AĂ
+			Batch batch = { i, n, commands.size(), 0 };
+			for (size_t k = i; k < i + n; )
+			{
+				const int lod = items[keys[k].index].lod;
+				DrawElementsIndirectCommand cmd;
+				GLsizei count;
+				const GLvoid* indices;
+				GetLodIndices(p, lod, &count, &indices);
+				cmd.count = static_cast<GLuint>(count);
+				cmd.instanceCount = 0;
+				cmd.firstIndex = static_cast<GLuint>(reinterpret_cast<size_t>(indices) / indexSize);
+				cmd.baseVertex = p.baseVertex;
+				cmd.baseInstance = static_cast<GLuint>(instanceData.size());
+				for (; k < i + n && items[keys[k].index].lod == lod; ++k)
+				{
+					instanceData.push_back(MakeInstanceData(items[keys[k].index]));
+					++cmd.instanceCount;
+				}
+				commands.push_back(cmd);
+				++batch.commandCount;
+			}
+			batches.push_back(batch);
+			i += n;
+		}
+	}
+
+	/**
+	* `Pʂ1`悷
+	*
+	* @param item `悷`P
+	*/
+	void RenderQueue::DrawItemSingle(const DrawItem& item)
+	{
+		const Primitive& p = *item.primitive;
+		Shader::Program& program = *item.program;
+		if (item.blended)
+		{
+			GLState::BlendFunc(item.srcFactor, item.dstFactor);
+		}
+
+		program.Use();
+		program.SetPositionQuantization(p.positionScale, p.positionOffset);
+		if (item.uboSize > 0)
+		{
+			//XP^bṼfs͎pf[^Ɋ܂܂Ă
+			SkeletalAnimation::BindUniformData(item.uboOffset, item.uboSize);
+		}
+		else
+		{
+			program.SetModelMatrix(item.matModel);
+		}
+		BindMaterial(*item.material);
+		p.vao->Bind();
+
+		GLsizei count;
+		const GLvoid* indices;
+		GetLodIndices(p, item.lod, &count, &indices);
+		glDrawElementsBaseVertex(p.mode, count, p.type, indices, p.baseVertex);
+		RenderStats::AddDrawCall();
+		RenderStats::AddPrimitives(p.mode, count);
+		++statistics.drawCalls;
+		AddCullingStatistics(drawType, 1, 0);
+	}
+
+	/**
+	* ܂Ƃ߂`PʂԐڕ`悷
+	*
+	* @param batch          `悷͈
+	* @param instanceOffset CX^Xf[^obt@́AFlushœ]f[^̊Jnʒu
+	* @param commandOffset  Ԑڕ`R}hobt@́AFlushœ]R}h̊Jnʒu
+	*
+	* glMultiDrawElementsIndirectgȂꍇ́AR}hCPU1`悷
+	*/
+	void RenderQueue::DrawBatch(const Batch& batch, GLintptr instanceOffset, GLintptr commandOffset)
+	{
+		const DrawItem& item = items[keys[batch.first].index];
+		const Primitive& p = *item.primitive;
+		Shader::Program& program = *item.instancedProgram;
+
+		program.Use();
+		program.SetPositionQuantization(p.positionScale, p.positionOffset);
+		BindMaterial(*item.material);
+		p.vao->Bind();
+		glBindVertexBuffer(instanceBindingIndex, buffer->GetInstanceBuffer(),
+			instanceOffset, sizeof(InstanceData));
+
+		if (multiDrawIndirect)
+		{
+			const GLintptr offset = commandOffset +
+				batch.commandIndex * sizeof(DrawElementsIndirectCommand);
+			glMultiDrawElementsIndirect(p.mode, p.type, reinterpret_cast<const GLvoid*>(offset),
+				static_cast<GLsizei>(batch.commandCount), 0);
+			RenderStats::AddDrawCall();
+			for (size_t i = batch.commandIndex; i < batch.commandIndex + batch.commandCount; ++i)
+			{
+				RenderStats::AddPrimitives(p.mode, commands[i].count, commands[i].instanceCount);
+			}
+			++statistics.drawCalls;
+		}
+		else
+		{
+			const GLuint indexSize = GetIndexSize(p.type);
+			for (size_t i = batch.commandIndex; i < batch.commandIndex + batch.commandCount; ++i)
+			{
+				const DrawElementsIndirectCommand& cmd = commands[i];
+				glDrawElementsInstancedBaseVertexBaseInstance(p.mode, cmd.count, p.type,
+					reinterpret_cast<const GLvoid*>(static_cast<size_t>(cmd.firstIndex) * indexSize),
+					cmd.instanceCount, cmd.baseVertex, cmd.baseInstance);
+				RenderStats::AddDrawCall();
+				RenderStats::AddPrimitives(p.mode, cmd.count, cmd.instanceCount);
+				++statistics.drawCalls;
+			}
+		}
+		++statistics.indirectDrawCalls;
+		statistics.commands += batch.commandCount;
+		statistics.instances += batch.count;
+		AddCullingStatistics(drawType, batch.count, 0);
+	}
+
+	/**
+	* `L[בւāASĂ̕`Pʂ`悷
+	*
+	* `A`L[͋ɂȂ
+	*/
+	void RenderQueue::Flush()
+	{
+		RadixSort(keys, sortBuffer);
+		BuildBatches();
+
+		//CX^Xf[^ƊԐڕ`R}h͂܂Ƃ߂1œ]
+		GLintptr instanceOffset = -1;
+		GLintptr commandOffset = -1;
+		if (!commands.empty())
+		{
+			instanceOffset = buffer->AddInstanceData(
+				instanceData.data(), instanceData.size() * sizeof(InstanceData));
+			if (multiDrawIndirect)
+			{
+				commandOffset = buffer->AddIndirectCommandData(
+					commands.data(), commands.size() * sizeof(DrawElementsIndirectCommand));
+			}
+			else
+			{
+				commandOffset = 0;
+			}
+		}
+		const bool canDrawIndirect = instanceOffset >= 0 && commandOffset >= 0;
+		if (canDrawIndirect && multiDrawIndirect)
+		{
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer->GetIndirectBuffer());
+		}
+
+		for (const Batch& batch : batches)
+		{
+			if (batch.commandCount > 0 && canDrawIndirect)
+			{
+				DrawBatch(batch, instanceOffset, commandOffset);
+				continue;
+			}
+			//]łȂꍇ͌ʂɕ`悷
+			for (size_t i = batch.first; i < batch.first + batch.count; ++i)
+			{
+				DrawItemSingle(items[keys[i].index]);
+			}
+		}
+
+		if (canDrawIndirect && multiDrawIndirect)
+		{
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		}
+		items.clear();
+		keys.clear();
+		materialIds.clear();
+	}
+
+}//namespace Mesh
@@ -0,0 +1,137 @@
+/**
+* @file RenderQueue.h
+*/
+#ifndef RENDERQUEUE_H_INCLUDED
+#define RENDERQUEUE_H_INCLUDED
+#include <GL/glew.h>
+#include "Mesh.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace Mesh
+{
+	/**
+	* `L[ɐςޕ`P(1v~eBu)
+	*/
+	struct DrawItem
+	{
+		const Primitive* primitive = nullptr;
+		const Material* material = nullptr;
+		Shader::Program* program = nullptr;//`ɎgpVF[_[
+		Shader::Program* instancedProgram = nullptr;//CX^X`p̃VF[_[(nullptrȂCX^X`悵Ȃ)
+		glm::mat4 matModel = glm::mat4(1);
+		int lod = 0;//`悷ڍדx(LOD)
+
+		//XP^bV̎pf[^̈ʒu(uboSize0ȂX^eBbNbV)
+		GLintptr uboOffset = 0;
+		GLsizeiptr uboSize = 0;
+
+		//`̐ݒ(blendedfalseȂs)
+		bool blended = false;
+		GLenum srcFactor = GL_ONE;
+		GLenum dstFactor = GL_ONE_MINUS_SRC_ALPHA;
+	};
+
+	/**
+	* Ԑڕ`R}h(glMultiDrawElementsIndirecẗ̌`)
+	*/
+	struct DrawElementsIndirectCommand
+	{
+		GLuint count;//CfbNX
+		GLuint instanceCount;//CX^X
+		GLuint firstIndex;//ŏ̃CfbNẌʒu(CfbNXP)
+		GLint baseVertex;//CfbNXɉZl
+		GLuint baseInstance;//ŏ̃CX^Xf[^̔ԍ
+	};
+
+	/**
+	* `L[
+	*
+	* `v64bit̕בւL[ƈꏏɋL^AFlushł܂Ƃ߂ĕ`悷
+	* sȃv~eBu̓VF[_[A}eAAVAȌőďԂ̐؂ւ炵A
+	* Ԃ̒ł͎O`悵đ[xeXg悤ɂ
+	* ȃv~eBu͕sȃv~eBûƂɁA珇ɕ`悷
+	* בւ̌ʁAv~eBuAꍇ́ALODƂ̊Ԑڕ`R}h
+	* glMultiDrawElementsIndirectł܂Ƃ߂ĕ`悷
+	* fsȂǂ̕`PʂƂ̃f[^́AbaseInstanceőIԃCX^Xf[^Ƃēn
+	*/
+	class RenderQueue
+	{
+	public:
+		/**
+		* `̓v
+		*/
+		struct Statistics
+		{
+			size_t drawCalls = 0;//`֐̌Ăяo
+			size_t indirectDrawCalls = 0;//̂Ԑڕ`̉
+			size_t commands = 0;//Ԑڕ`R}h̐
+			size_t instances = 0;//Ԑڕ`ŕ`悵v~eBu̐
+		};
+
+		RenderQueue() = default;
+		~RenderQueue() = default;
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue& operator=(const RenderQueue&) = delete;
+
+		void Init(Buffer& buffer);
+		void EnableMultiDrawIndirect(bool enable);
+		bool IsMultiDrawIndirectEnabled() const { return multiDrawIndirect; }
+		void Begin(DrawType drawType, const glm::mat4& matView);
+		void Submit(const FilePtr& file, const glm::mat4& matM, int lod = 0);
+		void SubmitBlended(const FilePtr& file, const glm::mat4& matM,
+			GLenum srcFactor, GLenum dstFactor);
+		void Add(const DrawItem& item, const glm::vec3& worldCenter);
+		void Flush();
+
+		DrawType GetDrawType() const { return drawType; }
+		size_t Size() const { return items.size(); }
+		const Statistics& GetStatistics() const { return statistics; }//ŌBeginȍ~̓v
+
+	private:
+		/**
+		* בւL[ƕ`Pʂ̔ԍ̑g
+		*/
+		struct SortKey
+		{
+			uint64_t key;
+			uint32_t index;
+		};
+
+		/**
+		* 1̕`ł܂Ƃ߂`Pʂ͈̔
+		*/
+		struct Batch
+		{
+			size_t first;//ŏ̕בւL[̔ԍ
+			size_t count;//`Pʂ̐
+			size_t commandIndex;//ŏ̊Ԑڕ`R}h̔ԍ
+			size_t commandCount;//Ԑڕ`R}h̐(0Ȃʂɕ`悷)
+		};
+
+		void SubmitFile(const FilePtr& file, const glm::mat4& matM, const DrawItem& base);
+		uint32_t GetMaterialId(const Material* material);
+		void BuildBatches();
+		void DrawItemSingle(const DrawItem& item);
+		void DrawBatch(const Batch& batch, GLintptr instanceOffset, GLintptr commandOffset);
+
+		DrawType drawType = DrawType::color;
+		glm::mat4 matView = glm::mat4(1);
+		std::vector<DrawItem> items;
+		std::vector<SortKey> keys;
+		std::vector<SortKey> sortBuffer;//\[g̍Ɨ̈
+		std::unordered_map<const Material*, uint32_t> materialIds;//}eA̕בւpԍ
+
+		Buffer* buffer = nullptr;//CX^Xf[^̓](nullptrȂCX^X`悵Ȃ)
+		std::vector<Batch> batches;
+		std::vector<InstanceData> instanceData;
+		std::vector<DrawElementsIndirectCommand> commands;
+		bool multiDrawIndirectSupported = false;//glMultiDrawElementsIndirectgȂtrue
+		bool multiDrawIndirect = false;//falseȂԐڕ`R}hCPU1`悷
+		Statistics statistics;
+	};
+
+}//namespace Mesh
+#endif //RENDERQUEUE_H_INCLUDED
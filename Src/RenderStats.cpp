@@ -0,0 +1,207 @@
+/**
+* @file RenderStats.cpp
+*/
+#include "RenderStats.h"
+#include "GLState.h"
+#include <deque>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+
+namespace RenderStats
+{
+	namespace /* unnamed */
+	{
+		/**
+		* CSV̗
+		*/
+		struct Column
+		{
+			const char* name;//
+			size_t Counters::* member;//li[郁o
+		};
+		const Column columns[] = {
+			{ "drawCalls", &Counters::drawCalls },
+			{ "instances", &Counters::instances },
+			{ "triangles", &Counters::triangles },
+			{ "stateChanges", &Counters::stateChanges },
+			{ "textureBinds", &Counters::textureBinds },
+			{ "uploadCount", &Counters::uploadCount },
+			{ "uploadedBytes", &Counters::uploadedBytes },
+		};
+
+		Counters current;//݂̃t[̒l
+		std::deque<Counters> history;//߂̃t[̒l(Õt[)
+		size_t historySize = 300;//ێt[
+		uint64_t frameNumber = 0;//m肵t[̐
+
+	} // unnamed namespace
+
+	/**
+	* `֐̌Ăяo1񐔂
+	*/
+	void AddDrawCall()
+	{
+		++current.drawCalls;
+	}
+
+	/**
+	* `悵v~eBu𐔂
+	*
+	* @param mode          v~eBu̎
+	* @param count         _(CfbNX)̐
+	* @param instanceCount CX^X̐
+	*
+	* Op`ȊÕv~eBúACX^X𐔂
+	*/
+	void AddPrimitives(GLenum mode, GLsizei count, GLsizei instanceCount)
+	{
+		if (count <= 0 || instanceCount <= 0)
+		{
+			return;
+		}
+		size_t triangles = 0;
+		switch (mode)
+		{
+		case GL_TRIANGLES:
+			triangles = count / 3;
+			break;
+		case GL_TRIANGLE_STRIP:
+		case GL_TRIANGLE_FAN:
+			triangles = count > 2 ? count - 2 : 0;
+			break;
+		default:
+			break;
+		}
+		current.instances += instanceCount;
+		current.triangles += triangles * instanceCount;
+	}
+
+	/**
+	* eNX`̃oCh1񐔂
+	*/
+	void AddTextureBind()
+	{
+		++current.textureBinds;
+	}
+
+	/**
+	* obt@ւ̓]1񐔂
+	*
+	* @param bytes ]oCg
+	*/
+	void AddUpload(size_t bytes)
+	{
+		++current.uploadCount;
+		current.uploadedBytes += bytes;
+	}
+
+	/**
+	* t[̏IɌĂяoāÃ݂t[̒lm肷
+	*
+	* Ԑݒ̉񐔂荞ނ߁AGLState::EndFraměŌĂяo
+	*/
+	void EndFrame()
+	{
+		current.stateChanges = GLState::GetFrameStatistics().issued;
+		history.push_back(current);
+		while (history.size() > historySize)
+		{
+			history.pop_front();
+		}
+		current = Counters();
+		++frameNumber;
+	}
+
+	/**
+	* Õt[̒l擾
+	*
+	* @return Õt[̒l
+	*/
+	const Counters& GetFrameCounters()
+	{
+		static const Counters empty;
+		return history.empty() ? empty : history.back();
+	}
+
+	/**
+	* ̍ŏEρEő擾
+	*
+	* @return ̏Wv
+	*/
+	Summary GetSummary()
+	{
+		Summary summary;
+		summary.frameCount = history.size();
+		if (history.empty())
+		{
+			return summary;
+		}
+		summary.min = history.front();
+		for (const Column& c : columns)
+		{
+			size_t total = 0;
+			for (const Counters& e : history)
+			{
+				summary.min.*c.member = std::min(summary.min.*c.member, e.*c.member);
+				summary.max.*c.member = std::max(summary.max.*c.member, e.*c.member);
+				total += e.*c.member;
+			}
+			summary.average.*c.member = (total + history.size() / 2) / history.size();
+		}
+		return summary;
+	}
+
+	/**
+	* ێt[ݒ肷
+	*
+	* @param frameCount ێt[(1ȏ)
+	*/
+	void SetHistorySize(size_t frameCount)
+	{
+		historySize = std::max<size_t>(frameCount, 1);
+		while (history.size() > historySize)
+		{
+			history.pop_front();
+		}
+	}
+
+	/**
+	* CSVt@Cɏo
+	*
+	* @param path ot@C
+	*
+	* @retval true  o
+	* @retval false os
+	*
+	* 1sڂ͗񖼁A2sڈȍ~1t[1s(擪̗̓t[ԍ)
+	*/
+	bool DumpCsv(const char* path)
+	{
+		std::ofstream ofs(path);
+		if (!ofs)
+		{
+			std::cerr << "[G[]" << __func__ << ":" << path << "J܂\n";
+			return false;
+		}
+		ofs << "frame";
+		for (const Column& c : columns)
+		{
+			ofs << ',' << c.name;
+		}
+		ofs << '\n';
+		uint64_t frame = frameNumber - history.size();
+		for (const Counters& e : history)
+		{
+			ofs << frame++;
+			for (const Column& c : columns)
+			{
+				ofs << ',' << e.*c.member;
+			}
+			ofs << '\n';
+		}
+		return static_cast<bool>(ofs);
+	}
+
+} // namespace RenderStats
@@ -0,0 +1,61 @@
+/**
+* @file RenderStats.h
+*/
+#ifndef RENDERSTATS_H_INCLUDED
+#define RENDERSTATS_H_INCLUDED
+#include <GL/glew.h>
+#include <cstddef>
+
+/**
+* 1t[̕`Ŕs߂̐𐔂@\i[閼O
+*
+* `֐ƃobt@NXAOpenGL̊֐ĂяoтɑΉAdd֐ŉZ
+* Ԑݒ̉񐔂GLStatelEndFrameŎ荞
+* EndFrameŌ݂̃t[̒lm肵A߂̃t[̒l𗚗Ƃĕێ
+*
+* m肵l͎̕@Ŏo
+* - GetFrameCounters: Õt[̒l
+* - GetSummary: Ŝ̍ŏEρEő
+* - DumpCsv: ̑St[CSVt@Cɏo(ԃeXgł̐\̔p)
+*/
+namespace RenderStats
+{
+	/**
+	* 1t[̖߂̐
+	*/
+	struct Counters
+	{
+		size_t drawCalls = 0;//`֐̌Ăяo
+		size_t instances = 0;//`悵CX^X̐
+		size_t triangles = 0;//`悵Op`̐(CX^X|)
+		size_t stateChanges = 0;//GLStateۂɔsԐݒ̉
+		size_t textureBinds = 0;//eNX`̃oCh
+		size_t uploadCount = 0;//obt@ւ̓]
+		size_t uploadedBytes = 0;//obt@֓]oCg
+	};
+
+	/**
+	* ̏Wv
+	*/
+	struct Summary
+	{
+		size_t frameCount = 0;//Wvt[
+		Counters min;//ŏl
+		Counters average;//ϒl(_ȉ͎ľܓ)
+		Counters max;//ől
+	};
+
+	void AddDrawCall();
+	void AddPrimitives(GLenum mode, GLsizei count, GLsizei instanceCount = 1);
+	void AddTextureBind();
+	void AddUpload(size_t bytes);
+
+	void EndFrame();
+	const Counters& GetFrameCounters();
+	Summary GetSummary();
+	void SetHistorySize(size_t frameCount);
+	bool DumpCsv(const char* path);
+
+} // namespace RenderStats
+
+#endif // RENDERSTATS_H_INCLUDED
@@ -0,0 +1,150 @@
+/**
+* @file Residency.cpp
+*/
+#include "Residency.h"
+#include <algorithm>
+#include <iostream>
+
+namespace Residency
+{
+	/**
+	* AZbg݂̃t[ŎgpƂL^
+	*/
+	void Usage::Touch() const
+	{
+		lastUsedFrame = Manager::Instance().Frame();
+	}
+
+	/**
+	* AZbg풓ǗIuWFNg擾
+	*
+	* @return AZbg풓ǗIuWFNg
+	*/
+	Manager& Manager::Instance()
+	{
+		static Manager instance;
+		return instance;
+	}
+
+	/**
+	* AZbgo^
+	*
+	* @param type AZbg̎
+	* @param name AZbg
+	* @param cpuBytes AZbggpCPŨoCg
+	* @param gpuBytes AZbggpGPŨoCg
+	* @param usage AZbg̎gp
+	* @param isReferenced AZbgQƂĂ邩ׂ֐
+	* @param evict AZbgޔ֐
+	*
+	* @return o^ID. Unregisterɓnēo^
+	*/
+	int Manager::Register(Type type, const std::string& name, size_t cpuBytes, size_t gpuBytes,
+		const Usage* usage, IsReferencedFunc isReferenced, EvictFunc evict)
+	{
+		Entry e;
+		e.id = nextId++;
+		e.type = type;
+		e.name = name;
+		e.cpuBytes = cpuBytes;
+		e.gpuBytes = gpuBytes;
+		e.usage = usage;
+		e.isReferenced = isReferenced;
+		e.evict = evict;
+		entries.push_back(e);
+
+		this->cpuBytes += cpuBytes;
+		this->gpuBytes += gpuBytes;
+		return e.id;
+	}
+
+	/**
+	* AZbg̓o^
+	*
+	* @param id o^Ɏ擾ID
+	*
+	* ޔς݂̃AZbgIDw肵ꍇ͉Ȃ
+	*/
+	void Manager::Unregister(int id)
+	{
+		const auto itr = std::find_if(entries.begin(), entries.end(),
+			[id](const Entry& e) { return e.id == id; });
+		if (itr == entries.end())
+		{
+			return;
+		}
+		cpuBytes -= itr->cpuBytes;
+		gpuBytes -= itr->gpuBytes;
+		entries.erase(itr);
+	}
+
+	/**
+	* t[i߁A\Z𒴂ĂAZbgޔ
+	*
+	* C[v1t[1Ăяo
+	*/
+	void Manager::Update()
+	{
+		++frame;
+
+		while (cpuBytes + gpuBytes > budget)
+		{
+			//QƂĂȂAZbĝAŌɎgpꂽ̂łÂ̂I
+			auto victim = entries.end();
+			for (auto itr = entries.begin(); itr != entries.end(); ++itr)
+			{
+				if (itr->isReferenced && itr->isReferenced())
+				{
+					continue;
+				}
+				if (victim == entries.end() ||
+					itr->usage->LastUsedFrame() < victim->usage->LastUsedFrame())
+				{
+					victim = itr;
+				}
+			}
+			if (victim == entries.end())
+			{
+				if (!isOverBudget)
+				{
+					std::cerr << "[x]" << __func__ << ":\Z(" << budget <<
+						"oCg)𒴂Ă܂AޔłAZbg܂\n";
+					isOverBudget = true;
+				}
+				return;
+			}
+
+			//ޔ֐̒œo^񂪕ω\̂ŁAɓo^Ă
+			const Entry e = *victim;
+			cpuBytes -= e.cpuBytes;
+			gpuBytes -= e.gpuBytes;
+			entries.erase(victim);
+			++evictionCount;
+			if (e.evict)
+			{
+				e.evict();
+			}
+		}
+		isOverBudget = false;
+	}
+
+	/**
+	* gp󋵂\
+	*/
+	void Manager::PrintStatistics() const
+	{
+		static const char* const typeNames[] = { "mesh", "skeletalMesh", "texture" };
+		std::cout << "[]" << __func__ << ":AZbg=" << entries.size() <<
+			" CPU=" << cpuBytes << "oCg GPU=" << gpuBytes <<
+			"oCg \Z=" << budget << "oCg ޔ=" << evictionCount <<
+			" ēǂݍ=" << reloadCount << "\n";
+		for (const Entry& e : entries)
+		{
+			std::cout << "  " << typeNames[static_cast<int>(e.type)] << " " << e.name <<
+				" CPU=" << e.cpuBytes << " GPU=" << e.gpuBytes <<
+				" ŏIgpt[=" << e.usage->LastUsedFrame() <<
+				(e.isReferenced && e.isReferenced() ? " (Qƒ)" : "") << "\n";
+		}
+	}
+
+} //namespace Residency
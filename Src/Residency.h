@@ -0,0 +1,105 @@
+/**
+* @file Residency.h
+*/
+#ifndef RESIDENCY_H_INCLUDED
+#define RESIDENCY_H_INCLUDED
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+* AZbg̏풓ǗɊւ@\i[閼O
+*/
+namespace Residency
+{
+	/**
+	* 풓ǗAZbg̎
+	*/
+	enum class Type
+	{
+		mesh,//X^eBbNbV
+		skeletalMesh,//XP^bV
+		texture,//eNX`
+	};
+
+	/**
+	* AZbg̎gp
+	*
+	* `掞TouchĂяoāAŌɎgpꂽt[L^
+	*/
+	class Usage
+	{
+	public:
+		void Touch() const;
+		uint64_t LastUsedFrame() const { return lastUsedFrame; }
+
+	private:
+		mutable uint64_t lastUsedFrame = 0;
+	};
+
+	/**
+	* AZbg풓ǗNX
+	*
+	* o^ꂽAZbgCPUGPU̎gpʂL^Av\Z𒴂
+	* ǂQƂĂȂAZbgAŌɎgpꂽ̂Âɑޔ
+	* ޔAZbǵAɗvꂽƂɊe[_[ɂčēxǂݍ܂
+	*/
+	class Manager
+	{
+	public:
+		using IsReferencedFunc = std::function<bool()>;
+		using EvictFunc = std::function<void()>;
+
+		static Manager& Instance();
+
+		int Register(Type type, const std::string& name, size_t cpuBytes, size_t gpuBytes,
+			const Usage* usage, IsReferencedFunc isReferenced, EvictFunc evict);
+		void Unregister(int id);
+		void Update();
+
+		void SetBudget(size_t bytes) { budget = bytes; }
+		size_t Budget() const { return budget; }
+		size_t CpuBytes() const { return cpuBytes; }
+		size_t GpuBytes() const { return gpuBytes; }
+		size_t Count() const { return entries.size(); }
+		uint64_t Frame() const { return frame; }
+		size_t EvictionCount() const { return evictionCount; }
+		size_t ReloadCount() const { return reloadCount; }
+		void CountReload() { ++reloadCount; }
+		void PrintStatistics() const;
+
+	private:
+		Manager() = default;
+		~Manager() = default;
+		Manager(const Manager&) = delete;
+		Manager& operator = (const Manager&) = delete;
+
+		/**
+		* 풓Ǘ
+		*/
+		struct Entry
+		{
+			int id = 0;
+			Type type = Type::mesh;
+			std::string name;//AZbg
+			size_t cpuBytes = 0;//CPU̎gp
+			size_t gpuBytes = 0;//GPU̎gp
+			const Usage* usage = nullptr;//AZbg̎gp
+			IsReferencedFunc isReferenced;//AZbgQƂĂ邩ׂ֐
+			EvictFunc evict;//AZbgޔ֐
+		};
+		std::vector<Entry> entries;
+		int nextId = 1;
+		uint64_t frame = 1;
+		size_t budget = 256 * 1024 * 1024;//CPUGPU̍v̗\Z
+		size_t cpuBytes = 0;
+		size_t gpuBytes = 0;
+		size_t evictionCount = 0;//ޔAZbg̗݌v
+		size_t reloadCount = 0;//ޔɓǂݍݒAZbg̗݌v
+		bool isOverBudget = false;//\Z𒴂܂ܑޔłȂԂȂtrue
+	};
+
+} //namespace Residency
+
+#endif //RESIDENCY_H_INCLUDED
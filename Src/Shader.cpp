@@ -3,16 +3,280 @@
 */
 #include "Shader.h"
 #include "Geometry.h"
+#include "GLState.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 
 /*
 VF[_[Ɋւ@\i[閼O
 */
 namespace Shader
 {
+	namespace /* unnamed */
+	{
+		/**
+		* uniformϐ̃nbVlvZ(FNV-1a)
+		*
+		* @param name uniformϐ
+		*
+		* @return namẽnbVl
+		*/
+		uint64_t HashName(const char* name)
+		{
+			uint64_t hash = 14695981039346656037ull;
+			for (; *name; ++name)
+			{
+				hash ^= static_cast<uint8_t>(*name);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		/**
+		* vOoCĩLbVt@C̃wb_
+		*/
+		struct ProgramBinaryHeader
+		{
+			char magic[4];//t@C̎("PBIN")
+			uint32_t headerSize;//wb_̃oCg
+			uint64_t sourceHash;//VF[_[̃\[XR[h̃nbVl
+			uint64_t driverHash;//hCõx_[A_[Ao[W̃nbVl
+			uint32_t binaryFormat;//glGetProgramBinaryԂoCi`
+			uint32_t binaryLength;//oCĩoCg
+		};
+
+		const char programBinaryMagic[4] = { 'P', 'B', 'I', 'N' };
+		const char programBinaryCacheDirectory[] = "Cache";
+
+		BuildStatistics buildStatistics;
+
+		//vO쐬Ɋ蓖ĂUniformubNƃoCfBO|Cg
+		std::vector<std::pair<std::string, GLuint>> uniformBlockBindings;
+
+		/**
+		* ֐𔲂ƂɁAvOIuWFNg̍쐬Ԃ𓝌vɉZNX
+		*/
+		class BuildTimer
+		{
+		public:
+			BuildTimer() : start(std::chrono::steady_clock::now()) {}
+			~BuildTimer()
+			{
+				const std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+				buildStatistics.seconds += d.count();
+			}
+		private:
+			std::chrono::steady_clock::time_point start;
+		};
+
+		/**
+		* nbVlɉ(FNV-1a)
+		*
+		* @param hash ̃nbVl
+		* @param str  镶(nullptrȂ󕶎Ƃ݂Ȃ)
+		*
+		* @return strnbVl
+		*/
+		uint64_t HashString(uint64_t hash, const char* str)
+		{
+			for (; str && *str; ++str)
+			{
+				hash ^= static_cast<uint8_t>(*str);
+				hash *= 1099511628211ull;
+			}
+			//̋؂āA"ab"+"c""a"+"bc"ʂ
+			hash ^= 0xff;
+			hash *= 1099511628211ull;
+			return hash;
+		}
+
+		/**
+		* vOoCig邩ׂ
+		*
+		* @retval true  g
+		* @retval false gȂ
+		*/
+		bool IsProgramBinarySupported()
+		{
+			static int supported = -1;
+			if (supported < 0)
+			{
+				supported = 0;
+				if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+				{
+					GLint formatCount = 0;
+					glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+					supported = formatCount > 0;
+				}
+			}
+			return supported != 0;
+		}
+
+		/**
+		* hCoʂnbVl擾
+		*
+		* @return x_[A_[Ao[W̃nbVl
+		*
+		* hCoXVƃoCigȂȂ邽߁ALbV̏ƍɎg
+		*/
+		uint64_t GetDriverHash()
+		{
+			static uint64_t hash = 0;
+			if (!hash)
+			{
+				hash = 14695981039346656037ull;
+				hash = HashString(hash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+				hash = HashString(hash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+				hash = HashString(hash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+			}
+			return hash;
+		}
+
+		/**
+		* fBNg쐬
+		*
+		* @param path 쐬fBNg
+		*
+		* ɂꍇ͉Ȃ
+		*/
+		void MakeDirectory(const char* path)
+		{
+#ifdef _WIN32
+			_mkdir(path);
+#else
+			mkdir(path, 0755);
+#endif
+		}
+
+		/**
+		* LbVt@C쐬
+		*
+		* @param sourceHash VF[_[̃\[XR[h̃nbVl
+		*
+		* @return LbVt@C
+		*/
+		std::string GetCachePath(uint64_t sourceHash)
+		{
+			std::ostringstream ss;
+			ss << programBinaryCacheDirectory << "/Program_" << std::hex << std::setw(16) <<
+				std::setfill('0') << sourceHash << ".bin";
+			return ss.str();
+		}
+
+		/**
+		* LbVt@CvOIuWFNg쐬
+		*
+		* @param sourceHash VF[_[̃\[XR[h̃nbVl
+		*
+		* @retval 0傫 쐬vOIuWFNg
+		* @retval 0           LbVȂA\[XR[hhCovȂA
+		*                     ܂̓hCooCi󂯕tȂ
+		*/
+		GLuint LoadProgramBinary(uint64_t sourceHash)
+		{
+			if (!IsProgramBinarySupported())
+			{
+				return 0;
+			}
+			std::ifstream ifs(GetCachePath(sourceHash), std::ios_base::binary);
+			if (!ifs)
+			{
+				return 0;
+			}
+			ProgramBinaryHeader header;
+			if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)))
+			{
+				return 0;
+			}
+			if (std::memcmp(header.magic, programBinaryMagic, sizeof(header.magic)) != 0 ||
+				header.headerSize != sizeof(header) ||
+				header.sourceHash != sourceHash ||
+				header.driverHash != GetDriverHash() ||
+				header.binaryLength == 0)
+			{
+				return 0;
+			}
+			std::vector<char> binary(header.binaryLength);
+			if (!ifs.read(binary.data(), binary.size()))
+			{
+				return 0;
+			}
+			ifs.close();
+
+			const GLuint program = glCreateProgram();
+			glProgramBinary(program, header.binaryFormat, binary.data(), header.binaryLength);
+			GLint linkStatus = GL_FALSE;
+			glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+			if (linkStatus != GL_TRUE)
+			{
+				glDeleteProgram(program);
+				return 0;
+			}
+			return program;
+		}
+
+		/**
+		* vOIuWFNg̃oCiLbVt@Cɕۑ
+		*
+		* @param program    ۑvOIuWFNg
+		* @param sourceHash VF[_[̃\[XR[h̃nbVl
+		*
+		* ۑɎsĂANɃVF[_[rhȂ̂Ōxɗ߂
+		*/
+		void SaveProgramBinary(GLuint program, uint64_t sourceHash)
+		{
+			if (!IsProgramBinarySupported())
+			{
+				return;
+			}
+			GLint length = 0;
+			glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+			if (length <= 0)
+			{
+				return;
+			}
+			std::vector<char> binary(length);
+			GLenum binaryFormat = 0;
+			glGetProgramBinary(program, length, &length, &binaryFormat, binary.data());
+			if (length <= 0)
+			{
+				return;
+			}
+
+			ProgramBinaryHeader header;
+			std::memcpy(header.magic, programBinaryMagic, sizeof(header.magic));
+			header.headerSize = sizeof(header);
+			header.sourceHash = sourceHash;
+			header.driverHash = GetDriverHash();
+			header.binaryFormat = binaryFormat;
+			header.binaryLength = static_cast<uint32_t>(length);
+
+			MakeDirectory(programBinaryCacheDirectory);
+			const std::string path = GetCachePath(sourceHash);
+			std::ofstream ofs(path, std::ios_base::binary | std::ios_base::trunc);
+			if (!ofs ||
+				!ofs.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+				!ofs.write(binary.data(), length))
+			{
+				std::cerr << "[x]" << __func__ << ":" << path << "ɏ߂܂\n";
+			}
+		}
+
+	} // unnamed namespace
+
 	/**
 	*VF[_[EvORpC
 	*
@@ -64,9 +328,26 @@ namespace Shader
 
 * @retval 0傫 쐬vOEIuWFNg
 * @retval 0 vOEIuWFNg̍쐬Ɏs
+*
+* ȑOɓ\[XR[h쐬oCiLbVɂ΁Aǂݍ
+* \[XR[hhCoςĂꍇ̓rhăLbVXV
 */
 	GLuint Build(const GLchar* vsCode, const GLchar* fsCode)
 	{
+		BuildTimer timer;
+		++buildStatistics.programCount;
+		const uint64_t sourceHash = vsCode && fsCode ?
+			HashString(HashString(14695981039346656037ull, vsCode), fsCode) : 0;
+		if (sourceHash)
+		{
+			const GLuint cachedProgram = LoadProgramBinary(sourceHash);
+			if (cachedProgram)
+			{
+				++buildStatistics.cacheHitCount;
+				return cachedProgram;
+			}
+		}
+
 		GLuint vs = Compile(GL_VERTEX_SHADER, vsCode);
 		GLuint fs = Compile(GL_FRAGMENT_SHADER, fsCode);
 		if (!vs || !fs)
@@ -78,6 +359,10 @@ namespace Shader
 		glDeleteShader(fs);
 		glAttachShader(program, vs);
 		glDeleteShader(vs);
+		if (IsProgramBinarySupported())
+		{
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
 		glLinkProgram(program);
 		GLint linkStatus = GL_FALSE;
 		glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
@@ -98,32 +383,150 @@ namespace Shader
 			glDeleteProgram(program);
 			return 0;
 		}
+		if (sourceHash)
+		{
+			SaveProgramBinary(program, sourceHash);
+		}
 		return program;
 	}
 
+	/**
+	* UniformubÑoCfBO|Cgo^
+	*
+	* @param blockName    UniformubN
+	* @param bindingPoint 蓖ĂoCfBO|Cg
+	*
+	* Ȍ쐬vOIuWFNgɁAo^ubNΎIɊ蓖Ă
+	* KvɂȂƂɍ쐬VF[_[̔hłɂ蓖Ă邽߂Ɏg
+	*/
+	void SetUniformBlockBinding(const char* blockName, GLuint bindingPoint)
+	{
+		for (auto& e : uniformBlockBindings)
+		{
+			if (e.first == blockName)
+			{
+				e.second = bindingPoint;
+				return;
+			}
+		}
+		uniformBlockBindings.emplace_back(blockName, bindingPoint);
+	}
+
+	/**
+	* vOIuWFNg쐬̓v擾
+	*
+	* @return NĂ̓v
+	*/
+	const BuildStatistics& GetBuildStatistics()
+	{
+		return buildStatistics;
+	}
+
+	namespace /* unnamed */
+	{
+		const int maxIncludeDepth = 8;//#includeqɂł[
+
+		/**
+		* \[Xt@Cǂݍ݁A#includeWJ
+		*
+		* @param path  ǂݍ݃t@C
+		* @param depth #include̓q̐[
+		*
+		* @return ǂݍ񂾃f[^(I['\0't). sꍇ͋
+		*
+		* GLSLɂ#includeȂ̂ŁAǂݍނƂɁu#include "t@C"v̍s
+		* w肳ꂽt@C̓eɒu. t@C͓ǂݍރt@C̃tH_T
+		* G[bZ[W̍sԍ̃t@Cƈv悤#lineōsԍݒ肷
+		*/
+		std::vector<GLchar> ReadSource(const char* path, int depth)
+		{
+			std::basic_ifstream<GLchar> ifs;
+			ifs.open(path, std::ios_base::binary);
+			if (!ifs.is_open())
+			{
+				std::cerr << "ERROR:" << path << "J܂.\n";
+				return {};
+			}
+			ifs.seekg(0, std::ios_base::end);
+			const size_t length = (size_t)ifs.tellg();
+			ifs.seekg(0, std::ios_base::beg);
+			std::vector<GLchar> buf(length);
+			ifs.read(buf.data(), length);
+
+			const std::string src(buf.begin(), buf.end());
+			if (src.find("#include") == std::string::npos)
+			{
+				buf.push_back('\0');
+				return buf;
+			}
+			if (depth >= maxIncludeDepth)
+			{
+				std::cerr << "[G[]" << __func__ << ":" << path << "#include[܂\n";
+				return {};
+			}
+			const std::string pathString = path;
+			const size_t slash = pathString.find_last_of("/\\");
+			const std::string directory =
+				slash == std::string::npos ? std::string() : pathString.substr(0, slash + 1);
+
+			std::string result;
+			result.reserve(src.size());
+			int line = 1;
+			for (size_t pos = 0; pos < src.size(); ++line)
+			{
+				const size_t eol = src.find('\n', pos);
+				const size_t next = eol == std::string::npos ? src.size() : eol + 1;
+				const size_t head = src.find_first_not_of(" \t", pos);
+				if (head >= next || src.compare(head, 8, "#include") != 0)
+				{
+					result.append(src, pos, next - pos);
+					pos = next;
+					continue;
+				}
+				const size_t nameBegin = src.find('"', head);
+				const size_t nameEnd =
+					nameBegin < next ? src.find('"', nameBegin + 1) : std::string::npos;
+				if (nameEnd >= next)
+				{
+					std::cerr << "[G[]" << __func__ << ":" << path << "(" << line <<
+						"):#includẽt@Csł\n";
+					return {};
+				}
+				const std::string includePath =
+					directory + src.substr(nameBegin + 1, nameEnd - nameBegin - 1);
+				const std::vector<GLchar> included = ReadSource(includePath.c_str(), depth + 1);
+				if (included.empty())
+				{
+					return {};
+				}
+				result += "#line 1\n";
+				result += included.data();
+				if (result.back() != '\n')
+				{
+					result += '\n';
+				}
+				result += "#line " + std::to_string(line + 1) + "\n";
+				pos = next;
+			}
+			std::vector<GLchar> expanded(result.begin(), result.end());
+			expanded.push_back('\0');
+			return expanded;
+		}
+
+	} // unnamed namespace
+
 /*
 *t@Cǂݍ
 *
 * @param path ǂݍ݃t@C
 *
 * @return ǂݍ񂾃f[^
+*
+* u#include "t@C"v̍śÃt@C̓eɒu
 */
 	std::vector<GLchar> ReadFile(const char* path)
 	{
-		std::basic_ifstream<GLchar> ifs;
-		ifs.open(path, std::ios_base::binary);
-		if (!ifs.is_open())
-		{
-			std::cerr << "ERROR:" << path << "J܂.\n";
-			return {};
-		}
-		ifs.seekg(0, std::ios_base::end);
-		const size_t length = (size_t)ifs.tellg();
-		ifs.seekg(0, std::ios_base::beg);
-		std::vector<GLchar> buf(length);
-		ifs.read(buf.data(), length);
-		buf.push_back('\0');
-		return buf;
+		return ReadSource(path, 0);
 	}
 /**
 *t@CvOEIuWFNg쐬
@@ -164,7 +567,7 @@ namespace Shader
 	{
 		if (id)
 		{
-			glDeleteProgram(id);
+			GLState::DeleteProgram(id);
 		}
 	}
 /**
@@ -174,16 +577,14 @@ namespace Shader
 */
 	void Program::Reset(GLuint programId)
 	{
-		glDeleteProgram(id);
+		GLState::DeleteProgram(id);
 		id = programId;
+		locationCache.clear();
+		uniformValues.clear();
 		if (id == 0)
 		{
 			locMatMVP = -1;
 			locMatModel = -1;
-			GLint locPointLightCount = -1;
-			GLint locPointLightIndex = -1;
-			GLint locSpotLightCount = -1;
-			GLint locSpotLightIndex = -1;
 			GLint locCameraPosition = -1;
 			GLint locTime = -1;
 			GLint locViewInfo = -1;
@@ -193,18 +594,16 @@ namespace Shader
 		locMatMVP =          glGetUniformLocation(id, "matMVP");
 		locMatModel =        glGetUniformLocation(id, "matModel");
 		locMatShadow = glGetUniformLocation(id, "matShadow");
-		locPointLightCount = glGetUniformLocation(id, "pointLightCount");
-		locPointLightIndex = glGetUniformLocation(id, "pointLightIndex");
-		locSpotLightCount =  glGetUniformLocation(id, "spotLightCount");
-		locSpotLightIndex =  glGetUniformLocation(id, "spotLightIndex");
 		locCameraPosition =  glGetUniformLocation(id, "cameraPosition");
 		locTime =            glGetUniformLocation(id, "time");
 		locViewInfo =        glGetUniformLocation(id, "viewInfo");
 		locCameraInfo =      glGetUniformLocation(id, "cameraInfo");
 		locBlurDirection = glGetUniformLocation(id, "blurDirection");
 		locMatInverseViewRotation = glGetUniformLocation(id, "matInverseViewRotation");
+		locPositionScale = glGetUniformLocation(id, "positionScale");
+		locPositionOffset = glGetUniformLocation(id, "positionOffset");
 
-		glUseProgram(id);
+		GLState::UseProgram(id);
 		const GLint texColorLoc = glGetUniformLocation(id, "texColor");
 		if (texColorLoc >= 0)
 		{
@@ -233,16 +632,6 @@ namespace Shader
 				glUniform1i(texColorLoc, i + 8);
 			}
 		}
-		const GLint locTexPointLightIndex = glGetUniformLocation(id, "texPointLightIndex");
-		if (locTexPointLightIndex >= 0)
-		{
-			glUniform1i(locTexPointLightIndex, 4);
-		}
-		const GLint locTexSpotLightIndex = glGetUniformLocation(id, "texSpotLightIndex");
-		if (locTexSpotLightIndex >= 0)
-		{
-			glUniform1i(locTexSpotLightIndex, 5);
-		}
 		const GLint locTexCubeMap = glGetUniformLocation(id, "texCubeMap");
 		if (locTexCubeMap >= 0)
 		{
@@ -253,8 +642,21 @@ namespace Shader
 		{
 			glUniform1i(locTexShadow, shadowTextureBindingPoint);
 		}
+		const GLuint materialBlockIndex = glGetUniformBlockIndex(id, "MaterialUniformBlock");
+		if (materialBlockIndex != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(id, materialBlockIndex, materialUniformBindingPoint);
+		}
+		for (const auto& e : uniformBlockBindings)
+		{
+			const GLuint blockIndex = glGetUniformBlockIndex(id, e.first.c_str());
+			if (blockIndex != GL_INVALID_INDEX)
+			{
+				glUniformBlockBinding(id, blockIndex, e.second);
+			}
+		}
 
-		glUseProgram(0);
+		GLState::UseProgram(0);
 	}
 /**
 * vO IuWFNgݒ肳Ă邩ׂ
@@ -275,7 +677,7 @@ namespace Shader
 	{
 		if (id)
 		{
-			glUseProgram(id);
+			GLState::UseProgram(id);
 		}
 	}
 
@@ -287,8 +689,7 @@ namespace Shader
 	*/
 	void Program::BindTexture(GLuint unitNo, GLuint texId)
 	{
-		glActiveTexture(GL_TEXTURE0 + unitNo);
-		glBindTexture(GL_TEXTURE_2D, texId);
+		GLState::BindTexture(unitNo, GL_TEXTURE_2D, texId);
 	}
 
 	/**
@@ -299,10 +700,7 @@ namespace Shader
 	void Program::SetViewProjectionMatrix(const glm::mat4& matVP)
 	{
 		this->matVP = matVP;
-		if (locMatMVP >= 0)
-		{
-			glUniformMatrix4fv(locMatMVP, 1, GL_FALSE, &matVP[0][0]);
-		}
+		SetUniform(locMatMVP, matVP);
 	}
 
 	/**
@@ -315,7 +713,7 @@ namespace Shader
 		if (locMatInverseViewRotation >= 0)
 		{
 			const glm::mat3 m = glm::inverse(glm::mat3(glm::transpose(glm::inverse(matView))));
-			glUniformMatrix3fv(locMatInverseViewRotation, 1, GL_FALSE, &m[0][0]);
+			SetUniform(locMatInverseViewRotation, m);
 		}
 	}
 
@@ -326,57 +724,28 @@ namespace Shader
 	*/
 	void Program::SetShadowViewProjectionMatrix(const glm::mat4& m)
 	{
-		if (locMatShadow >= 0)
-		{
-			glUniformMatrix4fv(locMatShadow, 1, GL_FALSE, &m[0][0]);
-		}
+		SetUniform(locMatShadow, m);
 	}
 
 	/**
-	* `Ɏg郂fsݒ肷
+	* e̕`Ɏgr[vWFNVs̔zݒ肷
 	*
-	* @param m ݒ肷郂fs
+	* @param count s̐(JXP[hVhE}bv̕)
+	* @param m     ݒ肷epr[vWFNVs̔z
 	*/
-	void Program::SetModelMatrix(const glm::mat4& m)
+	void Program::SetShadowViewProjectionMatrix(int count, const glm::mat4* m)
 	{
-		if (locMatModel >= 0)
-		{
-			glUniformMatrix4fv(locMatModel, 1, GL_FALSE, &m[0][0]);
-		}
+		SetUniform(locMatShadow, count, m);
 	}
 
 	/**
-	* @param count `Ɏgp|CgCg̐(0`8)
-	* @param indexList `Ɏgp|CgCgԍ̔z
-	*/
-	void Program::SetPointLightIndex(int count, const int* indexList)
-	{
-		if (locPointLightCount >= 0)
-		{
-			glUniform1i(locPointLightCount, count);
-		}
-		if (locPointLightIndex >= 0 && count > 0)
-		{
-			glUniform1iv(locPointLightIndex, count, indexList);
-		}
-	}
-
-	/**
-	* `Ɏg郉Cgݒ肷
+	* `Ɏg郂fsݒ肷
 	*
-	* @param count `ɎgpX|bgCg̐(0`8)
-	* @param indexList `ɎgpX|bgCgԍ̔z
+	* @param m ݒ肷郂fs
 	*/
-	void Program::SetSpotLightIndex(int count, const int* indexList)
+	void Program::SetModelMatrix(const glm::mat4& m)
 	{
-		if (locSpotLightCount >= 0)
-		{
-			glUniform1i(locSpotLightCount, count);
-		}
-		if (locSpotLightIndex >= 0 && count > 0)
-		{
-			glUniform1iv(locSpotLightIndex, count, indexList);
-		}
+		SetUniform(locMatModel, m);
 	}
 
 	/**
@@ -386,10 +755,7 @@ namespace Shader
 	*/
 	void Program::SetCameraPostion(const glm::vec3& pos)
 	{
-		if (locCameraPosition >= 0)
-		{
-			glUniform3fv(locCameraPosition, 1, &pos.x);
-		}
+		SetUniform(locCameraPosition, pos);
 	}
 
 	/**
@@ -399,10 +765,7 @@ namespace Shader
 	*/
 	void Program::SetTime(float time)
 	{
-		if (locTime >= 0)
-		{
-			glUniform1f(locTime, time);
-		}
+		SetUniform(locTime, time);
 	}
 
 	/**
@@ -415,10 +778,7 @@ namespace Shader
 	*/
 	void Program::SetViewInfo(float w, float h, float near, float far)
 	{
-		if (locViewInfo >= 0)
-		{
-			glUniform4f(locViewInfo, 1.0f / w, 1.0f / h, near, far);
-		}
+		SetUniform(locViewInfo, glm::vec4(1.0f / w, 1.0f / h, near, far));
 	}
 
 	/**
@@ -432,10 +792,7 @@ namespace Shader
 	void Program::SetCameraInfo(float focalPlane, float focalLength,
 		float aperture, float sesorSize)
 	{
-		if (locCameraInfo >= 0)
-		{
-			glUniform4f(locCameraInfo, focalPlane, focalLength, aperture, sesorSize);
-		}
+		SetUniform(locCameraInfo, glm::vec4(focalPlane, focalLength, aperture, sesorSize));
 	}
 
 	/**
@@ -446,9 +803,171 @@ namespace Shader
 	*/
 	void Program::SetBlurDirection(float x, float y)
 	{
-		if (locBlurDirection >= 0)
+		SetUniform(locBlurDirection, glm::vec2(x, y));
+	}
+
+	/**
+	* ʎqꂽ_W𕜌邽߂̃p[^ݒ肷
+	*
+	* @param scale  _W̊g嗦(ʎqO̒_W͈̔)
+	* @param offset _W̕sړ(ʎqO̒_W̍ŏl)
+	*
+	* ʎqĂȂ_f[^̏ꍇAscale=(1,1,1), offset=(0,0,0)w肷
+	*/
+	void Program::SetPositionQuantization(const glm::vec3& scale, const glm::vec3& offset)
+	{
+		SetUniform(locPositionScale, scale);
+		SetUniform(locPositionOffset, offset);
+	}
+
+	/**
+	* uniformϐ̈ʒu擾
+	*
+	* @param name uniformϐ
+	*
+	* @return uniformϐ̈ʒu. Ȃꍇ-1
+	*
+	* x擾ʒu͖ÕnbVlL[ɂċL^A
+	* 2ڈȍ~glGetUniformLocationĂяoȂ
+	*/
+	GLint Program::GetUniformLocation(const char* name)
+	{
+		if (!id)
+		{
+			return -1;
+		}
+		const uint64_t hash = HashName(name);
+		const auto itr = locationCache.find(hash);
+		if (itr != locationCache.end())
 		{
-			glUniform2f(locBlurDirection, x, y);
+			return itr->second;
+		}
+		const GLint location = glGetUniformLocation(id, name);
+		locationCache.emplace(hash, location);
+		return location;
+	}
+
+	/**
+	* uniformϐ̒lL^ƔrAقȂꍇ͋L^XV
+	*
+	* @param location uniformϐ̈ʒu
+	* @param data     Vl
+	* @param size     Vl̃oCg
+	*
+	* @retval true  lς(OpenGL̊֐ĂяoKv)
+	* @retval false l͕ςȂA܂uniformϐ݂Ȃ
+	*/
+	bool Program::UpdateUniformCache(GLint location, const void* data, size_t size)
+	{
+		if (location < 0 || !id)
+		{
+			return false;
+		}
+		if (static_cast<size_t>(location) >= uniformValues.size())
+		{
+			uniformValues.resize(location + 1);
+		}
+		std::vector<uint8_t>& cache = uniformValues[location];
+		if (cache.size() == size && std::memcmp(cache.data(), data, size) == 0)
+		{
+			return false;
+		}
+		const uint8_t* p = static_cast<const uint8_t*>(data);
+		cache.assign(p, p + size);
+		return true;
+	}
+
+	/**
+	* uniformϐɒlݒ肷
+	*
+	* @param location uniformϐ̈ʒu
+	* @param value    ݒ肷l
+	*
+	* glProgramUniformn̊֐ĝŁAvOgpɂĂKv͂Ȃ
+	*/
+	void Program::SetUniform(GLint location, int value)
+	{
+		if (UpdateUniformCache(location, &value, sizeof(value)))
+		{
+			glProgramUniform1i(id, location, value);
+		}
+	}
+
+	void Program::SetUniform(GLint location, float value)
+	{
+		if (UpdateUniformCache(location, &value, sizeof(value)))
+		{
+			glProgramUniform1f(id, location, value);
+		}
+	}
+
+	void Program::SetUniform(GLint location, const glm::vec2& value)
+	{
+		if (UpdateUniformCache(location, &value, sizeof(value)))
+		{
+			glProgramUniform2fv(id, location, 1, &value.x);
+		}
+	}
+
+	void Program::SetUniform(GLint location, const glm::vec3& value)
+	{
+		if (UpdateUniformCache(location, &value, sizeof(value)))
+		{
+			glProgramUniform3fv(id, location, 1, &value.x);
+		}
+	}
+
+	void Program::SetUniform(GLint location, const glm::vec4& value)
+	{
+		if (UpdateUniformCache(location, &value, sizeof(value)))
+		{
+			glProgramUniform4fv(id, location, 1, &value.x);
+		}
+	}
+
+	void Program::SetUniform(GLint location, const glm::mat3& value)
+	{
+		if (UpdateUniformCache(location, &value, sizeof(value)))
+		{
+			glProgramUniformMatrix3fv(id, location, 1, GL_FALSE, &value[0][0]);
+		}
+	}
+
+	void Program::SetUniform(GLint location, const glm::mat4& value)
+	{
+		if (UpdateUniformCache(location, &value, sizeof(value)))
+		{
+			glProgramUniformMatrix4fv(id, location, 1, GL_FALSE, &value[0][0]);
+		}
+	}
+
+	/**
+	* uniformϐ̔zɒlݒ肷
+	*
+	* @param location z̐擪uniformϐ̈ʒu
+	* @param count    ݒ肷vf
+	* @param values   ݒ肷l̔z
+	*/
+	void Program::SetUniform(GLint location, int count, const int* values)
+	{
+		if (count > 0 && UpdateUniformCache(location, values, sizeof(int) * count))
+		{
+			glProgramUniform1iv(id, location, count, values);
+		}
+	}
+
+	/**
+	* uniformϐ̔zɍsݒ肷
+	*
+	* @param location uniformϐ̈ʒu
+	* @param count    ݒ肷vf
+	* @param values   ݒ肷s̔z
+	*/
+	void Program::SetUniform(GLint location, int count, const glm::mat4* values)
+	{
+		if (count > 0 && UpdateUniformCache(location, values, sizeof(glm::mat4) * count))
+		{
+			glProgramUniformMatrix4fv(id, location, count, GL_FALSE, &values[0][0][0]);
 		}
 	}
 
@@ -464,4 +983,128 @@ namespace Shader
 	{
 		return std::make_shared<Program>(BuildFromFile(vsPath, fsPath));
 	}
+
+	namespace /* unnamed */
+	{
+		/**
+		* \[XR[h#version̒Ƀ}N`}
+		*
+		* @param code    \[XR[h
+		* @param defines }}N`̕
+		*
+		* @return }N`}\[XR[h
+		*
+		* G[bZ[W̍sԍ̃t@Cƈv悤#lineōsԍ߂
+		*/
+		std::string InsertDefines(const std::string& code, const std::string& defines)
+		{
+			if (defines.empty())
+			{
+				return code;
+			}
+			size_t pos = 0;
+			int line = 1;
+			const size_t versionPos = code.find("#version");
+			if (versionPos != std::string::npos)
+			{
+				const size_t eol = code.find('\n', versionPos);
+				pos = eol == std::string::npos ? code.size() : eol + 1;
+				line += static_cast<int>(std::count(code.begin(), code.begin() + pos, '\n'));
+			}
+			std::string result;
+			result.reserve(code.size() + defines.size() + 16);
+			result.append(code, 0, pos);
+			if (pos > 0 && code[pos - 1] != '\n')
+			{
+				result += '\n';
+			}
+			result += defines;
+			result += "#line " + std::to_string(line) + "\n";
+			result.append(code, pos, std::string::npos);
+			return result;
+		}
+
+	} // unnamed namespace
+
+	/**
+	* VF[_[̔hłǗIuWFNg쐬
+	*
+	* @param vsPath      _VF[_[Et@C
+	* @param fsPath      tOgVF[_[Et@C
+	* @param baseDefines SĂ̔hłɑ}}N`
+	*
+	* @return 쐬IuWFNg
+	*
+	* \[XR[h͓ǂݍłŁArhGetŗvꂽƂɍs
+	*/
+	ProgramVariantsPtr ProgramVariants::Create(const char* vsPath, const char* fsPath,
+		std::initializer_list<Define> baseDefines)
+	{
+		ProgramVariantsPtr p = std::make_shared<ProgramVariants>();
+		p->vsPath = vsPath;
+		p->fsPath = fsPath;
+		const std::vector<GLchar> vsCode = ReadFile(vsPath);
+		const std::vector<GLchar> fsCode = ReadFile(fsPath);
+		if (!vsCode.empty())
+		{
+			p->vsCode = vsCode.data();
+		}
+		if (!fsCode.empty())
+		{
+			p->fsCode = fsCode.data();
+		}
+		p->baseDefines.assign(baseDefines.begin(), baseDefines.end());
+		return p;
+	}
+
+	/**
+	* hł擾
+	*
+	* @param defines }}N`
+	*
+	* @return definesbaseDefines}ărhh
+	*         rhɎsꍇIsNull()trueԂvOɂȂ
+	*
+	* gݍ킹̔hł쐬ς݂Ȃ炻Ԃ. }N`̏͌ʂɉeȂ
+	* rhɎsgݍ킹L^āArhȂ悤ɂ
+	*/
+	const ProgramPtr& ProgramVariants::Get(std::initializer_list<Define> defines)
+	{
+		std::vector<Define> list;
+		list.reserve(baseDefines.size() + defines.size());
+		list.insert(list.end(), baseDefines.begin(), baseDefines.end());
+		list.insert(list.end(), defines.begin(), defines.end());
+		std::sort(list.begin(), list.end(), [](const Define& a, const Define& b) {
+			return std::strcmp(a.name, b.name) < 0; });
+
+		std::string key;
+		for (const Define& e : list)
+		{
+			key += "#define ";
+			key += e.name;
+			key += ' ';
+			key += std::to_string(e.value);
+			key += '\n';
+		}
+		auto itr = variants.find(key);
+		if (itr != variants.end())
+		{
+			return itr->second;
+		}
+
+		const std::string vs = InsertDefines(vsCode, key);
+		const std::string fs = InsertDefines(fsCode, key);
+		ProgramPtr p = std::make_shared<Program>(
+			vsCode.empty() || fsCode.empty() ? 0 : Build(vs.c_str(), fs.c_str()));
+		if (p->IsNull())
+		{
+			std::cerr << "[G[]" << __func__ << ":" << vsPath << "," << fsPath <<
+				"̔hł쐬ł܂\n" << key;
+		}
+		else if (onCreate)
+		{
+			onCreate(*p);
+		}
+		return variants.emplace(key, p).first->second;
+	}
 }//namespace Shader
@@ -4,16 +4,39 @@
 #ifndef SHADER_H_INCLUDED
 #define SHADER_H_INCLUDED
 #include <GL/glew.h>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat3x3.hpp>
 #include <glm/mat4x4.hpp>
 #include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <initializer_list>
+#include <cstdint>
 
 namespace Shader
 {
 	class Program;
 	using ProgramPtr = std::shared_ptr<Program>;
+	class ProgramVariants;
+	using ProgramVariantsPtr = std::shared_ptr<ProgramVariants>;
 	GLuint Build(const GLchar* vsCode, const GLchar* fsCode);
 	GLuint BuildFromFile(const char* vspath, const char* fspath);
+	void SetUniformBlockBinding(const char* blockName, GLuint bindingPoint);
+
+	/**
+	* vOIuWFNg쐬̓v
+	*/
+	struct BuildStatistics
+	{
+		size_t programCount = 0;//쐬vOIuWFNg̐
+		size_t cacheHitCount = 0;//̂LbVǂݍ񂾐
+		double seconds = 0;//쐬ɂԂ̍v(b)
+	};
+	const BuildStatistics& GetBuildStatistics();
 
 /**
 *VF[_[vO
@@ -33,8 +56,6 @@ namespace Shader
 		void SetViewProjectionMatrix(const glm::mat4&);
 		void SetInverseViewRotationMatrix(const glm::mat4& matView);
 		void SetModelMatrix(const glm::mat4&);
-		void SetPointLightIndex(int count, const int* indexList);
-		void SetSpotLightIndex(int count, const int* indexList);
 		void SetCameraPostion(const glm::vec3&);
 		void SetTime(float);
 		void SetViewInfo(float w, float h, float near, float far);
@@ -42,21 +63,37 @@ namespace Shader
 			float aperture, float sensorSize);
 		void SetBlurDirection(float x, float y);
 		void SetShadowViewProjectionMatrix(const glm::mat4&);
+		void SetShadowViewProjectionMatrix(int count, const glm::mat4* m);
+		void SetPositionQuantization(const glm::vec3& scale, const glm::vec3& offset);
 		static const GLint shadowTextureBindingPoint = 16;
+		static const GLuint materialUniformBindingPoint = 2;//MaterialUniformBlock̃oCfBO|Cg
+
+		//Ow肵uniformϐݒ肷
+		//lݒς݂̏ꍇOpenGL̊֐ĂяoȂ
+		GLint GetUniformLocation(const char* name);
+		void SetUniform(GLint location, int value);
+		void SetUniform(GLint location, float value);
+		void SetUniform(GLint location, const glm::vec2& value);
+		void SetUniform(GLint location, const glm::vec3& value);
+		void SetUniform(GLint location, const glm::vec4& value);
+		void SetUniform(GLint location, const glm::mat3& value);
+		void SetUniform(GLint location, const glm::mat4& value);
+		void SetUniform(GLint location, int count, const int* values);
+		void SetUniform(GLint location, int count, const glm::mat4* values);
+		template<typename T>
+		void SetUniform(const char* name, const T& value) { SetUniform(GetUniformLocation(name), value); }
 
 		//vOID擾
 		GLuint Get() const { return id; }
 
 	private:
+		bool UpdateUniformCache(GLint location, const void* data, size_t size);
+
 		GLuint id = 0;//vOID
 
 		//uniformϐ̈ʒu
 		GLint locMatMVP = -1;
 		GLint locMatModel = -1;
-		GLint locPointLightCount = -1;
-		GLint locPointLightIndex = -1;
-		GLint locSpotLightCount = -1;
-		GLint locSpotLightIndex = -1;
 		GLint locCameraPosition = -1;
 		GLint locTime = -1;
 		GLint locViewInfo = -1;
@@ -64,8 +101,70 @@ namespace Shader
 		GLint locBlurDirection = -1;
 		GLint locMatShadow = -1;
 		GLint locMatInverseViewRotation = -1;
+		GLint locPositionScale = -1;
+		GLint locPositionOffset = -1;
 
 		glm::mat4 matVP = glm::mat4(1);//r[vWFNgs
+
+		std::unordered_map<uint64_t, GLint> locationCache;//ÕnbVluniformϐ̈ʒu
+		std::vector<std::vector<uint8_t>> uniformValues;//ʒuƂ́AŌɐݒ肵uniformϐ̒l
+	};
+
+	/**
+	* ʂ̃\[XR[h#define}čVF[_[̔h(p[~e[V)
+	*
+	* hł͍ŏɗvꂽƂɃrhA}N`̑gݍ킹L[ɂĕێ
+	* gȂ@\s̕ł͂ȂvvZbTŎ菜߂Ɏg
+	*/
+	class ProgramVariants
+	{
+	public:
+		/**
+		* }}N`
+		*/
+		struct Define
+		{
+			const char* name;
+			int value;
+		};
+		using CreateCallback = std::function<void(Program&)>;
+
+		static ProgramVariantsPtr Create(const char* vsPath, const char* fsPath,
+			std::initializer_list<Define> baseDefines = {});
+		ProgramVariants() = default;
+		~ProgramVariants() = default;
+		ProgramVariants(const ProgramVariants&) = delete;
+		ProgramVariants& operator=(const ProgramVariants&) = delete;
+
+		const ProgramPtr& Get(std::initializer_list<Define> defines = {});
+		void SetCreateCallback(const CreateCallback& callback) { onCreate = callback; }
+		size_t Size() const { return variants.size(); }
+
+		/**
+		* 쐬ς݂̑SĂ̔hłɑ΂Ċ֐s
+		*
+		* @param func s֐. Program&
+		*/
+		template<typename F>
+		void ForEach(F func) const
+		{
+			for (const auto& e : variants)
+			{
+				if (!e.second->IsNull())
+				{
+					func(*e.second);
+				}
+			}
+		}
+
+	private:
+		std::string vsPath;
+		std::string fsPath;
+		std::string vsCode;
+		std::string fsCode;
+		std::vector<Define> baseDefines;//SĂ̔hłɑ}}N`
+		std::unordered_map<std::string, ProgramPtr> variants;//}N`̕Ɣh
+		CreateCallback onCreate;//hł쐬ƂɌĂяo֐
 	};
 } //Shader namespace
 #endif //SHADER_H_INCLUDED
\ No newline at end of file
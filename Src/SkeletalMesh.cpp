@@ -3,7 +3,10 @@
 */
 #define NOMINMAX
 #include "SkeletalMesh.h"
-#include "UniformBuffer.h"
+#include "StreamingBuffer.h"
+#include "MeshOptimizer.h"
+#include "RenderQueue.h"
+#include "GLState.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <iostream>
@@ -21,6 +24,14 @@ namespace Mesh {
 // Implemented in Mesh.cpp
 std::vector<char> ReadFile(const char* path);
 void GetBuffer(const json11::Json& accessor, const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles, const void** pp, size_t* pLength, int* pStride = nullptr);
+bool ReadVertexStream(const json11::Json& accessor, const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles, VertexStream* stream);
+void QuantizeVertexStreams(std::vector<VertexStream>& streams, Primitive* prim);
+bool ReadIndices(const json11::Json& accessor, const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles, std::vector<GLuint>* indices);
+void CalcPrimitiveBounds(Primitive* prim, const json11::Json& accessor, const VertexStream& positions);
+void SetupMeshBounds(Mesh& mesh);
+void SetupFileBounds(const std::vector<Mesh>& meshes, Collision::AABB* aabb, Collision::Sphere* sphere);
+void SetupLodParameters(Mesh& mesh);
+void AddCullingStatistics(DrawType drawType, size_t drawn, size_t culled);
 
 /**
 * XP^bVɊւO[of[^yт̐R[hi[閼O.
@@ -40,10 +51,11 @@ struct UniformDataMeshMatrix
 };
 
 const char UniformNameForBoneMatrix[] = "MeshMatrixUniformData";
+const GLuint uboBindingPoint = 0; ///< {[s񓙂蓖ĂoCfBOE|Cg.
 
 bool isInitialized = false; ///< O[of[^Ătrue.
-int currentUboIndex = 0; ///< UBO_uobt@̏ݑCfbNX.
-UniformBufferPtr ubo[2]; ///< {[s񓙂̓]ƂȂUBO(_uobt@).
+StreamingBuffer ubo; ///< {[s񓙂̓]ƂȂUBO.
+GLintptr uboBaseOffset = -1; ///< ̃t[œ]f[^UBÖʒu.
 std::vector<uint8_t> uboData; ///< UBOɓ]f[^ꎞIɕۑ邽߂̃obt@.
 GLint uboOffsetAlignment = 0;
 
@@ -57,10 +69,11 @@ bool Initialize()
   if (!isInitialized) {
     const size_t maxMeshCount = 1024;
     const GLsizeiptr uboSize = static_cast<GLsizeiptr>(sizeof(UniformDataMeshMatrix) * maxMeshCount);
-    ubo[0] = UniformBuffer::Create(uboSize, 0, UniformNameForBoneMatrix);
-    ubo[1] = UniformBuffer::Create(uboSize, 0, UniformNameForBoneMatrix);
+    if (!ubo.Create(GL_UNIFORM_BUFFER, uboSize, UniformNameForBoneMatrix)) {
+      return false;
+    }
     uboData.reserve(uboSize);
-    currentUboIndex = 0;
+    uboBaseOffset = -1;
 
     glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboOffsetAlignment);
 
@@ -78,8 +91,8 @@ void Finalize()
   if (isInitialized) {
     uboData.clear();
     uboData.shrink_to_fit();
-    ubo[1].reset();
-    ubo[0].reset();
+    ubo.Destroy();
+    uboBaseOffset = -1;
     isInitialized = false;
   }
 }
@@ -94,7 +107,6 @@ void Finalize()
 */
 bool BindUniformBlock(const Shader::ProgramPtr& program)
 {
-  static const GLuint bindingPoint = 0;
   static const char* const blockName = UniformNameForBoneMatrix;
 
   const GLuint id = program->Get();
@@ -103,7 +115,7 @@ bool BindUniformBlock(const Shader::ProgramPtr& program)
     std::cerr << "[G[] UniformubN'" << blockName << "'܂\n";
     return false;
   }
-  glUniformBlockBinding(id, blockIndex, bindingPoint);
+  glUniformBlockBinding(id, blockIndex, uboBindingPoint);
   const GLenum result = glGetError();
   if (result != GL_NO_ERROR) {
     std::cerr << "[G[] UniformubN'" << blockName << "'̃oChɎs\n";
@@ -141,8 +153,7 @@ GLintptr PushUniformData(const void* data, size_t size)
 
   const size_t alignedSize = ((size + uboOffsetAlignment - 1) / uboOffsetAlignment) * uboOffsetAlignment;
 
-  UniformBufferPtr pUbo = ubo[currentUboIndex];
-  if (uboData.size() + alignedSize >= static_cast<size_t>(pUbo->Size())) {
+  if (uboData.size() + alignedSize >= static_cast<size_t>(ubo.FrameSize())) {
     return -1;
   }
   const uint8_t* p = static_cast<const uint8_t*>(data);
@@ -164,9 +175,8 @@ void UploadUniformData()
   }
 
   if (!uboData.empty()) {
-    UniformBufferPtr pUbo = ubo[currentUboIndex];
-    pUbo->BufferSubData(uboData.data(), 0, uboData.size());
-    currentUboIndex = !currentUboIndex;
+    // GPUǂݍݒ̗̈͏㏑Ȃ̂ŁAÕt[̕`҂ɓ]ł.
+    uboBaseOffset = ubo.Push(uboData.data(), uboData.size(), uboOffsetAlignment);
   }
 }
 
@@ -182,7 +192,10 @@ void BindUniformData(GLintptr offset, GLsizeiptr size)
     return;
   }
 
-  ubo[!currentUboIndex]->BindBufferRange(offset, size);
+  if (uboBaseOffset < 0) {
+    return;
+  }
+  GLState::BindUniformBuffer(uboBindingPoint, ubo.Id(), uboBaseOffset + offset, size);
 }
 
 } // namespace SkeletalAnimation
@@ -422,6 +435,11 @@ void SkeletalMesh::Update(float deltaTime, const glm::mat4& matModel, const glm:
     }
   }
 
+  // ʏ̑傫ڍדxI.
+  if (file && node && node->mesh >= 0 && node->mesh < static_cast<int>(file->meshes.size())) {
+    lod = SelectLod(file->meshes[node->mesh], matModel, lod);
+  }
+
   // eBufferUBOf[^ǉ.
   SkeletalAnimation::UniformDataMeshMatrix uboData;
   uboData.color = color;
@@ -442,6 +460,14 @@ void SkeletalMesh::Update(float deltaTime, const glm::mat4& matModel, const glm:
   uboSize = ((uboSize + 255) / 256) * 256;
   uboOffset = SkeletalAnimation::PushUniformData(&uboData, uboSize);
 
+  // JOp̋EXV.
+  // E̓oCh|[YŌvZĂ̂ŁAAj[VŒ_aLĂ.
+  if (file && node && node->mesh >= 0 && node->mesh < static_cast<int>(file->meshes.size())) {
+    const glm::mat4 m = mt.matRoot.empty() ? matModel : matModel * mt.matRoot[0];
+    worldSphere = Collision::TransformSphere(file->meshes[node->mesh].sphere, m);
+    worldSphere.r *= 1.5f;
+  }
+
   // ԂXV.
   if (animation) {
     switch (state) {
@@ -459,9 +485,11 @@ void SkeletalMesh::Update(float deltaTime, const glm::mat4& matModel, const glm:
 }
 
 /**
-* XP^bV`悷.
+* XP^bV̕`v.
+*
+* @param queue `vǉ`L[.
 */
-void SkeletalMesh::Draw(DrawType drawType) const
+void SkeletalMesh::Draw(RenderQueue& queue) const
 {
   if (!file) {
     return;
@@ -472,50 +500,30 @@ void SkeletalMesh::Draw(DrawType drawType) const
   //meshNodes.reserve(32);
   //GetMeshNodeList(node, meshNodes);
 
-  SkeletalAnimation::BindUniformData(uboOffset, uboSize);
-
+  file->usage.Touch();
   const Mesh& meshData = file->meshes[node->mesh];
-  GLuint prevTexId = 0;
+  const DrawType drawType = queue.GetDrawType();
+
+  // ̊Oɂ邩AՕɉBĂΕ`悵Ȃ.
+  if (meshData.sphere.r > 0 && (!IsVisible(worldSphere) || IsOccluded(worldSphere))) {
+    AddCullingStatistics(drawType, 0, meshData.primitives.size());
+    return;
+  }
+
+  DrawItem item;
+  item.lod = lod;
+  item.uboOffset = uboOffset;
+  item.uboSize = uboSize;
   for (const auto& prim : meshData.primitives) {
-    prim.vao->Bind();
-
-    if (prim.material >= 0 && prim.material < static_cast<int>(file->materials.size())) {
-      const Material& m = file->materials[prim.material];
-	  Shader::ProgramPtr program = m.progSkeletalMesh;
-	  if (drawType == DrawType::shadow)
-	  {
-		  program = m.progShadow;
-	  }
-      if (!program)
-	  {
-        continue;
-      }
-	  program->Use();
-
-	  for (int i = 0; i < sizeof(m.texture) / sizeof(m.texture[0]); i++)
-	  {
-		  glActiveTexture(GL_TEXTURE0 + i);
-		  if (m.texture[i])
-		  {
-			  glBindTexture(GL_TEXTURE_2D, m.texture[i]->Get());
-		  }
-		  else
-		  {
-			  glBindTexture(GL_TEXTURE_2D, 0);
-		  }
-	  }
-      const GLint locMaterialColor = glGetUniformLocation(m.progSkeletalMesh->Get(), "materialColor");
-      if (locMaterialColor >= 0) {
-        glUniform4fv(locMaterialColor, 1, &m.baseColor.x);
-      }
-      glDrawElementsBaseVertex(prim.mode, prim.count, prim.type, prim.indices, prim.baseVertex);
+    if (prim.material < 0 || prim.material >= static_cast<int>(file->materials.size())) {
+      continue;
     }
+    const Material& m = file->materials[prim.material];
+    item.primitive = &prim;
+    item.material = &m;
+    item.program = (drawType == DrawType::shadow ? m.progShadow : m.progSkeletalMesh).get();
+    queue.Add(item, worldSphere.center);
   }
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glUseProgram(0);
-  glBindVertexArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 /**
@@ -846,13 +854,18 @@ glm::mat4 CalcLocalMatrix(const json11::Json& node)
 /**
 * glTFt@Cǂݍ.
 *
-* @param path glTFt@C.
+* @param path   glTFt@C.
+* @param option ǂݍ݃IvV.
 *
 * @retval true  ǂݍݐ.
 * @retval false ǂݍݎs.
 */
-bool Buffer::LoadSkeletalMesh(const char* path)
+bool Buffer::LoadSkeletalMesh(const char* path, const ImportOption& option)
 {
+  if (extendedFiles.find(path) != extendedFiles.end()) {
+    return true;
+  }
+
   // gltft@Cǂݍ.
   std::vector<char> gltfFile = ReadFile(path);
   if (gltfFile.empty()) {
@@ -892,6 +905,10 @@ bool Buffer::LoadSkeletalMesh(const char* path)
   const json11::Json& bufferViews = json["bufferViews"];
 
   // CfbNXf[^ƒ_f[^̃ANZbTID擾.
+  // ޔɉł悤ɁAmۂ̈t@CɋL^.
+  vboRangeLog = &file.vboRanges;
+  iboRangeLog = &file.iboRanges;
+  isOutOfSpace = false;
   file.meshes.reserve(json["meshes"].array_items().size());
   for (const auto& currentMesh : json["meshes"].array_items()) {
     Mesh mesh;
@@ -902,25 +919,22 @@ bool Buffer::LoadSkeletalMesh(const char* path)
       const json11::Json& primitive = currentMesh["primitives"][primId];
 
       // _CfbNX.
+      std::vector<GLuint> indices;
       {
         const int accessorId_index = primitive["indices"].int_value();
         const json11::Json& accessor = accessors[accessorId_index];
         if (accessor["type"].string_value() != "SCALAR") {
           std::cerr << "ERROR: CfbNXf[^E^CvSCALARłȂĂ͂Ȃ܂ \n";
           std::cerr << "  type = " << accessor["type"].string_value() << "\n";
+          vboRangeLog = nullptr;
+          iboRangeLog = nullptr;
+          FreeRanges(file.vboRanges, file.iboRanges);
           return false;
         }
 
+        ReadIndices(accessor, bufferViews, binFiles, &indices);
         mesh.primitives[primId].mode = primitive["mode"].is_null() ? GL_TRIANGLES : primitive["mode"].int_value();
-        mesh.primitives[primId].count = accessor["count"].int_value();
         mesh.primitives[primId].type = accessor["componentType"].int_value();
-        mesh.primitives[primId].indices = reinterpret_cast<const GLvoid*>(iboEnd);
-
-        const void* p;
-        size_t byteLength;
-        GetBuffer(accessor, bufferViews, binFiles, &p, &byteLength);
-        ibo.BufferSubData(iboEnd, byteLength, p);
-        iboEnd += ((byteLength + 3) / 4) * 4; // ɗ̂ǂ̃f[^^łvȂ悤4oCgEɐ.
       }
 
       // _.
@@ -933,16 +947,46 @@ bool Buffer::LoadSkeletalMesh(const char* path)
 
       mesh.primitives[primId].vao = std::make_shared<VertexArrayObject>();
       mesh.primitives[primId].vao->Create(vbo.Id(), ibo.Id());
-      SetAttribute(&mesh.primitives[primId], 0, accessors[accessorId_position], bufferViews, binFiles);
-      SetAttribute(&mesh.primitives[primId], 1, accessors[accessorId_texcoord], bufferViews, binFiles);
-      SetAttribute(&mesh.primitives[primId], 2, accessors[accessorId_normal], bufferViews, binFiles);
-      SetAttribute(&mesh.primitives[primId], 3, accessors[accessorId_weights], bufferViews, binFiles);
-      SetAttribute(&mesh.primitives[primId], 4, accessors[accessorId_joints], bufferViews, binFiles);
+      std::vector<VertexStream> streams(5);
+      ReadVertexStream(accessors[accessorId_position], bufferViews, binFiles, &streams[0]);
+      ReadVertexStream(accessors[accessorId_texcoord], bufferViews, binFiles, &streams[1]);
+      ReadVertexStream(accessors[accessorId_normal], bufferViews, binFiles, &streams[2]);
+      ReadVertexStream(accessors[accessorId_weights], bufferViews, binFiles, &streams[3]);
+      ReadVertexStream(accessors[accessorId_joints], bufferViews, binFiles, &streams[4]);
+      if (option.optimize && mesh.primitives[primId].mode == GL_TRIANGLES) {
+        MeshOptimizer::Optimize(indices, streams, mesh.name);
+      }
+      CalcPrimitiveBounds(&mesh.primitives[primId], accessors[accessorId_position], streams[0]);
+      AddLods(&mesh.primitives[primId], indices, streams[0], option);
+      if (option.quantize) {
+        QuantizeVertexStreams(streams, &mesh.primitives[primId]);
+      }
+      for (size_t i = 0; i < streams.size(); ++i) {
+        SetVertexStream(&mesh.primitives[primId], static_cast<GLuint>(i), streams[i]);
+      }
+
+      // ɗ̂ǂ̃f[^^łvȂ悤4oCgEɐ񂵂ē].
+      mesh.primitives[primId].count = static_cast<GLsizei>(indices.size());
+      mesh.primitives[primId].indices = reinterpret_cast<const GLvoid*>(AddIndexData(indices, mesh.primitives[primId].type));
 
       mesh.primitives[primId].material = primitive["material"].int_value();
+
+      // obt@tȂA܂łɊmۂ̈ēǂݍ݂𒆎~.
+      if (isOutOfSpace) {
+        std::cerr << "[G[]" << __func__ << ": " << path << "i[󂫗̈悪܂.\n";
+        vboRangeLog = nullptr;
+        iboRangeLog = nullptr;
+        FreeRanges(file.vboRanges, file.iboRanges);
+        return false;
+      }
     }
+    SetupMeshBounds(mesh);
+    SetupLodParameters(mesh);
     file.meshes.push_back(mesh);
   }
+  vboRangeLog = nullptr;
+  iboRangeLog = nullptr;
+  SetupFileBounds(file.meshes, &file.aabb, &file.sphere);
 
   // }eA.
   {
@@ -973,7 +1017,7 @@ bool Buffer::LoadSkeletalMesh(const char* path)
         tex = Texture::Image2D::Create(texturePath.c_str());
       }
 	  Material m = CreateMaterial(col, tex);
-	  m.progShadow = GetSkeletalShadowShader();
+	  m.progShadow = shadowShaders->Get({ { "SKINNED", 1 } });
       file.materials.push_back(m);
     }
   }
@@ -1148,6 +1192,7 @@ bool Buffer::LoadSkeletalMesh(const char* path)
 
   file.name = path;
   extendedFiles.insert(std::make_pair(file.name, pFile));
+  bool isReload = false;
   for (size_t i = 0; i < file.nodes.size(); ++i) {
     const int meshIndex = file.nodes[i].mesh;
     if (meshIndex < 0) {
@@ -1155,6 +1200,16 @@ bool Buffer::LoadSkeletalMesh(const char* path)
     }
     const Mesh& mesh = file.meshes[meshIndex];
     meshes.insert(std::make_pair(mesh.name, MeshIndex{ pFile, &pFile->nodes[i] }));
+    if (evictedSkeletalMeshes.erase(mesh.name) > 0) {
+      isReload = true;
+    }
+  }
+  importOptions[file.name] = option;
+  RegisterResidency(pFile);
+
+  // ޔt@C̓ǂݍݒ͕pɂɋN̂ŕ\Ȃ.
+  if (isReload) {
+    return true;
   }
 
   std::cout << "[INFO]" << __func__ << ": '" << path << "'ǂݍ݂܂.\n";
@@ -1179,9 +1234,20 @@ bool Buffer::LoadSkeletalMesh(const char* path)
 *
 * @return meshNameƓOXP^bV.
 */
-SkeletalMeshPtr Buffer::GetSkeletalMesh(const char* meshName) const
+SkeletalMeshPtr Buffer::GetSkeletalMesh(const char* meshName)
 {
-  const auto itr = meshes.find(meshName);
+  auto itr = meshes.find(meshName);
+  if (itr == meshes.end()) {
+    // 풓ǗɂđޔĂǂݍݒ.
+    const auto evicted = evictedSkeletalMeshes.find(meshName);
+    if (evicted != evictedSkeletalMeshes.end()) {
+      const std::string path = evicted->second;
+      Residency::Manager::Instance().CountReload();
+      if (LoadSkeletalMesh(path.c_str(), importOptions[path])) {
+        itr = meshes.find(meshName);
+      }
+    }
+  }
   if (itr == meshes.end()) {
     static SkeletalMeshPtr dummy(std::make_shared<SkeletalMesh>());
     return dummy;
@@ -1192,4 +1258,79 @@ SkeletalMeshPtr Buffer::GetSkeletalMesh(const char* meshName) const
   return std::make_shared<SkeletalMesh>(pFile, pNode);
 }
 
+/**
+* XP^bṼt@C풓Ǘɓo^.
+*
+* @param file o^t@C.
+*
+* t@CQƂȂȂA\Z𒴂Ƃɑޔ悤ɂȂ.
+* ޔt@CGetSkeletalMeshŗvꂽƂɓǂݍݒ.
+*/
+void Buffer::RegisterResidency(const ExtendedFilePtr& file)
+{
+  size_t cpuBytes = sizeof(ExtendedFile) + file->materials.size() * sizeof(Material) +
+    file->nodes.size() * sizeof(Node);
+  for (const Mesh& mesh : file->meshes) {
+    cpuBytes += sizeof(Mesh) + mesh.primitives.size() * (sizeof(Primitive) + sizeof(VertexArrayObject));
+  }
+  for (const Skin& skin : file->skins) {
+    cpuBytes += sizeof(Skin) + skin.joints.size() * sizeof(int);
+  }
+  for (const Animation& anime : file->animations) {
+    cpuBytes += sizeof(Animation);
+    for (const auto& e : anime.translationList) {
+      cpuBytes += sizeof(e) + e.timeline.size() * sizeof(KeyFrame<glm::vec3>);
+    }
+    for (const auto& e : anime.rotationList) {
+      cpuBytes += sizeof(e) + e.timeline.size() * sizeof(KeyFrame<glm::quat>);
+    }
+    for (const auto& e : anime.scaleList) {
+      cpuBytes += sizeof(e) + e.timeline.size() * sizeof(KeyFrame<glm::vec3>);
+    }
+  }
+  size_t gpuBytes = 0;
+  for (const BufferRange& e : file->vboRanges) {
+    gpuBytes += e.size;
+  }
+  for (const BufferRange& e : file->iboRanges) {
+    gpuBytes += e.size;
+  }
+
+  const std::string name = file->name;
+  const int id = Residency::Manager::Instance().Register(
+    Residency::Type::skeletalMesh, name, cpuBytes, gpuBytes, &file->usage,
+    [this, name]() {
+      const auto itr = extendedFiles.find(name);
+      if (itr == extendedFiles.end()) {
+        return false;
+      }
+      // extendedFilesmeshesQƂāA܂QƂcĂ邩ׂ.
+      long internalCount = 1;
+      for (const auto& e : meshes) {
+        if (e.second.file == itr->second) {
+          ++internalCount;
+        }
+      }
+      return itr->second.use_count() > internalCount;
+    },
+    [this, name]() {
+      const auto itr = extendedFiles.find(name);
+      if (itr == extendedFiles.end()) {
+        return;
+      }
+      const ExtendedFilePtr p = itr->second;
+      for (auto i = meshes.begin(); i != meshes.end();) {
+        if (i->second.file == p) {
+          evictedSkeletalMeshes[i->first] = name;
+          i = meshes.erase(i);
+        } else {
+          ++i;
+        }
+      }
+      FreeRanges(p->vboRanges, p->iboRanges);
+      extendedFiles.erase(itr);
+    });
+  residencyIds.push_back(id);
+}
+
 } // namespace Mesh
\ No newline at end of file
@@ -7,6 +7,8 @@
 
 namespace Mesh {
 
+class RenderQueue;
+
 // XLf[^.
 struct Skin {
   std::string name;
@@ -63,6 +65,15 @@ struct ExtendedFile {
   std::vector<Node> nodes;
   std::vector<Skin> skins;
   std::vector<Animation> animations;
+
+  // SbV͂ދE{[(oCh|[YAIuWFNgWn).
+  Collision::AABB aabb;
+  Collision::Sphere sphere;
+
+  // 풓Ǘp̏.
+  std::vector<BufferRange> vboRanges; // gpĂVBÖ̗.
+  std::vector<BufferRange> iboRanges; // gpĂIBÖ̗.
+  Residency::Usage usage; // Ōɕ`悳ꂽt[.
 };
 using ExtendedFilePtr = std::shared_ptr<ExtendedFile>;
 
@@ -84,7 +95,7 @@ public:
   SkeletalMesh(const ExtendedFilePtr& f, const Node* n);
 
   void Update(float deltaTime, const glm::mat4& matModel, const glm::vec4& color);
-  void Draw(DrawType drawType) const;
+  void Draw(RenderQueue& queue) const;
   const std::vector<Animation>& GetAnimationList() const;
   const std::string& GetAnimation() const;
   float GetTotalAnimationTime() const;
@@ -113,6 +124,9 @@ private:
 
   GLintptr uboOffset = 0;
   GLsizeiptr uboSize = 0;
+
+  int lod = 0; // `悷ڍדx(LOD).
+  Collision::Sphere worldSphere; // JOp̋E([hWn).
 };
 using SkeletalMeshPtr = std::shared_ptr<SkeletalMesh>;
 
@@ -141,6 +155,7 @@ void Finalize();
 bool BindUniformBlock(const Shader::ProgramPtr&);
 void ResetUniformData();
 void UploadUniformData();
+void BindUniformData(GLintptr offset, GLsizeiptr size);
 
 } // namespace SkeletalAnimation
 
@@ -44,12 +44,12 @@ void SkeletalMeshActor::UpdateDrawData(float deltaTime)
 /**
 * `.
 *
-* @param drawType `悷f[^̎
+* @param queue `vǉ`L[.
 */
-void SkeletalMeshActor::Draw(Mesh::DrawType drawType)
+void SkeletalMeshActor::Draw(Mesh::RenderQueue& queue)
 {
   if (mesh)
   {
-    mesh->Draw(drawType);
+    mesh->Draw(queue);
   }
 }
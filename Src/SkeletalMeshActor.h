@@ -17,7 +17,7 @@ public:
   virtual ~SkeletalMeshActor() = default;
 
   virtual void UpdateDrawData(float) override;
-  virtual void Draw(Mesh::DrawType drawType) override;
+  virtual void Draw(Mesh::RenderQueue& queue) override;
 
   const Mesh::SkeletalMeshPtr& GetMesh() const { return mesh; }
 
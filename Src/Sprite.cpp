@@ -2,6 +2,8 @@
 * @file Sprite.cpp
 */
 #include "Sprite.h"
+#include "GLState.h"
+#include "RenderStats.h"
 #include <vector>
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
@@ -41,8 +43,7 @@ void Sprite::Texture(const Texture::Image2DPtr& tex)
 */
 bool SpriteRenderer::Init(size_t maxSpriteCount, const char* vsPath, const char* fsPath)
 {
-	vbo.Create(GL_ARRAY_BUFFER, sizeof(Vertex) * maxSpriteCount * 4, nullptr,
-		GL_STREAM_DRAW);
+	vbo.Create(GL_ARRAY_BUFFER, sizeof(Vertex) * maxSpriteCount * 4, "SpriteRenderer");
 
 	//lp`maxSpriteCount
 	std::vector<GLshort> indices;
@@ -90,7 +91,7 @@ bool SpriteRenderer::Init(size_t maxSpriteCount, const char* vsPath, const char*
 	{
 		primitives.clear();
 		vertices.clear();
-		vertices.reserve(vbo.Size() / sizeof(Vertex));
+		vertices.reserve(vbo.FrameSize() / sizeof(Vertex));
 	}
 
 	/**
@@ -103,7 +104,7 @@ bool SpriteRenderer::Init(size_t maxSpriteCount, const char* vsPath, const char*
 	*/
 	bool SpriteRenderer::AddVertices(const Sprite& sprite)
 	{
-		if (vertices.size() * sizeof(Vertex) >= static_cast<size_t>(vbo.Size()))
+		if (vertices.size() * sizeof(Vertex) >= static_cast<size_t>(vbo.FrameSize()))
 		{
 			std::cerr << "[x]" << __func__ << ":ő\𒴂Ă܂B\n";
 			return false;
@@ -174,7 +175,20 @@ bool SpriteRenderer::Init(size_t maxSpriteCount, const char* vsPath, const char*
 	*/
 	void SpriteRenderer::EndUpdate()
 	{
-		vbo.BufferSubData(0, vertices.size() * sizeof(Vertex), vertices.data());
+		if (!vertices.empty())
+		{
+			//_Pʂŕ`ʒuwł悤ɁA_̃TCYŐ񂳂
+			const GLintptr offset =
+				vbo.Push(vertices.data(), vertices.size() * sizeof(Vertex), sizeof(Vertex));
+			if (offset >= 0)
+			{
+				baseVertex = static_cast<GLint>(offset / sizeof(Vertex));
+			}
+			else
+			{
+				primitives.clear();
+			}
+		}
 		vertices.clear();
 		vertices.shrink_to_fit();
 	}
@@ -187,9 +201,9 @@ bool SpriteRenderer::Init(size_t maxSpriteCount, const char* vsPath, const char*
 	*/
 	void SpriteRenderer::Draw(const glm::vec2& screenSize) const
 	{
-		glDisable(GL_DEPTH_TEST);
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		GLState::Disable(GL_DEPTH_TEST);
+		GLState::Enable(GL_BLEND);
+		GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 		vao.Bind();
 		program->Use();
@@ -205,8 +219,10 @@ bool SpriteRenderer::Init(size_t maxSpriteCount, const char* vsPath, const char*
 		for (const Primitive& primitive : primitives)
 		{
 			program->BindTexture(0, primitive.texture->Get());
-			glDrawElements(GL_TRIANGLES, primitive.count, GL_UNSIGNED_SHORT,
-				reinterpret_cast<const GLvoid*>(primitive.offset));
+			glDrawElementsBaseVertex(GL_TRIANGLES, primitive.count, GL_UNSIGNED_SHORT,
+				reinterpret_cast<const GLvoid*>(primitive.offset), baseVertex);
+			RenderStats::AddDrawCall();
+			RenderStats::AddPrimitives(GL_TRIANGLES, primitive.count);
 		}
 		program->BindTexture(0, 0);
 		vao.Unbind();
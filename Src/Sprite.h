@@ -4,6 +4,7 @@
 #ifndef SPRITE_H_INCLUDED
 #define SPRITE_H_INCLUDED
 #include "BufferObject.h"
+#include "StreamingBuffer.h"
 #include "Texture.h"
 #include "Shader.h"
 #include <glm/glm.hpp>
@@ -82,10 +83,11 @@ public:
 	void Clear();
 
 private:
-	BufferObject vbo;
+	StreamingBuffer vbo;
 	BufferObject ibo;
 	VertexArrayObject vao;
 	Shader::ProgramPtr program;
+	GLint baseVertex = 0;//̃t[̒_f[^́AVBÖʒu(_P)
 
 	struct Vertex
 	{
@@ -0,0 +1,170 @@
+/**
+* @file StreamingBuffer.cpp
+*/
+#include "StreamingBuffer.h"
+#include "GLState.h"
+#include "RenderStats.h"
+#include <iostream>
+#include <cstring>
+
+namespace /* unnamed */
+{
+	const GLsizeiptr frameAlignment = 256;//̋E̐TCY(UBÕItZbg̍ől)
+	const GLuint64 fenceTimeout = 1'000'000'000;//tFX̑҂Ԃ̏(imb)
+
+	uint64_t frameNumber = 0;//݂̃t[̔ԍ
+	GLsync fences[StreamingBuffer::frameCount] = {};//悲Ƃ̕`抮tFX
+
+} // unnamed namespace
+
+/**
+* obt@쐬
+*
+* @param target    obt@̎
+* @param frameSize 1t[ŏލőoCg
+* @param name      obt@(G[\p)
+*
+* @retval true  쐬
+* @retval false 쐬s
+*/
+bool StreamingBuffer::Create(GLenum target, GLsizeiptr frameSize, const char* name)
+{
+	Destroy();
+	this->target = target;
+	this->frameSize = ((frameSize + frameAlignment - 1) / frameAlignment) * frameAlignment;
+	this->name = name;
+	frame = UINT64_MAX;
+	head = 0;
+
+	//ȑȌŔG[쐬sƎႦȂ悤ɁAɎ菜Ă
+	while (glGetError() != GL_NO_ERROR)
+	{
+	}
+
+	const GLsizeiptr totalSize = this->frameSize * frameCount;
+	glGenBuffers(1, &id);
+	glBindBuffer(target, id);
+	if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(target, totalSize, nullptr, flags);
+		mappedPointer = static_cast<uint8_t*>(glMapBufferRange(target, 0, totalSize, flags));
+	}
+	else
+	{
+		glBufferData(target, totalSize, nullptr, GL_STREAM_DRAW);
+	}
+	glBindBuffer(target, 0);
+	const GLenum error = glGetError();
+	if (error != GL_NO_ERROR)
+	{
+		std::cerr << "[G[]" << __func__ << ":" << name << "̍쐬Ɏs(" <<
+			std::hex << error << std::dec << ")\n";
+		Destroy();
+		return false;
+	}
+	return true;
+}
+
+/**
+* obt@j
+*/
+void StreamingBuffer::Destroy()
+{
+	if (id)
+	{
+		if (mappedPointer)
+		{
+			glBindBuffer(target, id);
+			glUnmapBuffer(target);
+			glBindBuffer(target, 0);
+			mappedPointer = nullptr;
+		}
+		GLState::DeleteBuffer(id);
+		id = 0;
+	}
+	frameSize = 0;
+}
+
+/**
+* ݂̃t[̋Ƀf[^
+*
+* @param data      ރf[^̃AhX
+* @param size      ރoCg
+* @param alignment ݈ʒu̐TCY(2ׂ̂łȂĂ悢)
+*
+* @return f[^񂾈ʒu(obt@擪̃oCgItZbg). ߂Ȃꍇ-1
+*/
+GLintptr StreamingBuffer::Push(const void* data, GLsizeiptr size, GLsizeiptr alignment)
+{
+	if (!id || size <= 0 || alignment <= 0)
+	{
+		return -1;
+	}
+	if (frame != frameNumber)
+	{
+		frame = frameNumber;
+		head = 0;
+	}
+	const GLintptr base = static_cast<GLintptr>(frameNumber % frameCount) * frameSize;
+	const GLintptr offset = ((base + head + alignment - 1) / alignment) * alignment;
+	if (offset + size > base + frameSize)
+	{
+		std::cerr << "[G[]" << __func__ << ":" << name << "1t[̗eʂ𒴂Ă܂(" <<
+			"gpς=" << head << " ǉ=" << size << " e=" << frameSize << ")\n";
+		return -1;
+	}
+	if (mappedPointer)
+	{
+		std::memcpy(mappedPointer + offset, data, size);
+	}
+	else
+	{
+		glBindBuffer(target, id);
+		glBufferSubData(target, offset, size, data);
+		glBindBuffer(target, 0);
+	}
+	RenderStats::AddUpload(size);
+	head = offset + size - base;
+	return offset;
+}
+
+/**
+* t[̎n߂ɌĂяoāAg悪gp\ɂȂ܂ő҂
+*/
+void StreamingBuffer::BeginFrame()
+{
+	GLsync& fence = fences[frameNumber % frameCount];
+	if (!fence)
+	{
+		return;
+	}
+	for (;;)
+	{
+		const GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeout);
+		if (result != GL_TIMEOUT_EXPIRED)
+		{
+			if (result == GL_WAIT_FAILED)
+			{
+				std::cerr << "[G[]" << __func__ << ":tFX̑ҋ@Ɏs\n";
+			}
+			break;
+		}
+	}
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+/**
+* t[̏IɌĂяoāAgɃtFXݒ肷
+*/
+void StreamingBuffer::EndFrame()
+{
+	GLsync& fence = fences[frameNumber % frameCount];
+	if (fence)
+	{
+		glDeleteSync(fence);
+	}
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	++frameNumber;
+}
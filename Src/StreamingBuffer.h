@@ -0,0 +1,51 @@
+/**
+* @file StreamingBuffer.h
+*/
+#ifndef STREAMINGBUFFER_H_INCLUDED
+#define STREAMINGBUFFER_H_INCLUDED
+#include <GL/glew.h>
+#include <string>
+#include <cstdint>
+
+/**
+* t[f[^p̃obt@
+*
+* obt@frameCount̋ɕAt[ƂɏԂɎg
+* ėpOɁA̋gt[̕`抮tFXő҂̂ŁA
+* GPUǂݍłŒ̃f[^㏑邱Ƃ͂Ȃ
+* glBufferStoragegꍇ͉iIɃ}bvĒڏ݁A
+* gȂꍇglBufferSubDataŏ
+*
+* t[̎n߂BeginFrameAIEndFrameĂяo
+*/
+class StreamingBuffer
+{
+public:
+	static const int frameCount = 3;//̐
+
+	StreamingBuffer() = default;
+	~StreamingBuffer() { Destroy(); }
+	StreamingBuffer(const StreamingBuffer&) = delete;
+	StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+	bool Create(GLenum target, GLsizeiptr frameSize, const char* name);
+	void Destroy();
+	GLintptr Push(const void* data, GLsizeiptr size, GLsizeiptr alignment = 4);
+	GLuint Id() const { return id; }
+	GLsizeiptr FrameSize() const { return frameSize; }
+	bool IsPersistent() const { return mappedPointer != nullptr; }
+
+	static void BeginFrame();
+	static void EndFrame();
+
+private:
+	GLenum target = 0;//obt@̎
+	GLuint id = 0;//ǗID
+	GLsizeiptr frameSize = 0;//1̃oCgTCY
+	uint8_t* mappedPointer = nullptr;//iIɃ}bvAhX
+	uint64_t frame = UINT64_MAX;//Ōɏ񂾃t[̔ԍ
+	GLintptr head = 0;//݂̋̎gpς݃oCg
+	std::string name;//obt@(G[\p)
+};
+
+#endif // STREAMINGBUFFER_H_INCLUDED
@@ -3,12 +3,45 @@
 */
 #include "Terrain.h"
 #include "Texture.h"
+#include "MeshOptimizer.h"
 #include <iostream>
 #include <algorithm>
+#include <cstring>
+#include <limits>
 
 //n`ɊւNXi[閼O
 namespace Terrain
 {
+	namespace /* unnamed */
+	{
+		/**
+		* iq̒_f[^ƃCfbNXf[^œK
+		*
+		* @param vertices _f[^
+		* @param indices  CfbNXf[^
+		* @param name     bV
+		*
+		* Mesh::Vertexz1̒_f[^ƂĈAʒu擪3vfǂݎ
+		*/
+		void OptimizeGrid(std::vector<Mesh::Vertex>& vertices,
+			std::vector<GLuint>& indices, const char* name)
+		{
+			std::vector<Mesh::VertexStream> streams(1);
+			streams[0].size = 3;
+			streams[0].type = GL_FLOAT;
+			streams[0].stride = sizeof(Mesh::Vertex);
+			streams[0].data.resize(vertices.size() * sizeof(Mesh::Vertex));
+			std::memcpy(streams[0].data.data(), vertices.data(), streams[0].data.size());
+			if (!MeshOptimizer::Optimize(indices, streams, name))
+			{
+				return;
+			}
+			vertices.resize(streams[0].Count());
+			std::memcpy(vertices.data(), streams[0].data.data(), streams[0].data.size());
+		}
+
+	} // unnamed namespace
+
 	/**
 	* 摜t@Cn`f[^ǂݍ
 	*
@@ -47,15 +80,6 @@ namespace Terrain
 				heights[offsetY * size.x + x] = (color.r - baseLevel) * scale;
 			}
 		}
-		for (int i = 0; i < 2; i++)
-		{
-			lightIndex[i] = Texture::Buffer::Create(
-				GL_RGBA8I, size.x *size.y * 4,nullptr, GL_DYNAMIC_DRAW);
-			if (!lightIndex[i])
-			{
-				return false;
-			}
-		}
 		return true;
 	}
 
@@ -151,8 +175,6 @@ namespace Terrain
 				vertices.push_back(v);
 			}
 		}
-		const size_t vOffset =
-			meshBuffer.AddVertexData(vertices.data(), vertices.size() * sizeof(Mesh::Vertex));
 
 		//CfbNXf[^쐬
 		std::vector<GLuint> indices;
@@ -174,25 +196,35 @@ namespace Terrain
 				indices.push_back(a);
 			}
 		}
-		const size_t iOffset =
+
+		//_LbV悤ɕבւĂ]
+		OptimizeGrid(vertices, indices, meshName);
+		const GLintptr vOffset =
+			meshBuffer.AddVertexData(vertices.data(), vertices.size() * sizeof(Mesh::Vertex));
+		const GLintptr iOffset =
 			meshBuffer.AddIndexData(indices.data(), indices.size() * sizeof(GLuint));
+		if (vOffset < 0 || iOffset < 0)
+		{
+			return false;
+		}
 
 		//_f[^ƃCfbNXf[^烁bV쐬
 		Mesh::Primitive p =
 			meshBuffer.CreatePrimitive(indices.size(), GL_UNSIGNED_INT, iOffset, vOffset);
+		Mesh::CalcBounds(vertices.data(), vertices.size(), &p);
 		Mesh::Material m = meshBuffer.CreateMaterial(glm::vec4(1), nullptr);
 
 		m.texture[0] = Texture::Image2D::Create("Res/Terrain_Ratio.tga");
 		m.texture[1] = Texture::Image2D::Create("Res/Terrain_Soil.tga");
 		m.texture[2] = Texture::Image2D::Create("Res/Terrain_Rock.tga");
 		m.texture[3] = Texture::Image2D::Create("Res/Terrain_Plant.tga");
-		m.texture[4] = lightIndex[0];
-		m.texture[5] = lightIndex[1];
 		m.texture[8] = Texture::Image2D::Create("Res/Terrain_Soil_Normal.tga");
 		m.texture[9] = Texture::Image2D::Create("Res/Terrain_Rock_Normal.tga");
 		m.texture[10] = Texture::Image2D::Create("Res/Terrain_Plant_Normal.tga");
 		m.program = meshBuffer.GetTerrainShader();
-		m.progShadow = meshBuffer.GetNonTexturedShadowShader();
+		m.progShadow = meshBuffer.GetShadowShaders()->Get({ { "NON_TEXTURED", 1 } });
+		m.progInstanced = nullptr;
+		m.progShadowInstanced = nullptr;
 
 		meshBuffer.AddMesh(meshName, p, m);
 
@@ -227,8 +259,6 @@ namespace Terrain
 				vertices.push_back(v);
 			}
 		}
-		const size_t vOffset =
-			meshBuffer.AddVertexData(vertices.data(), vertices.size() * sizeof(Mesh::Vertex));
 
 		//CfbNXf[^쐬
 		std::vector<GLuint> indices;
@@ -250,15 +280,23 @@ namespace Terrain
 				indices.push_back(a);
 			}
 		}
-		const size_t iOffset =
+
+		//_LbV悤ɕבւĂ]
+		OptimizeGrid(vertices, indices, meshName);
+		const GLintptr vOffset =
+			meshBuffer.AddVertexData(vertices.data(), vertices.size() * sizeof(Mesh::Vertex));
+		const GLintptr iOffset =
 			meshBuffer.AddIndexData(indices.data(), indices.size() * sizeof(GLuint));
+		if (vOffset < 0 || iOffset < 0)
+		{
+			return false;
+		}
 
 		//_f[^ƃCfbNXf[^烁bV쐬
 		Mesh::Primitive p =
 			meshBuffer.CreatePrimitive(indices.size(), GL_UNSIGNED_INT, iOffset, vOffset);
+		Mesh::CalcBounds(vertices.data(), vertices.size(), &p);
 		Mesh::Material m = meshBuffer.CreateMaterial(glm::vec4(1), nullptr);
-		m.texture[4] = lightIndex[0];
-		m.texture[5] = lightIndex[1];
 		std::vector<std::string> cubeMapFiles;
 		cubeMapFiles.reserve(6);
 		cubeMapFiles.push_back("Res/cubemap_px.tga");
@@ -270,62 +308,98 @@ namespace Terrain
 		m.texture[6] = Texture::Cube::Create(cubeMapFiles);
 		m.texture[8] = Texture::Image2D::Create("Res/Terrain_Water_Normal.tga");
 		m.program = meshBuffer.GetWaterShader();
-		m.progShadow = meshBuffer.GetNonTexturedShadowShader();
+		m.progShadow = meshBuffer.GetShadowShaders()->Get({ { "NON_TEXTURED", 1 } });
+		m.progInstanced = nullptr;
+		m.progShadowInstanced = nullptr;
 		meshBuffer.AddMesh(meshName, p, m);
 
 		return true;
 	}
 
-
 	/**
-	* CgCfbNXXV
+	* Օp̑en`bV쐬
+	*
+	* @param cellSize       bV1}XɊ܂߂鍂f[^̐(c)
+	* @param chunkCellCount 1̎ՕɊ܂߂}X̐(c)
 	*
-	* @param lights CgAN^[̃Xg
+	* @return n`𕪊Օ̔z
+	*
+	* _̍ɂ͎͂̃}X̍łႢĝŁAebV͏
+	* ۂ̒n`ႭȂ. ̂߁Aۂɂ͌镨̂BƂ͂Ȃ
 	*/
-	void HeightMap::UpdateLightIndex(const ActorList& lights)
+	std::vector<OcclusionCuller::OccluderMesh> HeightMap::CreateOccluders(
+		int cellSize, int chunkCellCount) const
 	{
-		std::vector<glm::i8vec4> pointLightIndex;
-		std::vector<glm::i8vec4> spotLightIndex;
-		pointLightIndex.resize(size.x * size.y, glm::i8vec4(-1));
-		spotLightIndex.resize(size.x * size.y, glm::i8vec4(-1));
-		for (int y = 0; y < size.y; y++)
+		std::vector<OcclusionCuller::OccluderMesh> occluders;
+		if (heights.empty() || cellSize < 1 || chunkCellCount < 1)
 		{
-			for (int x = 0; x < size.x; x++)
+			return occluders;
+		}
+
+		//eiq̒_ƂɁA͂̃}X̍łႢ߂
+		const glm::ivec2 gridSize = (size - 1 + cellSize - 1) / cellSize + 1;
+		std::vector<float> gridHeights(gridSize.x * gridSize.y);
+		for (int gz = 0; gz < gridSize.y; ++gz)
+		{
+			for (int gx = 0; gx < gridSize.x; ++gx)
+			{
+				const int x0 = std::max(0, (gx - 1) * cellSize);
+				const int x1 = std::min(size.x - 1, (gx + 1) * cellSize);
+				const int z0 = std::max(0, (gz - 1) * cellSize);
+				const int z1 = std::min(size.y - 1, (gz + 1) * cellSize);
+				float h = std::numeric_limits<float>::max();
+				for (int z = z0; z <= z1; ++z)
+				{
+					for (int x = x0; x <= x1; ++x)
+					{
+						h = std::min(h, heights[z * size.x + x]);
+					}
+				}
+				gridHeights[gz * gridSize.x + gx] = h;
+			}
+		}
+
+		//chunkCellCount x chunkCellCount}XƂɎՕ
+		for (int cz = 0; cz < gridSize.y - 1; cz += chunkCellCount)
+		{
+			for (int cx = 0; cx < gridSize.x - 1; cx += chunkCellCount)
 			{
-				std::vector<ActorPtr> neiborhood =
-					lights.FindNearbyActors(glm::vec3(x + 0.5f, 0, y + 0.5f), 20);
-				int pointLightCount = 0;
-				glm::i8vec4& pointLight = pointLightIndex[y * size.x + x];
-				int spotLightCount = 0;
-				glm::i8vec4& spotLight = spotLightIndex[y * size.x + x];
-				for (auto light : neiborhood)
+				const int countX = std::min(chunkCellCount, gridSize.x - 1 - cx);
+				const int countZ = std::min(chunkCellCount, gridSize.y - 1 - cz);
+				OcclusionCuller::OccluderMesh mesh;
+				mesh.aabb.min = glm::vec3(std::numeric_limits<float>::max());
+				mesh.aabb.max = glm::vec3(std::numeric_limits<float>::lowest());
+				for (int z = 0; z <= countZ; ++z)
 				{
-					if (PointLightActorPtr p =
-						std::dynamic_pointer_cast<PointLightActor>(light))
+					for (int x = 0; x <= countX; ++x)
 					{
-						if (pointLightCount < 4)
-						{
-							pointLight[pointLightCount] = p->index;
-							pointLightCount++;
-						}
+						const int gx = cx + x;
+						const int gz = cz + z;
+						const glm::vec3 pos(std::min(gx * cellSize, size.x - 1),
+							gridHeights[gz * gridSize.x + gx], std::min(gz * cellSize, size.y - 1));
+						mesh.vertices.push_back(pos);
+						mesh.aabb.min = glm::min(mesh.aabb.min, pos);
+						mesh.aabb.max = glm::max(mesh.aabb.max, pos);
 					}
-					else if (SpotLightActorPtr p = std::dynamic_pointer_cast<SpotLightActor>(light))
+				}
+				const uint32_t stride = countX + 1;
+				for (int z = 0; z < countZ; ++z)
+				{
+					for (int x = 0; x < countX; ++x)
 					{
-						if (spotLightCount < 4)
-						{
-							spotLight[spotLightCount] = p->index;
-							spotLightCount++;
-						}
+						const uint32_t a = (z + 1) * stride + x;
+						const uint32_t b = (z + 1) * stride + (x + 1);
+						const uint32_t c = z * stride + (x + 1);
+						const uint32_t d = z * stride + x;
+						mesh.indices.insert(mesh.indices.end(), { a, b, c, c, d, a });
 					}
 				}
+				occluders.push_back(mesh);
 			}
 		}
-		lightIndex[0]->BufferSubData(0, pointLightIndex.size() * 4, pointLightIndex.data());
-		lightIndex[1]->BufferSubData(0, spotLightIndex.size() * 4, spotLightIndex.data());
+		return occluders;
 	}
 
-
-
 	/**
 	* 񂩂@vZ
 	*
@@ -5,7 +5,7 @@
 #define TERRAIN_H_INCLUDED
 #include "Mesh.h"
 #include "Texture.h"
-#include "Light.h"
+#include "OcclusionCuller.h"
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
@@ -32,13 +32,13 @@ namespace Terrain
 			const char* meshName, const char* texName = nullptr) const;
 		bool CreateWaterMesh(Mesh::Buffer& meshBuffer,
 			const char* meshName, float waterLevel) const;
-		void UpdateLightIndex(const ActorList& lights);
+		std::vector<OcclusionCuller::OccluderMesh> CreateOccluders(
+			int cellSize, int chunkCellCount) const;
 
 	private:
 		std::string name;//ɂȂ摜t@C
 		glm::ivec2 size = glm::ivec2(0);//oCg}bv̑傫
 		std::vector<float> heights;//f[^
-		Texture::BufferPtr lightIndex[2];
 
 		glm::vec3 CalcNormal(int x, int z) const;
 	};
@@ -3,11 +3,13 @@
 */
 #define NOMINMAX//NO MIN MAX
 #include "Texture.h"
+#include "GLState.h"
 #include <stdint.h>
 #include <vector>
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <unordered_map>
 
 //eNX`֘Å֐NXi[閼O
 namespace Texture
@@ -230,7 +232,7 @@ namespace Texture
 		buf.resize(header.width * header.height * 4);
 		GLuint texId;
 		glGenTextures(1, &texId);
-		glBindTexture(isCubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D, texId);
+		GLState::BindTexture(0, isCubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D, texId);
 		for (int faceIndex = 0; faceIndex < faceCount; faceIndex++)
 		{
 			GLsizei curWidth = header.width;
@@ -272,7 +274,7 @@ namespace Texture
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-		glBindTexture(GL_TEXTURE_2D, 0);
+		GLState::BindTexture(0, GL_TEXTURE_2D, 0);
 		return texId;
 
 	}
@@ -365,7 +367,7 @@ namespace Texture
 	{
 		GLuint id;
 		glGenTextures(1, &id);
-		glBindTexture(GL_TEXTURE_2D, id);
+		GLState::BindTexture(0, GL_TEXTURE_2D, id);
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat,
 			width, height, 0, format, type, data);
@@ -374,8 +376,8 @@ namespace Texture
 		if (result != GL_NO_ERROR)
 		{
 			std::cerr << "ERROR: eNX`̍쐬Ɏs(0x" << std::hex << result << ").";
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glDeleteTextures(1, &id);
+			GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+			GLState::DeleteTexture(id);
 			return 0;
 		}
 		//eNX`̃p[^ݒ肷
@@ -391,7 +393,7 @@ namespace Texture
 			const GLint swizzle[] = { GL_RED, GL_RED, GL_RED,GL_ONE };
 			glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
 		}
-		glBindTexture(GL_TEXTURE_2D, 0);
+		GLState::BindTexture(0, GL_TEXTURE_2D, 0);
 
 		return id;
 	}
@@ -518,10 +520,10 @@ namespace Texture
 			std::cerr << "[x]" << __func__ << ":eNX`ݒ肳Ă܂\n";
 		}
 		const GLenum target = Target();
-		glBindTexture(target, Get());
+		GLState::BindTexture(0, target, Get());
 		glTexParameteri(target, GL_TEXTURE_WRAP_S, mode);
 		glTexParameteri(target, GL_TEXTURE_WRAP_T, mode);
-		glBindTexture(target, 0);
+		GLState::BindTexture(0, target, 0);
 		const GLenum error = glGetError();
 		if (error)
 		{
@@ -545,7 +547,7 @@ namespace Texture
 	*/
 	Image2D::~Image2D()
 	{
-		glDeleteTextures(1, &id);
+		GLState::DeleteTexture(id);
 	}
 /**
 *eNX` IuWFNgݒ肷
@@ -554,15 +556,62 @@ namespace Texture
 	*/
 	void Image2D::Reset(GLuint texId)
 	{
-		glDeleteTextures(1, &id);
+		GLState::DeleteTexture(id);
 		id = texId;
 		if (id)
 		{
 			//eNX`̕ƍ擾
-			glBindTexture(GL_TEXTURE_2D, id);
+			GLState::BindTexture(0, GL_TEXTURE_2D, id);
 			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
 			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
-			glBindTexture(GL_TEXTURE_2D, 0);
+
+			//풓ǗpɁAS~bvx̃oCgvZ
+			byteSize = 0;
+			for (GLint level = 0; level < 16; ++level)
+			{
+				GLint w = 0;
+				GLint h = 0;
+				glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &w);
+				glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &h);
+				if (w <= 0 || h <= 0)
+				{
+					break;
+				}
+				GLint isCompressed = GL_FALSE;
+				glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &isCompressed);
+				if (isCompressed)
+				{
+					GLint compressedSize = 0;
+					glGetTexLevelParameteriv(GL_TEXTURE_2D, level,
+						GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+					byteSize += compressedSize;
+				}
+				else
+				{
+					//`Ƃ̐̃rbgvāA1eNZ̃rbg߂
+					//(RGBA8Ȃ32rbgARGBA16FȂ64rbgAR32FȂ32rbgɂȂ)
+					static const GLenum componentSizes[] = {
+						GL_TEXTURE_RED_SIZE, GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE,
+						GL_TEXTURE_ALPHA_SIZE, GL_TEXTURE_DEPTH_SIZE, GL_TEXTURE_STENCIL_SIZE,
+						GL_TEXTURE_SHARED_SIZE,
+					};
+					size_t bitsPerTexel = 0;
+					for (GLenum e : componentSizes)
+					{
+						GLint bits = 0;
+						glGetTexLevelParameteriv(GL_TEXTURE_2D, level, e, &bits);
+						bitsPerTexel += bits;
+					}
+					byteSize += (static_cast<size_t>(w) * h * bitsPerTexel + 7) / 8;
+				}
+			}
+			GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+		}
+		else
+		{
+			width = 0;
+			height = 0;
+			byteSize = 0;
 		}
 	}
 /**
@@ -585,16 +634,54 @@ namespace Texture
 		return id;
 	}
 
+/**
+* 2DeNX`̃LbV擾
+*
+* @return t@CL[Ƃ2DeNX`̘Azz
+*
+* GLReLXgɉ悤ɁAŏɎgꂽƂɍ쐬
+*/
+	std::unordered_map<std::string, Image2DPtr>& GetImage2DCache()
+	{
+		static std::unordered_map<std::string, Image2DPtr> cache;
+		return cache;
+	}
+
 /**
 * 2DeNX`쐬
 *
 * @param path eNX`t@C
 *
 * @return 쐬eNX`IuWFNg
+*
+* t@C̃eNX`풓Ă΁AԂ
+* 풓ĂȂ΃t@Cǂݍ݁A풓Ǘɓo^
 */
 	Image2DPtr Image2D::Create(const char* path)
 	{
-		return std::make_shared<Image2D>(LoadImage2D(path));
+		std::unordered_map<std::string, Image2DPtr>& cache = GetImage2DCache();
+		const auto itr = cache.find(path);
+		if (itr != cache.end())
+		{
+			return itr->second;
+		}
+
+		Image2DPtr p = std::make_shared<Image2D>(LoadImage2D(path));
+		if (p->IsNull())
+		{
+			return p;
+		}
+		const std::string name = path;
+		cache.insert(std::make_pair(name, p));
+		Residency::Manager::Instance().Register(Residency::Type::texture, name,
+			sizeof(Image2D), p->ByteSize(), &p->GetUsage(),
+			[name]() {
+				const auto& cache = GetImage2DCache();
+				const auto itr = cache.find(name);
+				return itr != cache.end() && itr->second.use_count() > 1;
+			},
+			[name]() { GetImage2DCache().erase(name); });
+		return p;
 	}
 
 /**
@@ -616,9 +703,9 @@ namespace Texture
 			return false;
 		}
 		glGenTextures(1, &buffer->id);
-		glBindTexture(GL_TEXTURE_BUFFER, buffer->id);
+		GLState::BindTexture(0, GL_TEXTURE_BUFFER, buffer->id);
 		glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, buffer->bo.Id());
-		glBindTexture(GL_TEXTURE_BUFFER, 0);
+		GLState::BindTexture(0, GL_TEXTURE_BUFFER, 0);
 
 		return buffer;
 	}
@@ -628,7 +715,7 @@ namespace Texture
 */
 	Buffer::~Buffer()
 	{
-		glDeleteTextures(1, &id);
+		GLState::DeleteTexture(id);
 	}
 
 /**
@@ -678,7 +765,7 @@ namespace Texture
 
 		GLuint id;
 		glGenTextures(1, &id);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+		GLState::BindTexture(0, GL_TEXTURE_CUBE_MAP, id);
 		for (int i = 0; i < 6; i++)
 		{
 			const ImageData& image = imageDataList[i];
@@ -691,7 +778,7 @@ namespace Texture
 				{
 					std::cerr << "[G[]" << pathList[i] << "̓ǂݍ݂Ɏs("
 						<< std::hex << result << ").\n";
-					glDeleteTextures(1, &id);
+					GLState::DeleteTexture(id);
 					return nullptr;
 				}
 			}
@@ -702,7 +789,7 @@ namespace Texture
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+		GLState::BindTexture(0, GL_TEXTURE_CUBE_MAP, 0);
 
 		CubePtr p = std::make_shared<Cube>();
 		p->id = id;
@@ -716,7 +803,7 @@ namespace Texture
 */
 	Cube::~Cube()
 	{
-		glDeleteTextures(1, &id);
+		GLState::DeleteTexture(id);
 	}
 
 }//namespace Texture
\ No newline at end of file
@@ -5,6 +5,7 @@
 #define TEXTURE_H_INCLUDED
 #include <GL/glew.h>
 #include "BufferObject.h"
+#include "Residency.h"
 #include <glm/glm.hpp>
 #include <vector>
 #include <memory>
@@ -58,6 +59,13 @@ namespace Texture
 		virtual GLenum Target() const = 0;
 
 		void SetWrapMode(GLenum mode);
+
+		//풓ǗpɁA`ŎgpƂL^
+		void Touch() const { usage.Touch(); }
+		const Residency::Usage& GetUsage() const { return usage; }
+
+	private:
+		Residency::Usage usage;
 	};
 
 /**
@@ -77,11 +85,13 @@ namespace Texture
 		virtual GLint Width() const override { return width; }
 		virtual GLint Height() const  override { return height; }
 		virtual GLenum Target() const override { return GL_TEXTURE_2D; }
+		size_t ByteSize() const { return byteSize; }
 
 	private:
 		GLuint id = 0;
 		GLint width = 0;
 		GLint height = 0;
+		size_t byteSize = 0;//S~bvxGPUgp
 	};
 
 
@@ -2,6 +2,8 @@
 * @file UniformBuffer.cpp
 */
 #include "UniformBuffer.h"
+#include "GLState.h"
+#include "RenderStats.h"
 #include <iostream>
 
 /**
@@ -29,7 +31,7 @@ UniformBufferPtr UniformBuffer::Create(GLsizeiptr size, GLuint bindingPoint, con
   glGenBuffers(1, &p->ubo);
   glBindBuffer(GL_UNIFORM_BUFFER, p->ubo);
   glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
-  glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, p->ubo);
+  GLState::BindUniformBuffer(bindingPoint, p->ubo, 0, size);
   const GLenum result = glGetError();
   if (result != GL_NO_ERROR) {
     std::cerr << "ERROR: UBO '" << name << "'̍쐬Ɏs" << std::endl;
@@ -49,7 +51,7 @@ UniformBufferPtr UniformBuffer::Create(GLsizeiptr size, GLuint bindingPoint, con
 UniformBuffer::~UniformBuffer()
 {
   if (ubo) {
-    glDeleteBuffers(1, &ubo);
+    GLState::DeleteBuffer(ubo);
   }
 }
 
@@ -78,6 +80,7 @@ bool UniformBuffer::BufferSubData(const GLvoid* data, GLintptr offset, GLsizeipt
   glBindBuffer(GL_UNIFORM_BUFFER, ubo);
   glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
   glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  RenderStats::AddUpload(size);
   return true;
 }
 
@@ -89,5 +92,5 @@ bool UniformBuffer::BufferSubData(const GLvoid* data, GLintptr offset, GLsizeipt
 */
 void UniformBuffer::BindBufferRange(GLintptr offset, GLsizeiptr size) const
 {
-  glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, ubo, offset, size);
+  GLState::BindUniformBuffer(bindingPoint, ubo, offset, size);
 }
\ No newline at end of file